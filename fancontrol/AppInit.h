@@ -39,8 +39,10 @@ inline void InitLogging(const char* logFileName = "TPFanCtrl2_debug.log") {
     spdlog::set_default_logger(logger);
     spdlog::set_level(spdlog::level::info);
 
-    // Auto-flush on info and above; debug can be enabled via SPDLOG_LEVEL
-    logger->flush_on(spdlog::level::info);
+    // Warnings and errors reach the file at once, the rest within a second;
+    // debug can be enabled via SPDLOG_LEVEL
+    logger->flush_on(spdlog::level::warn);
+    spdlog::flush_every(std::chrono::seconds(1));
     spdlog::cfg::load_env_levels();
     
     spdlog::set_pattern("[%H:%M:%S] [%^%l%$] %v");
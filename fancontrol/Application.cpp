@@ -5,76 +5,6 @@
 
 namespace App {
 
-/// Build ThermalConfig from the legacy ConfigManager
-/// This is a bridge function for the migration period
-Core::ThermalConfig BuildThermalConfig(const std::shared_ptr<ConfigManager>& config) {
-    Core::ThermalConfig thermal;
-    
-    // Basic settings
-    thermal.cycleSeconds = config->Cycle;
-    thermal.iconCycleSeconds = config->IconCycle;
-    thermal.isDualFan = config->DualFan != 0;
-    thermal.fanSpeedAddr = config->FanSpeedLowByte;
-    thermal.useBiasedTemps = config->ShowBiasedTemps != 0;
-    thermal.noExtSensor = config->NoExtSensor != 0;
-    thermal.useFahrenheit = config->Fahrenheit != 0;
-    thermal.manualFanSpeed = config->ManFanSpeed;
-    thermal.manModeExitTemp = config->ManModeExit;
-    thermal.ignoreList = config->IgnoreSensors;
-    
-    // PID settings
-    thermal.pid.Kp = config->PID_Kp;
-    thermal.pid.Ki = config->PID_Ki;
-    thermal.pid.Kd = config->PID_Kd;
-    thermal.pid.targetTemp = config->PID_Target;
-    thermal.pid.minFan = 0;
-    thermal.pid.maxFan = 7;
-    
-    // Sensor configuration - use defaults and apply names/weights from config
-    thermal.sensors = Core::CreateDefaultSensorConfig();
-    
-    const char* defaultNames[] = {
-        "CPU", "APS", "PCM", "GPU", "BAT1", "X7D", 
-        "BAT2", "X7F", "BUS", "PCI", "PWR", "XC3"
-    };
-
-    for (size_t i = 0; i < thermal.sensors.size(); i++) {
-        // Use name from config if provided, otherwise use default ThinkPad name
-        if (i < config->SensorNames.size() && !config->SensorNames[i].empty()) {
-            thermal.sensors[i].name = config->SensorNames[i];
-        } else if (i < 12) {
-            thermal.sensors[i].name = defaultNames[i];
-        }
-    }
-
-    for (size_t i = 0; i < config->SensorWeights.size() && i < thermal.sensors.size(); i++) {
-        thermal.sensors[i].weight = config->SensorWeights[i];
-    }
-    
-    // Smart profiles - convert SmartLevels1/2 to SmartLevelDefinition
-    for (const auto& sl : config->SmartLevels1) {
-        if (sl.temp >= 0) {
-            thermal.smartProfiles[0].emplace_back(sl.temp, sl.fan, sl.hystUp, sl.hystDown);
-        }
-    }
-    for (const auto& sl : config->SmartLevels2) {
-        if (sl.temp >= 0) {
-            thermal.smartProfiles[1].emplace_back(sl.temp, sl.fan, sl.hystUp, sl.hystDown);
-        }
-    }
-    
-    // Icon levels
-    if (config->IconLevels.size() >= 3) {
-        thermal.iconLevels.thresholds = { 
-            config->IconLevels[0], 
-            config->IconLevels[1], 
-            config->IconLevels[2] 
-        };
-    }
-    
-    return thermal;
-}
-
 Application::Application() {
     m_config = std::make_shared<ConfigManager>();
 }
@@ -124,7 +54,29 @@ bool Application::Initialize(HWND hwnd) {
     // Initialize Core components
     Core::ThermalConfig thermalConfig = BuildThermalConfig(m_config);
     m_thermalManager = std::make_shared<Core::ThermalManager>(ecManager, thermalConfig);
-    m_uiAdapter = std::make_unique<Core::UIAdapter>(m_thermalManager);
+    m_uiAdapter = std::make_unique<Core::UIAdapter>(m_thermalManager, "TPFanCtrl2.history");
+    
+    // Identify per-sensor thermal models from the live event stream
+    m_thermalModels = std::make_shared<Core::ThermalModelEstimator>();
+    // Queued delivery: a periodic refit runs inside the event handler
+    m_thermalManager->Subscribe(std::weak_ptr<Core::IThermalObserver>(m_thermalModels), {
+        .events = Core::EventMask<Core::TemperatureUpdateEvent, Core::FanStateChangeEvent>,
+        .async = true,
+        .queueCapacity = 64
+    });
+    m_thermalManager->SetThermalModels(m_thermalModels);
+
+    // Telemetry file, written from its own thread. Binary blocks get a file of
+    // their own so they never end up appended to an existing CSV log.
+    if (m_config->Log2csv == 1) {
+        const char* path = m_config->TelemetryBinary ? "TPFanCtrl2_telemetry.bin" : "TPFanCtrl2_csv.txt";
+        m_telemetry = std::make_shared<Core::TelemetryRecorder>(BuildTelemetryConfig(m_config, path));
+        m_thermalManager->Subscribe(std::weak_ptr<Core::IThermalObserver>(m_telemetry), {
+            .events = Core::EventMask<Core::TemperatureUpdateEvent, Core::FanStateChangeEvent>,
+            .async = true,
+            .queueCapacity = 64
+        });
+    }
 
     return true;
 }
@@ -135,6 +87,8 @@ void Application::Shutdown() {
     }
     m_uiAdapter.reset();
     m_thermalManager.reset();
+    m_thermalModels.reset();
+    m_telemetry.reset();
     
     CleanupVulkan();
     CloseTVicPort();
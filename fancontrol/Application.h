@@ -5,15 +5,14 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "ConfigManager.h"
+#include "ThermalConfigBuilder.h"
 #include "Core/ThermalManager.h"
 #include "Core/UIAdapter.h"
+#include "Core/ThermalModel.h"
 #include "imgui_impl_vulkan.h"
 
 namespace App {
 
-// Helper to convert ConfigManager to ThermalConfig
-Core::ThermalConfig BuildThermalConfig(const std::shared_ptr<ConfigManager>& config);
-
 /// Application context to encapsulate global state and lifecycle management
 class Application {
 public:
@@ -32,6 +31,7 @@ public:
     std::shared_ptr<ConfigManager> GetConfig() const { return m_config; }
     std::shared_ptr<Core::ThermalManager> GetThermalManager() const { return m_thermalManager; }
     Core::UIAdapter* GetUIAdapter() const { return m_uiAdapter.get(); }
+    std::shared_ptr<Core::ThermalModelEstimator> GetThermalModels() const { return m_thermalModels; }
     
     // Vulkan state (kept public for ImGui backend access for now)
     VkInstance Instance = VK_NULL_HANDLE;
@@ -51,6 +51,8 @@ private:
     std::shared_ptr<ConfigManager> m_config;
     std::shared_ptr<Core::ThermalManager> m_thermalManager;
     std::unique_ptr<Core::UIAdapter> m_uiAdapter;
+    std::shared_ptr<Core::ThermalModelEstimator> m_thermalModels;
+    std::shared_ptr<Core::TelemetryRecorder> m_telemetry;
     
     HWND m_hwnd = NULL;
 };
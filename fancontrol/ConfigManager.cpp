@@ -31,6 +31,24 @@ void ConfigManager::to_json(json& j) const {
         {"ManFanSpeed", ManFanSpeed},
         {"ProcessPriority", ProcessPriority},
         {"Cycle", Cycle},
+        {"CycleMs", CycleMs},
+        {"AdaptiveCycle", {
+            {"Enabled", AdaptiveCycle},
+            {"MinMs", AdaptiveMinMs},
+            {"MaxMs", AdaptiveMaxMs},
+            {"RiseRate", AdaptiveRiseRate}
+        }},
+        {"Watchdog", {
+            {"Enabled", Watchdog},
+            {"StallMs", WatchdogStallMs}
+        }},
+        {"Telemetry", {
+            {"Enabled", Log2csv},
+            {"Binary", TelemetryBinary},
+            {"MaxFileMB", TelemetryMaxFileMB},
+            {"RotateHours", TelemetryRotateHours},
+            {"Segments", TelemetrySegments}
+        }},
         {"StartMinimized", StartMinimized},
         {"MinimizeToSysTray", MinimizeToSysTray},
         {"MinimizeOnClose", MinimizeOnClose},
@@ -40,7 +58,35 @@ void ConfigManager::to_json(json& j) const {
             {"Kp", PID_Kp},
             {"Ki", PID_Ki},
             {"Kd", PID_Kd},
-            {"Algorithm", ControlAlgorithm}
+            {"Algorithm", ControlAlgorithm},
+            {"Dither", PID_Dither},
+            {"DitherDwell", PID_DitherDwell},
+            {"DitherMaxWrites", PID_DitherMaxWrites}
+        }},
+        {"MPC", {
+            {"Target", MPC_Target},
+            {"Horizon", MPC_Horizon},
+            {"WriteCost", MPC_WriteCost},
+            {"OverTempCost", MPC_OverTempCost}
+        }},
+        {"RpmTarget", {
+            {"Target", TargetRpm},
+            {"LoopMs", RpmLoopMs},
+            {"Tolerance", RpmTolerance},
+            {"Dither", RpmDither}
+        }},
+        {"Ramp", {
+            {"Enabled", Ramp},
+            {"UpRate", RampUpRate},
+            {"DownRate", RampDownRate},
+            {"MinDwell", RampMinDwell},
+            {"ReversalWindow", RampReversalWindow},
+            {"CriticalTemp", RampCriticalTemp}
+        }},
+        {"FanZones", {
+            {"Enabled", FanZones},
+            {"Fan1", {{"Sensors", Fan1Sensors}, {"Profile", Fan1Profile}, {"PID", Fan1UsePID}}},
+            {"Fan2", {{"Sensors", Fan2Sensors}, {"Profile", Fan2Profile}, {"PID", Fan2UsePID}}}
         }},
         {"SmartLevels1", SmartLevels1},
         {"SmartLevels2", SmartLevels2},
@@ -54,6 +100,27 @@ void ConfigManager::from_json(const json& j) {
     if (j.contains("ActiveMode")) ActiveMode = j.at("ActiveMode").get<int>();
     if (j.contains("ManFanSpeed")) ManFanSpeed = j.at("ManFanSpeed").get<int>();
     if (j.contains("Cycle")) Cycle = j.at("Cycle").get<int>();
+    if (j.contains("CycleMs")) CycleMs = j.at("CycleMs").get<int>();
+    if (j.contains("AdaptiveCycle")) {
+        const auto& a = j.at("AdaptiveCycle");
+        if (a.contains("Enabled")) AdaptiveCycle = a.at("Enabled").get<int>();
+        if (a.contains("MinMs")) AdaptiveMinMs = a.at("MinMs").get<int>();
+        if (a.contains("MaxMs")) AdaptiveMaxMs = a.at("MaxMs").get<int>();
+        if (a.contains("RiseRate")) AdaptiveRiseRate = a.at("RiseRate").get<float>();
+    }
+    if (j.contains("Watchdog")) {
+        const auto& w = j.at("Watchdog");
+        if (w.contains("Enabled")) Watchdog = w.at("Enabled").get<int>();
+        if (w.contains("StallMs")) WatchdogStallMs = w.at("StallMs").get<int>();
+    }
+    if (j.contains("Telemetry")) {
+        const auto& t = j.at("Telemetry");
+        if (t.contains("Enabled")) Log2csv = t.at("Enabled").get<int>();
+        if (t.contains("Binary")) TelemetryBinary = t.at("Binary").get<int>();
+        if (t.contains("MaxFileMB")) TelemetryMaxFileMB = t.at("MaxFileMB").get<int>();
+        if (t.contains("RotateHours")) TelemetryRotateHours = t.at("RotateHours").get<int>();
+        if (t.contains("Segments")) TelemetrySegments = t.at("Segments").get<int>();
+    }
     if (j.contains("StartMinimized")) StartMinimized = j.at("StartMinimized").get<int>();
     if (j.contains("MinimizeToSysTray")) MinimizeToSysTray = j.at("MinimizeToSysTray").get<int>();
     if (j.contains("MinimizeOnClose")) MinimizeOnClose = j.at("MinimizeOnClose").get<int>();
@@ -66,6 +133,47 @@ void ConfigManager::from_json(const json& j) {
         if (p.contains("Ki")) PID_Ki = p.at("Ki").get<float>();
         if (p.contains("Kd")) PID_Kd = p.at("Kd").get<float>();
         if (p.contains("Algorithm")) ControlAlgorithm = p.at("Algorithm").get<int>();
+        if (p.contains("Dither")) PID_Dither = p.at("Dither").get<int>();
+        if (p.contains("DitherDwell")) PID_DitherDwell = p.at("DitherDwell").get<float>();
+        if (p.contains("DitherMaxWrites")) PID_DitherMaxWrites = p.at("DitherMaxWrites").get<int>();
+    }
+
+    if (j.contains("MPC")) {
+        const auto& m = j.at("MPC");
+        if (m.contains("Target")) MPC_Target = m.at("Target").get<float>();
+        if (m.contains("Horizon")) MPC_Horizon = m.at("Horizon").get<float>();
+        if (m.contains("WriteCost")) MPC_WriteCost = m.at("WriteCost").get<float>();
+        if (m.contains("OverTempCost")) MPC_OverTempCost = m.at("OverTempCost").get<float>();
+    }
+
+    if (j.contains("RpmTarget")) {
+        const auto& r = j.at("RpmTarget");
+        if (r.contains("Target")) TargetRpm = r.at("Target").get<int>();
+        if (r.contains("LoopMs")) RpmLoopMs = r.at("LoopMs").get<int>();
+        if (r.contains("Tolerance")) RpmTolerance = r.at("Tolerance").get<int>();
+        if (r.contains("Dither")) RpmDither = r.at("Dither").get<int>();
+    }
+
+    if (j.contains("Ramp")) {
+        const auto& r = j.at("Ramp");
+        if (r.contains("Enabled")) Ramp = r.at("Enabled").get<int>();
+        if (r.contains("UpRate")) RampUpRate = r.at("UpRate").get<float>();
+        if (r.contains("DownRate")) RampDownRate = r.at("DownRate").get<float>();
+        if (r.contains("MinDwell")) RampMinDwell = r.at("MinDwell").get<float>();
+        if (r.contains("ReversalWindow")) RampReversalWindow = r.at("ReversalWindow").get<float>();
+        if (r.contains("CriticalTemp")) RampCriticalTemp = r.at("CriticalTemp").get<int>();
+    }
+
+    if (j.contains("FanZones")) {
+        const auto& z = j.at("FanZones");
+        if (z.contains("Enabled")) FanZones = z.at("Enabled").get<int>();
+        auto readZone = [](const json& f, std::vector<int>& sensors, int& profile, int& usePID) {
+            if (f.contains("Sensors")) sensors = f.at("Sensors").get<std::vector<int>>();
+            if (f.contains("Profile")) profile = f.at("Profile").get<int>();
+            if (f.contains("PID")) usePID = f.at("PID").get<int>();
+        };
+        if (z.contains("Fan1")) readZone(z.at("Fan1"), Fan1Sensors, Fan1Profile, Fan1UsePID);
+        if (z.contains("Fan2")) readZone(z.at("Fan2"), Fan2Sensors, Fan2Profile, Fan2UsePID);
     }
 
     if (j.contains("SmartLevels1")) SmartLevels1 = j.at("SmartLevels1").get<std::vector<SmartLevel>>();
@@ -21,6 +21,13 @@ public:
     int ManFanSpeed = 7;
     int ProcessPriority = 2;
     int Cycle = 5;
+    int CycleMs = 0;                // Millisecond period, overrides Cycle when > 0
+    int AdaptiveCycle = 0;          // Run fast while temperatures rise, back off when stable
+    int AdaptiveMinMs = 500;
+    int AdaptiveMaxMs = 5000;
+    float AdaptiveRiseRate = 0.5f;  // °C/s that counts as rising
+    int Watchdog = 1;               // Hand the fan to the BIOS when the control loop stalls
+    int WatchdogStallMs = 5000;
     int IconCycle = 1;
     int ReIcCycle = 0;
     int IconFontSize = 8;
@@ -44,7 +51,11 @@ public:
     int SecStartDelay = 0;
     int Log2File = 0;
     int StayOnTop = 0;
-    int Log2csv = 0;
+    int Log2csv = 0;                // Record telemetry (TPFanCtrl2_csv.txt)
+    int TelemetryBinary = 0;        // 0: CSV, 1: binary columnar blocks (TPFanCtrl2_telemetry.bin)
+    int TelemetryMaxFileMB = 10;    // Rotate at this size (0 = never)
+    int TelemetryRotateHours = 0;   // Rotate after this long (0 = never)
+    int TelemetrySegments = 5;      // Rotated files kept
     int ShowAll = 0;
     int ShowTempIcon = 1;
     int Fahrenheit = 0;
@@ -59,7 +70,39 @@ public:
     float PID_Kp = 0.5f;
     float PID_Ki = 0.01f;
     float PID_Kd = 0.1f;
-    int ControlAlgorithm = 0; // 0: Step, 1: PID
+    int ControlAlgorithm = 0; // 0: Step, 1: PID, 2: MPC
+    int PID_Dither = 0;       // Alternate adjacent levels to realize fractional output
+    float PID_DitherDwell = 5.0f;
+    int PID_DitherMaxWrites = 6;
+
+    // Model-predictive control (uses the identified thermal model)
+    float MPC_Target = 65.0f;
+    float MPC_Horizon = 60.0f;      // Seconds
+    float MPC_WriteCost = 10.0f;    // Cost of one level change vs. one level-second
+    float MPC_OverTempCost = 50.0f; // Cost per (°C over target)² per second
+
+    // RPM target mode (tach loop)
+    int TargetRpm = 3000;
+    int RpmLoopMs = 500;            // Tach sampling period between thermal cycles
+    int RpmTolerance = 150;
+    int RpmDither = 1;              // Alternate levels for targets between two levels
+
+    // Fan ramp scheduler (slew-rate limiting)
+    int Ramp = 0;
+    float RampUpRate = 0.5f;        // Levels per second
+    float RampDownRate = 0.2f;
+    float RampMinDwell = 5.0f;      // Seconds between level changes
+    float RampReversalWindow = 15.0f;
+    int RampCriticalTemp = 85;      // Bypass the ramp at or above this temperature
+
+    // Per-fan control zones (dual-fan machines)
+    int FanZones = 0;
+    std::vector<int> Fan1Sensors;   // Empty: all non-ignored sensors
+    std::vector<int> Fan2Sensors;
+    int Fan1Profile = 0;            // Smart profile index per fan
+    int Fan2Profile = 0;
+    int Fan1UsePID = 0;             // Use PID instead of the smart profile
+    int Fan2UsePID = 0;
 
     std::vector<SmartLevel> SmartLevels1;
     std::vector<SmartLevel> SmartLevels2;
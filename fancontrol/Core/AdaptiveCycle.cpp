@@ -0,0 +1,98 @@
+// Core/AdaptiveCycle.cpp - Implementation of the adaptive control loop period
+#include "AdaptiveCycle.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+
+namespace {
+
+constexpr float kRateSmoothing = 0.4f;  // Weight of the newest slope sample
+constexpr float kWarmingRate = 0.01f;   // Slope (°C/s) below which the temperature counts as steady
+
+void AddProfile(const ThermalConfig& config, int index, std::vector<int>& thresholds) {
+    if (index < 0 || index >= (int)config.smartProfiles.size()) return;
+    for (const auto& level : config.smartProfiles[index]) {
+        if (level.temperature >= 0) thresholds.push_back(level.temperature);
+    }
+}
+
+} // namespace
+
+std::vector<int> AdaptiveCycle::CollectThresholds(const ThermalConfig& config, ControlMode mode, int smartProfile) {
+    std::vector<int> thresholds;
+    switch (mode) {
+        case ControlMode::BIOS:
+            return thresholds;
+        case ControlMode::Smart:
+            AddProfile(config, smartProfile, thresholds);
+            break;
+        case ControlMode::PID:
+            thresholds.push_back((int)std::lround(config.pid.targetTemp));
+            break;
+        case ControlMode::MPC:
+            thresholds.push_back((int)std::lround(config.mpc.targetTemp));
+            break;
+        case ControlMode::Manual:
+        case ControlMode::RPM:
+            thresholds.push_back(config.manModeExitTemp);
+            break;
+    }
+    
+    // Per-fan zones replace the global smart profile / PID loop
+    if (config.fanZonesEnabled && (mode == ControlMode::Smart || mode == ControlMode::PID)) {
+        for (const auto& zone : config.fanZones) {
+            if (zone.usePID) {
+                thresholds.push_back((int)std::lround(zone.pid.targetTemp));
+            } else {
+                AddProfile(config, zone.smartProfile, thresholds);
+            }
+        }
+    }
+    thresholds.push_back(config.ramp.criticalTemp);
+
+    std::sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(std::unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    return thresholds;
+}
+
+void AdaptiveCycle::SetThresholds(std::vector<int> thresholds) {
+    m_thresholds = std::move(thresholds);
+}
+
+void AdaptiveCycle::Reset() {
+    m_riseRate = 0.0f;
+    m_hasTemp = false;
+    m_fast = false;
+    m_periodMs = 0;
+}
+
+bool AdaptiveCycle::NearThreshold(int temp, int margin) const {
+    auto it = std::lower_bound(m_thresholds.begin(), m_thresholds.end(), temp - margin);
+    return it != m_thresholds.end() && *it <= temp + margin;
+}
+
+int AdaptiveCycle::Update(int maxTemp, float dt, const CycleConfig& config) {
+    const int minPeriod = std::max(config.minPeriodMs, 50);
+    const int maxPeriod = std::max(config.maxPeriodMs, minPeriod);
+
+    if (m_hasTemp && dt > 0.0f) {
+        float slope = (float)(maxTemp - m_lastTemp) / dt;
+        m_riseRate += kRateSmoothing * (slope - m_riseRate);
+    }
+    m_lastTemp = maxTemp;
+    m_hasTemp = true;
+
+    bool rising = m_riseRate >= config.riseRate;
+    bool close = m_riseRate > kWarmingRate && NearThreshold(maxTemp, config.thresholdMargin);
+    m_fast = rising || close;
+
+    if (m_fast || m_periodMs == 0) {
+        m_periodMs = minPeriod;
+    } else {
+        m_periodMs = std::min(m_periodMs * 2, maxPeriod);
+    }
+    return m_periodMs;
+}
+
+} // namespace Core
@@ -0,0 +1,54 @@
+// Core/AdaptiveCycle.h - Adaptive control loop period
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+#include "SensorConfig.h"
+
+#include <vector>
+
+namespace Core {
+
+/// Chooses the next control cycle period from the temperature trend.
+///
+/// The loop runs at minPeriodMs while the hottest sensor rises at riseRate or
+/// faster, or while it still warms up within thresholdMargin of a threshold of
+/// the active control mode. Otherwise the period doubles every cycle up to
+/// maxPeriodMs, so polling cost follows actual need; a temperature parked
+/// next to a threshold does not keep the loop fast.
+class AdaptiveCycle {
+public:
+    /// Thresholds the given mode acts on (smart level temperatures of the
+    /// selected profile, PID/MPC targets, manual exit and ramp critical
+    /// temperatures), sorted and deduplicated. BIOS mode has none.
+    static std::vector<int> CollectThresholds(const ThermalConfig& config, ControlMode mode, int smartProfile);
+
+    /// Replace the thresholds (call on config changes, allocates)
+    void SetThresholds(std::vector<int> thresholds);
+
+    /// Advance by one cycle.
+    /// @param maxTemp Hottest sensor temperature
+    /// @param dt Seconds since the previous cycle
+    /// @return Period of the next cycle in ms
+    int Update(int maxTemp, float dt, const CycleConfig& config);
+
+    /// Smoothed temperature slope in °C/s
+    float GetRiseRate() const { return m_riseRate; }
+
+    /// Whether the last Update() asked for the fast period
+    bool IsFast() const { return m_fast; }
+
+    void Reset();
+
+private:
+    bool NearThreshold(int temp, int margin) const;
+
+    std::vector<int> m_thresholds;
+    float m_riseRate{0.0f};
+    int m_lastTemp{0};
+    bool m_hasTemp{false};
+    bool m_fast{false};
+    int m_periodMs{0};
+};
+
+} // namespace Core
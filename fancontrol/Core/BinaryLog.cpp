@@ -0,0 +1,392 @@
+// Core/BinaryLog.cpp - Implementation of the deferred-formatting binary log
+#include "BinaryLog.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace Core {
+
+namespace {
+
+constexpr char kFileMagic[4] = {'T', 'P', 'B', 'L'};
+constexpr uint32_t kFileVersion = 1;
+constexpr char kDictionaryTag = 'D';
+constexpr char kRecordTag = 'R';
+
+std::atomic<uint64_t> g_nextLogId{1};
+
+// Buffer of the last log this thread wrote to, so Write() takes no lock
+struct ThreadCache {
+    uint64_t logId = 0;
+    void* buffer = nullptr;
+};
+thread_local ThreadCache t_cache;
+
+int64_t NowNs(auto clock) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock.time_since_epoch()).count();
+}
+
+size_t RoundUpPow2(size_t value) {
+    size_t result = 256;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+template <typename T>
+void Append(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool Read(std::istream& in, T& value) {
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+BinaryLog::ThreadBuffer::ThreadBuffer(size_t capacity, std::thread::id owner)
+    : data(std::make_unique<std::byte[]>(capacity))
+    , capacity(capacity)
+    , owner(owner)
+{
+}
+
+BinaryLog::BinaryLog(const Options& options)
+    : m_options(options)
+    , m_id(g_nextLogId.fetch_add(1))
+    , m_steadyAnchorNs(NowNs(std::chrono::steady_clock::now()))
+    , m_systemAnchorNs(NowNs(std::chrono::system_clock::now()))
+{
+    m_consumer = std::thread([this] { ConsumerLoop(); });
+}
+
+BinaryLog::~BinaryLog() {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+    m_wakeCv.notify_one();
+    if (m_consumer.joinable()) m_consumer.join();
+}
+
+void BinaryLog::SetSink(Sink sink, SinkFilter filter) {
+    std::lock_guard<std::mutex> lock(m_consumeMutex);
+    m_sink = std::move(sink);
+    m_filter = std::move(filter);
+}
+
+bool BinaryLog::OpenFile(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_consumeMutex);
+    // Records already captured belong to the previous file
+    DrainLocked();
+    if (m_file.is_open()) m_file.close();
+    m_path = path;
+    if (m_path.empty()) {
+        m_hasFile.store(false);
+        return true;
+    }
+    return OpenFileLocked();
+}
+
+bool BinaryLog::OpenFileLocked() {
+    m_dictionary.clear();
+    m_fileBytes = 0;
+    m_file.open(m_path, std::ios::binary | std::ios::trunc);
+    if (!m_file) {
+        m_hasFile.store(false);
+        return false;
+    }
+    m_file.write(kFileMagic, sizeof(kFileMagic));
+    m_file.write(reinterpret_cast<const char*>(&kFileVersion), sizeof(kFileVersion));
+    m_fileBytes = sizeof(kFileMagic) + sizeof(kFileVersion);
+    m_hasFile.store(true);
+    return true;
+}
+
+BinaryLog::ThreadBuffer* BinaryLog::AcquireBuffer() {
+    if (t_cache.logId == m_id) return static_cast<ThreadBuffer*>(t_cache.buffer);
+
+    const std::thread::id self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    auto it = std::find_if(m_buffers.begin(), m_buffers.end(),
+                           [&](const auto& buffer) { return buffer->owner == self; });
+    ThreadBuffer* buffer;
+    if (it != m_buffers.end()) {
+        // Own buffer of a thread that logs to several logs, or of an exited
+        // thread with the same id - either way this thread is its only producer
+        buffer = it->get();
+    } else {
+        m_buffers.push_back(std::make_unique<ThreadBuffer>(RoundUpPow2(m_options.threadBufferBytes), self));
+        buffer = m_buffers.back().get();
+    }
+    t_cache = {m_id, buffer};
+    return buffer;
+}
+
+std::byte* BinaryLog::Reserve(size_t size) {
+    ThreadBuffer* buffer = AcquireBuffer();
+    size = (size + 7) & ~size_t(7);
+    const size_t capacity = buffer->capacity;
+    if (size > capacity / 2) {
+        buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    const size_t offset = head & (capacity - 1);
+    const size_t padding = offset + size > capacity ? capacity - offset : 0;
+    if (head + padding + size - buffer->cachedTail > capacity) {
+        buffer->cachedTail = buffer->tail.load(std::memory_order_acquire);
+        if (head + padding + size - buffer->cachedTail > capacity) {
+            buffer->dropped.store(buffer->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+
+    if (padding > 0) {
+        // The entry must be contiguous: fill the end of the ring and start over
+        const uint32_t padSize = (uint32_t)padding;
+        std::memcpy(buffer->data.get() + offset + offsetof(EntryHeader, size), &padSize, sizeof(padSize));
+        std::memcpy(buffer->data.get() + offset + offsetof(EntryHeader, kind), &kPaddingEntry, sizeof(kPaddingEntry));
+        head += padding;
+    }
+    buffer->entryBegin = head;
+    buffer->entryEnd = head + size;
+    return buffer->data.get() + (head & (capacity - 1));
+}
+
+void BinaryLog::Commit(const EntryHeader& header) {
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(t_cache.buffer);
+    EntryHeader stored = header;
+    stored.size = (uint32_t)(buffer->entryEnd - buffer->entryBegin);
+    std::memcpy(buffer->data.get() + (buffer->entryBegin & (buffer->capacity - 1)), &stored, sizeof(stored));
+    buffer->records.store(buffer->records.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    buffer->head.store(buffer->entryEnd, std::memory_order_release);
+
+    // Pairs with the fence in ConsumerLoop: either the consumer sees this
+    // record before it sleeps, or this thread sees it asleep and wakes it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumerSleeping.load(std::memory_order_relaxed) &&
+        m_consumerSleeping.exchange(false, std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeRequested = true;
+        m_wakeCv.notify_one();
+    }
+}
+
+bool BinaryLog::HasPending() const {
+    std::lock_guard<std::mutex> lock(m_buffersMutex);
+    for (const auto& buffer : m_buffers) {
+        if (buffer->head.load(std::memory_order_relaxed) != buffer->tail.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BinaryLog::ConsumerLoop() {
+    for (;;) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            // Sleep without a timeout while every buffer is empty
+            m_wakeRequested = false;
+            m_consumerSleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasPending()) {
+                m_wakeCv.wait(lock, [this] { return m_stop || m_wakeRequested; });
+            }
+            m_consumerSleeping.store(false, std::memory_order_relaxed);
+
+            // Data is pending: give the writers a moment to batch up more
+            m_wakeCv.wait_for(lock, std::chrono::milliseconds(std::max(m_options.drainIntervalMs, 1)),
+                              [this] { return m_stop; });
+            stop = m_stop;
+        }
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(m_consumeMutex);
+        const uint64_t written = m_bytesWritten.load(std::memory_order_relaxed);
+        DrainLocked();
+        if (m_file.is_open() && m_bytesWritten.load(std::memory_order_relaxed) != written) m_file.flush();
+        if (stop) break;
+    }
+}
+
+void BinaryLog::Flush() {
+    std::lock_guard<std::mutex> lock(m_consumeMutex);
+    DrainLocked();
+    if (m_file.is_open()) m_file.flush();
+}
+
+void BinaryLog::DrainLocked() {
+    struct Cursor {
+        ThreadBuffer* buffer;
+        uint64_t pos;
+        uint64_t end;
+        EntryHeader front;
+    };
+    std::vector<Cursor> cursors;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        cursors.reserve(m_buffers.size());
+        for (const auto& buffer : m_buffers) {
+            cursors.push_back({buffer.get(), buffer->tail.load(std::memory_order_relaxed),
+                               buffer->head.load(std::memory_order_acquire), {}});
+        }
+    }
+
+    // Move a cursor to its next record (past wrap padding); false when empty
+    auto peek = [](Cursor& c) {
+        while (c.pos < c.end) {
+            const std::byte* entry = c.buffer->data.get() + (c.pos & (c.buffer->capacity - 1));
+            uint32_t size;
+            uint8_t kind;
+            std::memcpy(&size, entry + offsetof(EntryHeader, size), sizeof(size));
+            std::memcpy(&kind, entry + offsetof(EntryHeader, kind), sizeof(kind));
+            if (kind == kRecordEntry) {
+                std::memcpy(&c.front, entry, sizeof(EntryHeader));
+                return true;
+            }
+            c.pos += size;
+        }
+        return false;
+    };
+
+    std::vector<Cursor*> pending;
+    for (Cursor& c : cursors) {
+        if (peek(c)) pending.push_back(&c);
+    }
+
+    // Merge the thread buffers by timestamp
+    while (!pending.empty()) {
+        auto next = std::min_element(pending.begin(), pending.end(), [](const Cursor* a, const Cursor* b) {
+            return a->front.timeNs < b->front.timeNs;
+        });
+        Cursor& c = **next;
+        const std::byte* entry = c.buffer->data.get() + (c.pos & (c.buffer->capacity - 1));
+        Process(c.front, entry + sizeof(EntryHeader));
+        c.pos += c.front.size;
+        if (!peek(c)) pending.erase(next);
+    }
+
+    for (Cursor& c : cursors) c.buffer->tail.store(c.pos, std::memory_order_release);
+}
+
+void BinaryLog::Process(const EntryHeader& header, const std::byte* args) {
+    const LogLevel level = (LogLevel)header.level;
+    if (m_sink && (!m_filter || m_filter(level))) {
+        std::string message;
+        header.format(args, std::string_view(header.fmt, header.fmtSize), message);
+        m_formatted.fetch_add(1, std::memory_order_relaxed);
+        m_sink(level, std::chrono::steady_clock::time_point(
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::nanoseconds(header.timeNs))),
+               std::move(message));
+    }
+    if (m_file.is_open()) WriteRecordLocked(header, args);
+}
+
+void BinaryLog::WriteRecordLocked(const EntryHeader& header, const std::byte* args) {
+    if (m_options.maxFileBytes > 0 && m_fileBytes >= m_options.maxFileBytes) {
+        m_file.close();
+        std::error_code ec;
+        fs::rename(m_path, m_path + ".1", ec);
+        if (!OpenFileLocked()) return;
+    }
+
+    m_scratch.clear();
+    auto [it, added] = m_dictionary.try_emplace({header.fmt, header.signature}, (uint32_t)m_dictionary.size());
+    const uint32_t id = it->second;
+    if (added) {
+        const uint8_t signatureSize = (uint8_t)std::strlen(header.signature);
+        m_scratch += kDictionaryTag;
+        Append(m_scratch, id);
+        Append(m_scratch, header.fmtSize);
+        m_scratch.append(header.fmt, header.fmtSize);
+        Append(m_scratch, signatureSize);
+        m_scratch.append(header.signature, signatureSize);
+    }
+
+    m_scratch += kRecordTag;
+    Append(m_scratch, id);
+    Append(m_scratch, header.level);
+    Append(m_scratch, header.argBytes);
+    Append(m_scratch, header.timeNs - m_steadyAnchorNs + m_systemAnchorNs);
+    m_scratch.append(reinterpret_cast<const char*>(args), header.argBytes);
+
+    m_file.write(m_scratch.data(), (std::streamsize)m_scratch.size());
+    m_fileBytes += m_scratch.size();
+    m_bytesWritten.fetch_add(m_scratch.size(), std::memory_order_relaxed);
+}
+
+BinaryLog::Stats BinaryLog::GetStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_buffersMutex);
+        for (const auto& buffer : m_buffers) {
+            stats.records += buffer->records.load(std::memory_order_relaxed);
+            stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    stats.formatted = m_formatted.load(std::memory_order_relaxed);
+    stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+    stats.wakeups = m_wakeups.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool BinaryLog::Decode(const std::string& path, const DecodeCallback& callback) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kFileMagic)];
+    uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kFileMagic, sizeof(magic)) != 0 ||
+        !Read(in, version) || version != kFileVersion) {
+        return false;
+    }
+
+    struct Format {
+        std::string fmt;
+        std::string signature;
+    };
+    std::vector<Format> dictionary;
+    std::vector<std::byte> args;
+    std::string message;
+
+    // A log cut short by a crash ends in a partial entry: stop there
+    char tag;
+    while (Read(in, tag)) {
+        if (tag == kDictionaryTag) {
+            uint32_t id, fmtSize;
+            uint8_t signatureSize;
+            Format format;
+            if (!Read(in, id) || !Read(in, fmtSize)) break;
+            format.fmt.resize(fmtSize);
+            if (!in.read(format.fmt.data(), fmtSize) || !Read(in, signatureSize)) break;
+            format.signature.resize(signatureSize);
+            if (!in.read(format.signature.data(), signatureSize)) break;
+            if (id >= dictionary.size()) dictionary.resize(id + 1);
+            dictionary[id] = std::move(format);
+        } else if (tag == kRecordTag) {
+            uint32_t id;
+            uint8_t level;
+            uint16_t argBytes;
+            int64_t unixNs;
+            if (!Read(in, id) || !Read(in, level) || !Read(in, argBytes) || !Read(in, unixNs)) break;
+            args.resize(argBytes);
+            if (!in.read(reinterpret_cast<char*>(args.data()), argBytes)) break;
+            if (id >= dictionary.size()) return false;
+            message.clear();
+            if (!LogArgs::FormatDynamic(dictionary[id].fmt, dictionary[id].signature,
+                                        args.data(), args.size(), message)) {
+                return false;
+            }
+            callback((LogLevel)level, unixNs, message);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace Core
@@ -0,0 +1,191 @@
+// Core/BinaryLog.h - Deferred-formatting binary log backend
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+#include "LogArgs.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Core {
+
+/// Log backend that keeps formatting off the logging thread.
+///
+/// Write() stores the address of the format literal, its FormatFn (one per
+/// argument type list, see LogArgs) and the arguments in binary form into a
+/// buffer owned by the calling thread - no formatting, no allocation, no lock.
+/// A background consumer sleeps until a record arrives, waits drainIntervalMs
+/// so more can batch up, then drains all thread buffers in timestamp order;
+/// an idle log never wakes it. It formats a record only if the sink filter wants it, and
+/// appends it to the binary file (if one is open) without formatting at all:
+/// each format literal goes into the file once as a dictionary entry with its
+/// argument signature, records refer to it by a dense id. Decode() turns such
+/// a file back into text offline.
+///
+/// A full thread buffer drops the record (counted in Stats::dropped) rather
+/// than blocking the writer. Thread buffers live as long as the log.
+class BinaryLog {
+public:
+    struct Options {
+        size_t threadBufferBytes = 64 * 1024;   // Per writing thread, rounded up to a power of two
+        int drainIntervalMs = 50;               // Batching delay after the first pending record
+        uint64_t maxFileBytes = 16ull << 20;    // Then the file moves to <path>.1 (0 = no limit)
+    };
+
+    struct Stats {
+        uint64_t records = 0;       // Accepted by Write()
+        uint64_t dropped = 0;       // Thread buffer full
+        uint64_t formatted = 0;     // Formatted for the sink
+        uint64_t bytesWritten = 0;  // Appended to the binary file
+        uint64_t wakeups = 0;       // Consumer drain passes
+    };
+
+    /// Receives formatted records on the consumer thread
+    using Sink = std::function<void(LogLevel level, std::chrono::steady_clock::time_point time,
+                                    std::string message)>;
+    /// Whether the sink wants a record; records it rejects are never formatted
+    using SinkFilter = std::function<bool(LogLevel level)>;
+
+    /// Receives decoded records (time in ns since the Unix epoch)
+    using DecodeCallback = std::function<void(LogLevel level, int64_t unixNs, std::string_view message)>;
+
+    static constexpr uint16_t kMaxStringBytes = 1024;   // Longer string arguments are cut
+    static constexpr size_t kMaxArgBytes = 4096;
+
+    BinaryLog() : BinaryLog(Options{}) {}
+    explicit BinaryLog(const Options& options);
+    ~BinaryLog();
+
+    BinaryLog(const BinaryLog&) = delete;
+    BinaryLog& operator=(const BinaryLog&) = delete;
+
+    void SetSink(Sink sink, SinkFilter filter = {});
+
+    /// Start appending records to a binary file (empty path closes it)
+    bool OpenFile(const std::string& path);
+    bool HasFile() const { return m_hasFile.load(std::memory_order_relaxed); }
+
+    /// Capture a record; returns false if it was dropped
+    template <typename... Args>
+    bool Write(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        static_assert(LogArgs::kFixedBytes<Args...> <= kMaxArgBytes, "Too many log arguments");
+        const size_t argBytes = LogArgs::EncodedSize(kMaxStringBytes, args...);
+        std::byte* entry = Reserve(sizeof(EntryHeader) + argBytes);
+        if (entry == nullptr) return false;
+
+        EntryHeader header{
+            .size = 0,
+            .kind = kRecordEntry,
+            .level = (uint8_t)level,
+            .argBytes = (uint16_t)argBytes,
+            .timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count(),
+            .fmt = fmt.get().data(),
+            .signature = LogArgs::kSignature<Args...>,
+            .format = &LogArgs::FormatTo<Args...>,
+            .fmtSize = (uint32_t)fmt.get().size()
+        };
+        LogArgs::Writer out(entry + sizeof(EntryHeader), argBytes, LogArgs::kFixedBytes<Args...>,
+                            kMaxStringBytes);
+        (out.Put(args), ...);
+        Commit(header);
+        return true;
+    }
+
+    /// Drain all buffers now on the calling thread and flush the file
+    void Flush();
+
+    Stats GetStats() const;
+
+    /// Read a binary log file; false if it cannot be opened or is not a log file
+    static bool Decode(const std::string& path, const DecodeCallback& callback);
+
+private:
+    static constexpr uint8_t kRecordEntry = 0;
+    static constexpr uint8_t kPaddingEntry = 1;  // Skips the rest of the ring before a wrap
+
+    // Start of every entry in a thread buffer, followed by argBytes of arguments
+    struct EntryHeader {
+        uint32_t size;          // Whole entry, 8-byte aligned (set by Commit)
+        uint8_t kind;
+        uint8_t level;
+        uint16_t argBytes;
+        int64_t timeNs;         // steady_clock
+        const char* fmt;
+        const char* signature;
+        LogArgs::FormatFn format;
+        uint32_t fmtSize;
+    };
+
+    // Single-producer single-consumer byte ring of one writing thread
+    struct ThreadBuffer {
+        ThreadBuffer(size_t capacity, std::thread::id owner);
+
+        std::unique_ptr<std::byte[]> data;
+        size_t capacity;
+        std::thread::id owner;
+        alignas(64) std::atomic<uint64_t> head{0};  // Written by the producer
+        uint64_t entryBegin{0};                     // Producer: entry between Reserve and Commit
+        uint64_t entryEnd{0};
+        uint64_t cachedTail{0};                     // Producer: last tail seen
+        std::atomic<uint64_t> records{0};
+        std::atomic<uint64_t> dropped{0};
+        alignas(64) std::atomic<uint64_t> tail{0};  // Written by the consumer
+    };
+
+    std::byte* Reserve(size_t size);
+    void Commit(const EntryHeader& header);
+    ThreadBuffer* AcquireBuffer();
+
+    void ConsumerLoop();
+    bool HasPending() const;
+    void DrainLocked();
+    void Process(const EntryHeader& header, const std::byte* args);
+    void WriteRecordLocked(const EntryHeader& header, const std::byte* args);
+    bool OpenFileLocked();
+
+    const Options m_options;
+    const uint64_t m_id;                  // Matches the thread-local buffer cache to this log
+    const int64_t m_steadyAnchorNs;       // steady_clock and system_clock at construction
+    const int64_t m_systemAnchorNs;
+
+    // Thread buffers (list protected by m_buffersMutex)
+    mutable std::mutex m_buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+
+    // Consumer state (protected by m_consumeMutex)
+    std::mutex m_consumeMutex;
+    Sink m_sink;
+    SinkFilter m_filter;
+    std::string m_path;
+    std::ofstream m_file;
+    uint64_t m_fileBytes{0};
+    std::map<std::pair<const char*, const char*>, uint32_t> m_dictionary;  // (fmt, signature) -> id in the file
+    std::string m_scratch;
+    std::atomic<bool> m_hasFile{false};
+    std::atomic<uint64_t> m_formatted{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+
+    // Consumer wakeup: a producer notifies only when it finds the consumer asleep
+    std::atomic<bool> m_consumerSleeping{false};
+    std::atomic<uint64_t> m_wakeups{0};
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    bool m_wakeRequested{false};
+    bool m_stop{false};
+    std::thread m_consumer;
+};
+
+} // namespace Core
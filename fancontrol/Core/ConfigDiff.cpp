@@ -0,0 +1,88 @@
+// Core/ConfigDiff.cpp - Implementation of the configuration diff
+#include "ConfigDiff.h"
+
+namespace Core {
+
+namespace {
+
+const SensorDefinition* FindSensor(const ThermalConfig& config, int index) {
+    for (const auto& sensor : config.sensors) {
+        if (sensor.index == index) return &sensor;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool ConfigDiff::Empty() const {
+    return sensorOffsets.empty() && sensorNames.empty() && sensorWeights.empty() && sensorsRemoved.empty() &&
+           !sampling && !hardware && !smartProfiles && !pid && !mpc && !rpm && !ramp &&
+           !fanZones && !cyclePeriod && !thresholds && !other;
+}
+
+std::string ConfigDiff::Describe() const {
+    std::string text;
+    auto add = [&text](bool changed, const char* name) {
+        if (!changed) return;
+        if (!text.empty()) text += ", ";
+        text += name;
+    };
+    add(!sensorOffsets.empty(), "sensor offsets");
+    add(!sensorNames.empty(), "sensor names");
+    add(!sensorWeights.empty(), "sensor weights");
+    add(!sensorsRemoved.empty(), "removed sensors");
+    add(sampling, "sampling");
+    add(hardware, "hardware");
+    add(smartProfiles, "smart profiles");
+    add(pid, "pid");
+    add(mpc, "mpc");
+    add(rpm, "rpm");
+    add(ramp, "ramp");
+    add(fanZones, "fan zones");
+    add(cyclePeriod, "cycle period");
+    add(thresholds, "thresholds");
+    add(other, "other");
+    return text.empty() ? "nothing" : text;
+}
+
+ConfigDiff DiffConfig(const ThermalConfig& before, const ThermalConfig& after) {
+    ConfigDiff diff;
+
+    for (const auto& sensor : after.sensors) {
+        const SensorDefinition* old = FindSensor(before, sensor.index);
+        if (!old || old->offset != sensor.offset || old->hystMin != sensor.hystMin ||
+            old->hystMax != sensor.hystMax) {
+            diff.sensorOffsets.push_back(sensor.index);
+        }
+        if (!old || old->name != sensor.name) diff.sensorNames.push_back(sensor.index);
+        if (!old || old->weight != sensor.weight) diff.sensorWeights.push_back(sensor.index);
+    }
+    for (const auto& sensor : before.sensors) {
+        if (!FindSensor(after, sensor.index)) diff.sensorsRemoved.push_back(sensor.index);
+    }
+
+    diff.sampling = before.useBiasedTemps != after.useBiasedTemps ||
+                    before.noExtSensor != after.noExtSensor ||
+                    before.ignoreList != after.ignoreList;
+    diff.hardware = before.isDualFan != after.isDualFan || before.fanSpeedAddr != after.fanSpeedAddr;
+    diff.smartProfiles = before.smartProfiles != after.smartProfiles;
+    diff.pid = before.pid != after.pid;
+    diff.mpc = before.mpc != after.mpc;
+    diff.rpm = before.rpm != after.rpm;
+    diff.ramp = before.ramp != after.ramp;
+    diff.fanZones = before.fanZonesEnabled != after.fanZonesEnabled || before.fanZones != after.fanZones;
+    diff.cyclePeriod = before.cycleSeconds != after.cycleSeconds || before.cycle != after.cycle;
+    diff.thresholds = diff.smartProfiles || diff.fanZones ||
+                      before.pid.targetTemp != after.pid.targetTemp ||
+                      before.mpc.targetTemp != after.mpc.targetTemp ||
+                      before.manModeExitTemp != after.manModeExitTemp ||
+                      before.ramp.criticalTemp != after.ramp.criticalTemp;
+    diff.other = before.iconCycleSeconds != after.iconCycleSeconds ||
+                 before.useFahrenheit != after.useFahrenheit ||
+                 before.iconLevels != after.iconLevels ||
+                 before.manualFanSpeed != after.manualFanSpeed ||
+                 before.watchdog != after.watchdog;
+    return diff;
+}
+
+} // namespace Core
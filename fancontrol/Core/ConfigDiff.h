@@ -0,0 +1,46 @@
+// Core/ConfigDiff.h - Differences between two thermal configurations
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "SensorConfig.h"
+
+#include <string>
+#include <vector>
+
+namespace Core {
+
+/// What changed from one ThermalConfig to the next.
+///
+/// ThermalManager applies only the flagged pieces, so state that depends on
+/// an unchanged piece survives a config edit: renaming a sensor keeps the
+/// smart-mode hysteresis, the ramp scheduler history and the learned RPM
+/// curve exactly as they were.
+struct ConfigDiff {
+    std::vector<int> sensorOffsets;     // Sensor indices with a new offset or hysteresis window
+    std::vector<int> sensorNames;       // Sensor indices with a new name
+    std::vector<int> sensorWeights;     // Sensor indices with a new weight
+    std::vector<int> sensorsRemoved;    // Sensor indices present only in `before`
+    bool sampling = false;              // useBiasedTemps, noExtSensor or ignoreList
+    bool hardware = false;              // isDualFan or fanSpeedAddr
+    bool smartProfiles = false;
+    bool pid = false;
+    bool mpc = false;
+    bool rpm = false;
+    bool ramp = false;
+    bool fanZones = false;              // fanZonesEnabled or fanZones
+    bool cyclePeriod = false;           // cycleSeconds or cycle
+    bool thresholds = false;            // Anything AdaptiveCycle::CollectThresholds reads
+    bool other = false;                 // Settings the worker reads directly (display, manual level, ...)
+
+    bool Empty() const;
+
+    /// Short list of the changed pieces for the log, e.g. "sensor names, pid"
+    std::string Describe() const;
+};
+
+/// Compare two configurations. Sensors are matched by SensorDefinition::index;
+/// a sensor missing from `before` counts as changed in every respect, one
+/// missing from `after` is listed in sensorsRemoved.
+ConfigDiff DiffConfig(const ThermalConfig& before, const ThermalConfig& after);
+
+} // namespace Core
@@ -0,0 +1,119 @@
+// Core/CycleProfiler.cpp - Implementation of the cycle phase profiler
+#include "CycleProfiler.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Core {
+
+namespace {
+
+uint32_t ToUs(CycleProfiler::Clock::duration d) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    return static_cast<uint32_t>(std::clamp<int64_t>(us, 0, UINT32_MAX));
+}
+
+} // namespace
+
+// --- LatencyHistogram ---
+
+int LatencyHistogram::BucketOf(uint32_t us) {
+    if (us < 16) return static_cast<int>(us);
+    int octave = 31 - std::countl_zero(us);            // 4..31
+    int sub = static_cast<int>(us >> (octave - 2)) & 3; // Two bits below the leading one
+    return 16 + (octave - 4) * 4 + sub;
+}
+
+uint32_t LatencyHistogram::BucketUpperBound(int bucket) {
+    if (bucket < 16) return static_cast<uint32_t>(bucket);
+    int octave = 4 + (bucket - 16) / 4;
+    uint64_t width = 1ull << (octave - 2);
+    uint64_t lower = (4 + (bucket - 16) % 4) * width;
+    return static_cast<uint32_t>(std::min<uint64_t>(lower + width - 1, UINT32_MAX));
+}
+
+void LatencyHistogram::Record(uint32_t us) {
+    m_counts[BucketOf(us)]++;
+    m_count++;
+    m_total += us;
+    m_max = std::max(m_max, us);
+}
+
+uint32_t LatencyHistogram::Percentile(double q) const {
+    if (m_count == 0) return 0;
+    // Rank of the quantile, 1-based: the smallest sample with at least q of all at or below it
+    uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(q, 0.0, 1.0) * (double)m_count));
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; b++) {
+        seen += m_counts[b];
+        if (seen >= rank) return std::min(BucketUpperBound(b), m_max);
+    }
+    return m_max;
+}
+
+// --- CycleProfiler ---
+
+CycleProfiler::Scope::Scope(CycleProfiler& profiler, CyclePhase phase)
+    : m_profiler(profiler)
+    , m_parent(profiler.m_current)
+    , m_phase(phase)
+    , m_active(profiler.m_inCycle)
+{
+    if (!m_active) return;
+    m_profiler.m_current = this;
+    m_start = Clock::now();
+}
+
+CycleProfiler::Scope::~Scope() {
+    if (!m_active) return;
+    Clock::duration elapsed = Clock::now() - m_start;
+    int index = static_cast<int>(m_phase);
+    m_profiler.m_cycleTime[index] += elapsed - m_children;
+    m_profiler.m_ran[index] = true;
+    if (m_parent) m_parent->m_children += elapsed;
+    m_profiler.m_current = m_parent;
+}
+
+void CycleProfiler::BeginCycle() {
+    m_cycleTime.fill(Clock::duration::zero());
+    m_ran.fill(false);
+    m_current = nullptr;
+    m_inCycle = true;
+    m_cycleStart = Clock::now();
+}
+
+void CycleProfiler::EndCycle() {
+    if (!m_inCycle) return;
+    const int total = static_cast<int>(CyclePhase::Total);
+    m_cycleTime[total] = Clock::now() - m_cycleStart;
+    m_ran[total] = true;
+    
+    for (int i = 0; i < kCyclePhaseCount; i++) {
+        m_lastCycle.us[i] = 0;
+        if (!m_ran[i]) continue;
+        m_lastUs[i] = ToUs(m_cycleTime[i]);
+        m_lastCycle.us[i] = m_lastUs[i];
+        m_histograms[i].Record(m_lastUs[i]);
+    }
+    m_cycles++;
+    m_inCycle = false;
+}
+
+CycleProfile CycleProfiler::Snapshot() const {
+    CycleProfile profile;
+    profile.cycles = m_cycles;
+    profile.sampleRetries = m_sampleRetries;
+    for (int i = 0; i < kCyclePhaseCount; i++) {
+        const LatencyHistogram& histogram = m_histograms[i];
+        PhaseProfile& phase = profile.phases[i];
+        phase.samples = histogram.Count();
+        phase.lastUs = m_lastUs[i];
+        phase.p50Us = histogram.Percentile(0.50);
+        phase.p99Us = histogram.Percentile(0.99);
+        phase.maxUs = histogram.Max();
+        phase.totalUs = histogram.Total();
+    }
+    return profile;
+}
+
+} // namespace Core
@@ -0,0 +1,94 @@
+// Core/CycleProfiler.h - Per-phase timing of the control cycle
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace Core {
+
+/// Log-linear latency histogram in µs: exact below 16 µs, then four buckets
+/// per power of two (relative error below 25%). Fixed size, no allocation.
+class LatencyHistogram {
+public:
+    static constexpr int kBuckets = 16 + 28 * 4;
+    
+    void Record(uint32_t us);
+    
+    /// Upper bound of the bucket holding quantile q (0..1), capped at Max()
+    uint32_t Percentile(double q) const;
+    
+    uint64_t Count() const { return m_count; }
+    uint64_t Total() const { return m_total; }
+    uint32_t Max() const { return m_max; }
+    
+    static int BucketOf(uint32_t us);
+    static uint32_t BucketUpperBound(int bucket);
+    
+private:
+    std::array<uint64_t, kBuckets> m_counts{};
+    uint64_t m_count{0};
+    uint64_t m_total{0};
+    uint32_t m_max{0};
+};
+
+/// Scoped timers for the phases of PerformCycle.
+///
+/// Time is accumulated per phase between BeginCycle() and EndCycle() (a phase
+/// may run several times per cycle, e.g. on sample retries) and committed to
+/// that phase's histogram once per cycle. Scopes nest: a phase reports its
+/// exclusive time, so fan writes inside the control decision are counted as
+/// FanWrite only. Scopes outside a cycle record nothing. Worker thread only.
+class CycleProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    class Scope {
+    public:
+        Scope(CycleProfiler& profiler, CyclePhase phase);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        
+    private:
+        CycleProfiler& m_profiler;
+        Scope* m_parent;
+        CyclePhase m_phase;
+        Clock::time_point m_start;
+        Clock::duration m_children{};
+        bool m_active;
+    };
+    
+    void BeginCycle();
+    void EndCycle();
+    
+    /// Count a repeated sample round of the current cycle
+    void CountSampleRetry() { m_sampleRetries++; }
+    
+    /// Current histograms as a profile (the caller fills in the EC counters)
+    CycleProfile Snapshot() const;
+    
+    /// Phase times of the last completed cycle
+    const CyclePhaseTimes& LastCycle() const { return m_lastCycle; }
+    
+    const LatencyHistogram& Histogram(CyclePhase phase) const {
+        return m_histograms[static_cast<int>(phase)];
+    }
+    
+private:
+    std::array<LatencyHistogram, kCyclePhaseCount> m_histograms;
+    std::array<Clock::duration, kCyclePhaseCount> m_cycleTime{};
+    std::array<bool, kCyclePhaseCount> m_ran{};
+    std::array<uint32_t, kCyclePhaseCount> m_lastUs{};
+    CyclePhaseTimes m_lastCycle;
+    Clock::time_point m_cycleStart;
+    Scope* m_current{nullptr};
+    bool m_inCycle{false};
+    uint64_t m_cycles{0};
+    uint64_t m_sampleRetries{0};
+};
+
+} // namespace Core
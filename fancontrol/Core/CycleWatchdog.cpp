@@ -0,0 +1,153 @@
+// Core/CycleWatchdog.cpp - Implementation of the control worker watchdog
+#include "CycleWatchdog.h"
+#include <algorithm>
+#include <limits>
+
+namespace Core {
+
+namespace {
+
+uint32_t ToMs(CycleWatchdog::Clock::duration d) {
+    return static_cast<uint32_t>(std::max<int64_t>(0,
+        std::chrono::duration_cast<std::chrono::milliseconds>(d).count()));
+}
+
+} // namespace
+
+CycleWatchdog::CycleWatchdog(FailSafe failSafe,
+                             std::chrono::milliseconds retryInterval)
+    : m_failSafe(std::move(failSafe))
+    , m_retryInterval(retryInterval)
+{
+}
+
+CycleWatchdog::~CycleWatchdog() {
+    Stop();
+}
+
+void CycleWatchdog::Start() {
+    if (m_thread.joinable()) return;
+    m_thread = std::jthread([this](std::stop_token token) { Run(token); });
+}
+
+void CycleWatchdog::Stop() {
+    if (!m_thread.joinable()) return;
+    m_thread.request_stop();
+    m_thread.join();
+    m_thread = std::jthread();
+}
+
+bool CycleWatchdog::Beat(Clock::time_point deadline) {
+    Clock::rep ticks = deadline.time_since_epoch().count();
+    m_deadline.store(ticks, std::memory_order_seq_cst);
+    bool recovered = false;
+    if (m_tripped.load(std::memory_order_acquire)) {
+        // First beat after a stall: close it out
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_tripped.load(std::memory_order_relaxed)) {
+            uint32_t stallMs = ToMs(Clock::now() - m_stallStart);
+            m_stats.lastStallMs = stallMs;
+            m_stats.maxStallMs = std::max(m_stats.maxStallMs, stallMs);
+            m_stats.totalStallMs += stallMs;
+            m_stats.stalled = false;
+            m_tripped.store(false, std::memory_order_seq_cst);
+            recovered = true;
+        }
+    }
+    WakeIfEarlier(ticks);
+    return recovered;
+}
+
+void CycleWatchdog::Disarm() {
+    // Never earlier than what the thread waits for: at worst it wakes once for nothing
+    m_deadline.store(0, std::memory_order_seq_cst);
+}
+
+void CycleWatchdog::WakeIfEarlier(Clock::rep ticks) {
+    // Pairs with Run storing m_waitingFor before it re-reads m_deadline and
+    // m_tripped: either the thread sees the new state or this sees its wake time
+    if (ticks >= m_waitingFor.load(std::memory_order_seq_cst)) return;
+    std::lock_guard<std::mutex> lock(m_waitMutex);
+    m_wakeRequested = true;
+    m_cv.notify_one();
+}
+
+WatchdogStats CycleWatchdog::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void CycleWatchdog::Run(std::stop_token stopToken) {
+    constexpr Clock::rep kIndefinitely = std::numeric_limits<Clock::rep>::max();
+    Clock::time_point retryAt{};
+    
+    while (!stopToken.stop_requested()) {
+        {
+            std::unique_lock<std::mutex> waitLock(m_waitMutex);
+            Clock::rep ticks = m_deadline.load(std::memory_order_seq_cst);
+            bool tripped = m_tripped.load(std::memory_order_seq_cst);
+            Clock::rep wakeAt = ticks == 0 ? kIndefinitely : ticks;
+            if (tripped) {
+                // Stall in progress: retry a failed fail-safe, else wait for the worker's beat
+                std::lock_guard<std::mutex> lock(m_mutex);
+                wakeAt = m_failSafeDone ? kIndefinitely : retryAt.time_since_epoch().count();
+            }
+            m_waitingFor.store(wakeAt, std::memory_order_seq_cst);
+            
+            // A beat that landed before m_waitingFor was published did not wake us
+            if (m_deadline.load(std::memory_order_seq_cst) == ticks &&
+                m_tripped.load(std::memory_order_seq_cst) == tripped) {
+                m_wakeRequested = false;
+                auto woken = [this] { return m_wakeRequested; };
+                if (wakeAt == kIndefinitely) {
+                    m_cv.wait(waitLock, stopToken, woken);
+                } else {
+                    m_cv.wait_until(waitLock, stopToken, Clock::time_point(Clock::duration(wakeAt)), woken);
+                }
+            }
+            m_waitingFor.store(0, std::memory_order_seq_cst);
+        }
+        if (stopToken.stop_requested()) break;
+        
+        Clock::rep ticks = m_deadline.load(std::memory_order_acquire);
+        Clock::time_point now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.wakeups++;
+        }
+        if (ticks == 0) continue;
+        
+        Clock::time_point deadline{Clock::duration(ticks)};
+        if (now <= deadline) continue;
+        
+        int attempt;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_tripped.load(std::memory_order_relaxed)) {
+                m_tripped.store(true, std::memory_order_release);
+                m_stallStart = deadline;
+                m_attempts = 0;
+                m_failSafeDone = false;
+                m_stats.trips++;
+                m_stats.stalled = true;
+            } else if (m_failSafeDone) {
+                continue;
+            }
+            attempt = ++m_attempts;
+        }
+        
+        // Outside the lock: the fail-safe may take a while on a sick EC
+        bool ok = m_failSafe && m_failSafe(std::chrono::milliseconds(ToMs(now - deadline)), attempt);
+        
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok) {
+            m_stats.failSafeWrites++;
+            m_failSafeDone = true;
+        } else {
+            m_stats.failSafeFailures++;
+            retryAt = Clock::now() + m_retryInterval;
+        }
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,89 @@
+// Core/CycleWatchdog.h - Deadline watchdog for the control worker
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Core {
+
+/// Watches the heartbeat of the control worker from its own thread.
+///
+/// The worker calls Beat() with the latest time it expects to beat again:
+/// at the start of a cycle (now + stall budget) and before it sleeps (next
+/// cycle deadline + stall budget). When that time passes without a beat the
+/// worker is considered wedged, typically inside EC retries with the EC mutex
+/// held, and the fail-safe runs on the watchdog thread. It is retried every
+/// retry interval until it reports success or the worker beats again.
+///
+/// The thread sleeps until the stored deadline, or indefinitely while
+/// disarmed or after the fail-safe succeeded. A beat wakes it only when it
+/// moves the deadline earlier than the one being waited for.
+///
+/// The fail-safe may wait for the worker to let go of the EC (see
+/// ECManager::Preempt) but must bound that wait; it is simply retried.
+class CycleWatchdog {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    /// Fail-safe action: (time overdue, attempt within this stall starting at 1) -> success
+    using FailSafe = std::function<bool(std::chrono::milliseconds, int)>;
+    
+    /// @param failSafe Called on a missed deadline and retried until it succeeds
+    /// @param retryInterval Delay between fail-safe attempts that did not succeed
+    explicit CycleWatchdog(FailSafe failSafe,
+                           std::chrono::milliseconds retryInterval = std::chrono::milliseconds(100));
+    ~CycleWatchdog();
+    
+    CycleWatchdog(const CycleWatchdog&) = delete;
+    CycleWatchdog& operator=(const CycleWatchdog&) = delete;
+    
+    /// Start the watchdog thread (disarmed until the first Beat)
+    void Start();
+    
+    /// Stop the watchdog thread; blocks until it has exited
+    void Stop();
+    
+    /// Heartbeat: the next beat is due by deadline.
+    /// @return true if this beat ends a stall the fail-safe fired for
+    bool Beat(Clock::time_point deadline);
+    
+    /// No deadline until the next Beat (worker stopping or watchdog disabled)
+    void Disarm();
+    
+    WatchdogStats GetStats() const;
+    
+private:
+    void Run(std::stop_token stopToken);
+    void WakeIfEarlier(Clock::rep ticks);
+    
+    FailSafe m_failSafe;
+    std::chrono::milliseconds m_retryInterval;
+    
+    // Deadline in steady clock ticks, 0: disarmed
+    std::atomic<Clock::rep> m_deadline{0};
+    // Wake time the thread sleeps towards, in ticks (max: indefinitely)
+    std::atomic<Clock::rep> m_waitingFor{0};
+    std::atomic<bool> m_tripped{false};
+    
+    // Stall bookkeeping (protected by m_mutex)
+    mutable std::mutex m_mutex;
+    WatchdogStats m_stats;
+    Clock::time_point m_stallStart;
+    int m_attempts{0};
+    bool m_failSafeDone{false};
+    
+    // Thread wakeup (m_wakeRequested protected by m_waitMutex)
+    std::mutex m_waitMutex;
+    std::condition_variable_any m_cv;
+    bool m_wakeRequested{false};
+    std::jthread m_thread;
+};
+
+} // namespace Core
@@ -2,8 +2,11 @@
 // Part of the Core library - NO Windows UI dependencies allowed here
 #pragma once
 
+#include <array>
 #include <string>
 #include <chrono>
+#include <cstdint>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -16,9 +19,11 @@ struct FanState;
 // --- Event Types ---
 
 /// Event fired when sensor temperatures are updated
+/// The readings are shared and immutable: copying the event copies a pointer.
+/// Keep the pointer rather than the vector if the readings must outlive the call.
 struct TemperatureUpdateEvent {
     std::chrono::steady_clock::time_point timestamp;
-    std::vector<SensorReading> sensors;
+    std::shared_ptr<const std::vector<SensorReading>> sensors;
     int maxTempIndex;           // Index of the hottest sensor
     int maxTemp;                // Maximum temperature value
     std::string maxSensorName;  // Name of the hottest sensor
@@ -38,7 +43,9 @@ enum class ControlMode {
     BIOS = 1,       // Let BIOS control the fan
     Smart = 2,      // TPFanCtrl2 smart mode (temperature-based levels)
     Manual = 3,     // User-defined fixed speed
-    PID = 4         // PID controller mode
+    PID = 4,        // PID controller mode
+    MPC = 5,        // Model-predictive control on the identified thermal model
+    RPM = 6         // Hold a target fan RPM with the tach loop
 };
 
 struct ModeChangeEvent {
@@ -63,6 +70,56 @@ struct ErrorEvent {
     int errorCode;          // Optional platform-specific error code
 };
 
+/// Where a control cycle spends its time (see CycleProfiler)
+enum class CyclePhase {
+    SensorRead,         // Temperature registers
+    FanLevelRead,       // Fan control register read-back
+    TachRead,           // Fan speed registers
+    MaxTemp,            // Max-temp reduction and reading copy
+    ControlDecision,    // Control algorithm, excluding its EC writes
+    FanWrite,           // Fan level writes and verification
+    EventDispatch,      // Fan state and temperature events
+    Total,              // Whole cycle
+    Count
+};
+
+constexpr int kCyclePhaseCount = static_cast<int>(CyclePhase::Count);
+
+/// Latency distribution of one cycle phase (percentiles are bucket upper bounds)
+struct PhaseProfile {
+    uint64_t samples = 0;   // Cycles that ran the phase
+    uint32_t lastUs = 0;
+    uint32_t p50Us = 0;
+    uint32_t p99Us = 0;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+};
+
+/// EC traffic since start (ECManager counters)
+struct ECTrafficStats {
+    uint64_t bytesRead = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t timeouts = 0;      // Handshake waits that expired
+    uint64_t retries = 0;       // Transactions repeated after a failure
+    uint64_t typeSwitches = 0;  // Switches between EC port pairs
+};
+
+/// Cycle profile: per-phase histograms plus hot-path counters
+struct CycleProfile {
+    uint64_t cycles = 0;
+    std::array<PhaseProfile, kCyclePhaseCount> phases{};
+    uint64_t sampleRetries = 0; // Sensor/fan sample rounds repeated in UpdateSensors
+    ECTrafficStats ec;
+    
+    const PhaseProfile& operator[](CyclePhase phase) const { return phases[static_cast<int>(phase)]; }
+};
+
+/// Event fired after every control cycle with the updated profile
+struct CycleProfileEvent {
+    std::chrono::steady_clock::time_point timestamp;
+    CycleProfile profile;
+};
+
 /// Event fired for logging/tracing
 enum class LogLevel {
     Debug,
@@ -83,7 +140,8 @@ using ThermalEvent = std::variant<
     FanStateChangeEvent,
     ModeChangeEvent,
     ErrorEvent,
-    LogEvent
+    LogEvent,
+    CycleProfileEvent
 >;
 
 // --- Data Structures ---
@@ -104,11 +162,67 @@ struct FanState {
     int fan1Speed;          // RPM
     int fan2Speed;          // RPM
     int currentLevel;       // 0-7 or 0x80
+    int fan2Level;          // Last verified fan 2 level (-1 if unknown)
     bool isDualFan;         // Whether this is a dual-fan system
 };
 
+/// Counters of the fan ramp scheduler
+struct FanRampStats {
+    uint64_t requested = 0;         // Level changes asked for by the control algorithm
+    uint64_t issued = 0;            // Level changes passed on to the EC
+    uint64_t suppressed = 0;        // Requests held back (dwell, reversal, rate)
+    uint64_t reversalsCoalesced = 0; // Direction flips absorbed inside the reversal window
+    uint64_t emergencyBypasses = 0; // Requests passed unthrottled above the critical temperature
+};
+
+/// Fan commands that reached the EC vs. no-ops dropped against the shadow state
+struct FanCommandStats {
+    uint64_t issued = 0;
+    uint64_t suppressed = 0;
+};
+
+/// Exclusive time of each phase in one control cycle, as CycleProfiler
+/// measured it (0 for phases the cycle did not run)
+struct CyclePhaseTimes {
+    std::array<uint32_t, kCyclePhaseCount> us{};
+    
+    uint32_t operator[](CyclePhase phase) const { return us[static_cast<int>(phase)]; }
+    uint32_t TotalUs() const { return (*this)[CyclePhase::Total]; }
+};
+
+/// Deadline scheduler counters of the worker loop
+struct SchedulerStats {
+    static constexpr int kJitterBuckets = 8;
+    /// Upper bounds (exclusive) of the jitter buckets in µs; the last bucket is open
+    static constexpr std::array<uint32_t, kJitterBuckets - 1> kJitterBoundsUs{
+        100, 500, 1000, 5000, 10000, 50000, 100000};
+    
+    uint64_t cycles = 0;            // All cycles run
+    uint64_t forcedCycles = 0;      // Extra cycles triggered by a wakeup (not on the deadline grid)
+    uint64_t missedDeadlines = 0;   // Deadlines that passed while a scheduled cycle was still running
+    uint64_t overruns = 0;          // Cycles that took longer than the period
+    std::array<uint64_t, kJitterBuckets> jitterHistogram{}; // Scheduled cycle start minus deadline
+    uint32_t maxJitterUs = 0;
+    CyclePhaseTimes lastCycle;
+    CyclePhaseTimes worstCycle;     // Cycle with the largest total
+};
+
+/// Stalls of the control worker seen by the deadline watchdog
+struct WatchdogStats {
+    uint64_t trips = 0;             // Heartbeat deadlines missed (one per stall)
+    uint64_t failSafeWrites = 0;    // BIOS hand-backs that reached the EC
+    uint64_t failSafeFailures = 0;  // Fail-safe attempts the EC did not accept
+    uint32_t lastStallMs = 0;       // Missed deadline to recovery, last stall
+    uint32_t maxStallMs = 0;
+    uint64_t totalStallMs = 0;
+    bool stalled = false;           // A stall is in progress
+    uint64_t wakeups = 0;           // Deadline checks by the watchdog thread
+};
+
 /// Complete thermal system state (immutable snapshot)
 struct ThermalState {
+    uint64_t version = 0;   // Increments with every published snapshot
+    uint64_t configVersion = 0; // Configuration version the last cycle ran with
     std::chrono::steady_clock::time_point timestamp;
     std::vector<SensorReading> sensors;
     FanState fanState;
@@ -118,6 +232,11 @@ struct ThermalState {
     int maxTempIndex;
     bool isOperational;     // False if EC communication failed
     std::string lastError;
+    FanRampStats rampStats; // Summed over both fans
+    FanCommandStats fanCommands;
+    SchedulerStats scheduler;
+    WatchdogStats watchdog;
+    CycleProfile profile;   // Per-phase cycle timing and EC traffic
 };
 
 } // namespace Core
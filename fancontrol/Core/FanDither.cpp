@@ -0,0 +1,114 @@
+// Core/FanDither.cpp - Implementation of the sigma-delta fan level modulator
+#include "FanDither.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+
+namespace {
+
+constexpr float kMaxStepSeconds = 5.0f;  // Longest integration step
+
+} // namespace
+
+FanDither::FanDither(const Settings& settings)
+    : m_settings(settings)
+{
+}
+
+void FanDither::SetSettings(const Settings& settings) {
+    m_settings = settings;
+}
+
+void FanDither::Reset() {
+    m_accumulator = 0.0f;
+    m_sinceChange = 0.0f;
+    m_lastLevel = -1;
+    m_writeHead = 0;
+    m_writeCount = 0;
+}
+
+bool FanDither::HasWriteBudget() const {
+    int budget = std::clamp(m_settings.maxWritesPerMinute, 0, kMaxWriteHistory);
+    int recent = 0;
+    for (int i = 0; i < m_writeCount; i++) {
+        if (m_clock - m_writeTimes[i] < 60.0f) recent++;
+    }
+    return recent < budget;
+}
+
+void FanDither::RecordWrite() {
+    m_writeTimes[m_writeHead] = m_clock;
+    m_writeHead = (m_writeHead + 1) % kMaxWriteHistory;
+    if (m_writeCount < kMaxWriteHistory) m_writeCount++;
+    m_sinceChange = 0.0f;
+    m_issuedWrites++;
+}
+
+int FanDither::Update(float demand, int currentLevel, float dt) {
+    // The clocks follow wall time; only the integration step has the
+    // FanController::UpdatePIDControl limit, so a long gap can't flood the accumulator
+    const float elapsed = std::max(dt, 0.0f);
+    const float step = std::min(elapsed, kMaxStepSeconds);
+
+    m_clock += elapsed;
+    m_sinceChange += elapsed;
+
+    const int minLevel = m_settings.minLevel;
+    const int maxLevel = std::max(m_settings.maxLevel, minLevel);
+    demand = std::clamp(demand, (float)minLevel, (float)maxLevel);
+
+    const int lo = std::clamp((int)std::floor(demand), minLevel, maxLevel);
+    const int hi = std::min(lo + 1, maxLevel);
+
+    // Level changed behind our back (manual write, BIOS, fan feedback retry)
+    if (currentLevel != m_lastLevel) {
+        m_lastLevel = currentLevel;
+        m_sinceChange = 0.0f;
+    }
+
+    // BIOS control or unknown state: take over with the nearest level
+    if (currentLevel < minLevel || currentLevel > maxLevel) {
+        m_accumulator = 0.0f;
+        int target = (int)std::lround(demand);
+        RecordWrite();
+        m_lastLevel = target;
+        return target;
+    }
+
+    // Demand moved out of the band around the current level: follow at once
+    if (currentLevel < lo || currentLevel > hi) {
+        m_accumulator = 0.0f;
+        int target = (demand - lo < 0.5f) ? lo : hi;
+        RecordWrite();
+        m_lastLevel = target;
+        return target;
+    }
+
+    // Integrate what we failed to deliver. Bound it so a held-back toggle
+    // can't build up a debt that keeps the fan on the wrong level for long.
+    m_accumulator += (demand - (float)currentLevel) * step;
+    const float bound = std::max(m_settings.minDwellSeconds, step);
+    m_accumulator = std::clamp(m_accumulator, -bound, bound);
+
+    int desired = currentLevel;
+    if (hi != lo) {
+        if (currentLevel == lo && m_accumulator > 0.0f) desired = hi;
+        else if (currentLevel == hi && m_accumulator < 0.0f) desired = lo;
+    }
+
+    if (desired == currentLevel) {
+        return currentLevel;
+    }
+
+    if (m_sinceChange < m_settings.minDwellSeconds || !HasWriteBudget()) {
+        m_suppressedWrites++;
+        return currentLevel;
+    }
+
+    RecordWrite();
+    m_lastLevel = desired;
+    return desired;
+}
+
+} // namespace Core
@@ -0,0 +1,78 @@
+// Core/FanDither.h - Sigma-delta dithering between adjacent fan levels
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include <array>
+
+namespace Core {
+
+/// Rate limits and level range for FanDither
+struct FanDitherSettings {
+    float minDwellSeconds = 5.0f;   // Minimum hold time before the next toggle
+    int maxWritesPerMinute = 6;     // Budget for dither-induced level changes
+    int minLevel = 0;
+    int maxLevel = 7;
+};
+
+/// Turns a fractional fan demand (e.g. the raw PID output) into a sequence of
+/// integer EC levels whose time-average tracks the demand.
+///
+/// The EC only accepts levels 0-7, so a demand of 3.4 is realized by holding
+/// level 3 and level 4 for roughly 60% / 40% of the time. A first-order
+/// sigma-delta accumulator integrates the delivered error (in level-seconds)
+/// and picks the adjacent level that drives it back towards zero.
+///
+/// Dither toggles are rate-limited twice: each level is held for at least
+/// minDwellSeconds, and no more than maxWritesPerMinute toggles are issued in
+/// any sliding 60 s window. A demand that leaves the current level's band is
+/// always followed immediately (thermal safety before EC traffic).
+class FanDither {
+public:
+    using Settings = FanDitherSettings;
+
+    explicit FanDither(const Settings& settings = Settings());
+
+    /// Replace the settings. The accumulator is kept.
+    void SetSettings(const Settings& settings);
+    const Settings& GetSettings() const { return m_settings; }
+
+    /// Advance the modulator by dt seconds.
+    /// @param demand Fractional fan level requested by the control algorithm
+    /// @param currentLevel Level currently reported by the EC (>= 0x80 for BIOS)
+    /// @param dt Measured seconds since the previous call (<= 0: no time elapsed)
+    /// @return The level that should be commanded (== currentLevel for no change)
+    int Update(float demand, int currentLevel, float dt);
+
+    /// Clear the accumulator, dwell timer and write history
+    void Reset();
+
+    /// Integrated delivery error in level-seconds (positive: under-delivered)
+    float GetAccumulator() const { return m_accumulator; }
+
+    /// Number of level changes requested by this modulator
+    int GetIssuedWrites() const { return m_issuedWrites; }
+
+    /// Number of toggles held back by the dwell time or the write budget
+    int GetSuppressedWrites() const { return m_suppressedWrites; }
+
+private:
+    bool HasWriteBudget() const;
+    void RecordWrite();
+
+    Settings m_settings;
+
+    float m_accumulator{0.0f};
+    float m_clock{0.0f};            // Modulator time in seconds
+    float m_sinceChange{0.0f};      // Seconds since the level last changed
+    int m_lastLevel{-1};
+
+    static constexpr int kMaxWriteHistory = 64;
+    std::array<float, kMaxWriteHistory> m_writeTimes{};
+    int m_writeHead{0};
+    int m_writeCount{0};
+
+    int m_issuedWrites{0};
+    int m_suppressedWrites{0};
+};
+
+} // namespace Core
@@ -0,0 +1,132 @@
+// Core/FanMPC.cpp - Implementation of the model-predictive fan controller
+#include "FanMPC.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+
+void FanMPC::Reset() {
+    m_historyHead = 0;
+    m_historyCount = 0;
+    m_disturbance = 0.0f;
+    m_hasLastTemp = false;
+    m_predictedPeak = 0.0f;
+}
+
+void FanMPC::RecordLevel(int level) {
+    // Only changes need to be stored; LevelAt() holds the last one
+    if (m_historyCount > 0) {
+        int last = (m_historyHead + kMaxHistory - 1) % kMaxHistory;
+        if (m_historyLevel[last] == level) return;
+    }
+    m_historyTime[m_historyHead] = m_clock;
+    m_historyLevel[m_historyHead] = level;
+    m_historyHead = (m_historyHead + 1) % kMaxHistory;
+    if (m_historyCount < kMaxHistory) m_historyCount++;
+}
+
+int FanMPC::LevelAt(double time) const {
+    // Newest entry at or before time; older than the history: oldest entry
+    int index = (m_historyHead + kMaxHistory - 1) % kMaxHistory;
+    for (int i = 0; i < m_historyCount; i++) {
+        if (m_historyTime[index] <= time) return m_historyLevel[index];
+        if (i + 1 < m_historyCount) index = (index + kMaxHistory - 1) % kMaxHistory;
+    }
+    return m_historyLevel[index];
+}
+
+float FanMPC::EvaluatePlan(const ThermalModel& model, const MPCConfig& config, float temp,
+                           int currentLevel, int holdSteps, int level, float& peak) const {
+    const float step = config.horizonSeconds / kSteps;
+    const float target = config.targetTemp;
+
+    float cost = (level != currentLevel) ? config.writeCost : 0.0f;
+    peak = temp;
+    for (int n = 0; n < kSteps; n++) {
+        // The fan acting on the sensor now was commanded deadTime ago
+        float offset = n * step - model.deadTime;
+        int acting;
+        if (offset < -1e-3f) {
+            acting = LevelAt(m_clock + offset);
+        } else {
+            acting = ((int)(offset / step) < holdSteps) ? currentLevel : level;
+        }
+
+        temp = model.Predict(temp, (float)acting, step) + m_disturbance * step;
+        peak = std::max(peak, temp);
+
+        int commanded = (n < holdSteps) ? currentLevel : level;
+        float excess = std::max(0.0f, temp - target);
+        cost += (config.levelCost * commanded + config.overTempCost * excess * excess) * step;
+    }
+
+    // Where the final level settles beyond the horizon, weighted like a quarter horizon
+    float k = model.Cooling((float)level);
+    if (k > 0.0f) {
+        float settled = model.SteadyStateTemp((float)level) + m_disturbance / k;
+        float excess = std::max(0.0f, settled - target);
+        cost += config.overTempCost * excess * excess * config.horizonSeconds * 0.25f;
+    }
+    return cost;
+}
+
+int FanMPC::Update(const ThermalModel& model, const MPCConfig& config, float temp, int currentLevel, float dt) {
+    // dt <= 0: no time elapsed. Longer gaps than a cycle still advance the
+    // clock by the real time, so the dead-time replay stays on wall time.
+    const float elapsed = std::max(dt, 0.0f);
+
+    const int minLevel = std::clamp(config.minFan, 0, 7);
+    const int maxLevel = std::clamp(config.maxFan, minLevel, 7);
+    const bool numeric = currentLevel >= 0 && currentLevel <= 7;
+
+    // Disturbance observer: compare the measurement with the one-step prediction
+    if (m_hasLastTemp && m_historyCount > 0 && model.valid && elapsed > 0.0f) {
+        int acting = LevelAt(m_clock - model.deadTime);
+        float predicted = model.Predict(m_lastTemp, (float)acting, elapsed) + m_disturbance * elapsed;
+        m_disturbance += 0.05f * (temp - predicted) / elapsed;
+        m_disturbance = std::clamp(m_disturbance, -0.5f, 0.5f);
+    }
+    m_clock += elapsed;
+    m_lastTemp = temp;
+    m_hasLastTemp = true;
+
+    // Under BIOS control the history is meaningless: plan from the bottom of the range
+    int baseLevel = numeric ? std::clamp(currentLevel, minLevel, maxLevel) : minLevel;
+    if (!numeric) {
+        m_historyCount = 0;
+        m_historyHead = 0;
+    }
+    RecordLevel(baseLevel);
+
+    const int blocks = std::clamp(config.moveBlocks, 1, kMaxMoveBlocks);
+    const int blockSteps = std::max(1, kSteps / blocks);
+
+    float bestCost = 0.0f;
+    float bestPeak = temp;
+    int bestLevel = -1;
+    bool bestHolds = true;
+    for (int level = minLevel; level <= maxLevel; level++) {
+        // A move to the current level is the "hold" plan, evaluate it once
+        int firstBlock = (level == baseLevel) ? blocks - 1 : 0;
+        for (int b = firstBlock; b < blocks; b++) {
+            int holdSteps = (level == baseLevel) ? kSteps : b * blockSteps;
+            float peak;
+            float cost = EvaluatePlan(model, config, temp, baseLevel, holdSteps, level, peak);
+            if (!numeric && level != baseLevel) cost -= config.writeCost; // Taking over costs a write anyway
+            bool holds = holdSteps > 0;
+            if (bestLevel < 0 || cost < bestCost) {
+                bestCost = cost;
+                bestPeak = peak;
+                bestLevel = level;
+                bestHolds = holds;
+            }
+        }
+    }
+
+    m_predictedPeak = bestPeak;
+    int next = bestHolds ? baseLevel : bestLevel;
+    RecordLevel(next);
+    return next;
+}
+
+} // namespace Core
@@ -0,0 +1,72 @@
+// Core/FanMPC.h - Model-predictive fan level controller
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "SensorConfig.h"
+#include "ThermalModel.h"
+
+#include <array>
+
+namespace Core {
+
+/// Receding-horizon controller on an identified ThermalModel.
+///
+/// Every cycle it simulates the model over MPCConfig::horizonSeconds for a
+/// fixed set of candidate plans - "hold the current level until block b,
+/// then move to level L" - and commands the first step of the cheapest one.
+/// Cost is fan level x time, a fixed charge per level change, and a
+/// quadratic penalty for time spent above the target (plus the steady state
+/// the final level settles at, so the plan is not myopic).
+///
+/// The model's dead time is honoured by replaying the levels commanded in the
+/// past, and a disturbance estimate (measured vs. predicted temperature)
+/// absorbs load changes and model error, so the controller is offset-free.
+///
+/// The search is bounded (at most moveBlocks * 8 plans of kSteps steps) and
+/// uses only fixed-size storage, so Update() never allocates.
+class FanMPC {
+public:
+    static constexpr int kSteps = 12;           // Simulation steps per horizon
+    static constexpr int kMaxMoveBlocks = kSteps;
+
+    /// Plan one control cycle.
+    /// @param model Identified model of the controlled sensor (must be valid)
+    /// @param config Cost weights, horizon and level range
+    /// @param temp Measured temperature
+    /// @param currentLevel Level currently reported by the EC (>= 0x80 for BIOS)
+    /// @param dt Measured seconds since the previous call (<= 0: no time elapsed)
+    /// @return The level that should be commanded (== currentLevel for no change)
+    int Update(const ThermalModel& model, const MPCConfig& config, float temp, int currentLevel, float dt);
+
+    /// Forget the disturbance estimate and the level history
+    void Reset();
+
+    /// Unmodelled heating in °C/s (positive: hotter than the model predicts)
+    float GetDisturbance() const { return m_disturbance; }
+
+    /// Highest temperature of the chosen plan
+    float GetPredictedPeak() const { return m_predictedPeak; }
+
+private:
+    /// Level that was commanded at the given modulator time
+    int LevelAt(double time) const;
+    void RecordLevel(int level);
+
+    /// Cost of holding currentLevel for holdSteps, then switching to level
+    float EvaluatePlan(const ThermalModel& model, const MPCConfig& config, float temp,
+                       int currentLevel, int holdSteps, int level, float& peak) const;
+
+    static constexpr int kMaxHistory = 32;
+    std::array<double, kMaxHistory> m_historyTime{};
+    std::array<int, kMaxHistory> m_historyLevel{};
+    int m_historyHead{0};
+    int m_historyCount{0};
+
+    double m_clock{0.0};
+    float m_disturbance{0.0f};
+    float m_lastTemp{0.0f};
+    bool m_hasLastTemp{false};
+    float m_predictedPeak{0.0f};
+};
+
+} // namespace Core
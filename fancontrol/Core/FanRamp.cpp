@@ -0,0 +1,69 @@
+// Core/FanRamp.cpp - Implementation of the fan ramp scheduler
+#include "FanRamp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Core {
+
+FanRamp::FanRamp(const FanRampConfig& config)
+    : m_config(config)
+{
+    // Nothing in the history yet: the first change is never held by the dwell time
+    m_sinceChange = m_config.minDwell;
+}
+
+void FanRamp::Reset() {
+    m_sinceChange = m_config.minDwell;
+    m_lastDirection = 0;
+}
+
+int FanRamp::Issue(int level, int currentLevel) {
+    m_stats.issued++;
+    if (level != currentLevel) {
+        m_lastDirection = (level > currentLevel) ? 1 : -1;
+    }
+    m_sinceChange = 0.0f;
+    return level;
+}
+
+int FanRamp::Schedule(int requested, int currentLevel, int maxTemp, float dt) {
+    // Called every cycle, so the dwell and reversal timers follow elapsed time
+    if (dt < 0.0f) dt = 0.0f;
+    m_sinceChange += dt;
+
+    if (requested == currentLevel) {
+        return currentLevel;
+    }
+    m_stats.requested++;
+
+    auto isStep = [](int level) { return level >= 0 && level <= 7; };
+    if (!m_config.enabled || !isStep(requested) || !isStep(currentLevel)) {
+        return Issue(requested, currentLevel);
+    }
+
+    if (maxTemp >= m_config.criticalTemp) {
+        m_stats.emergencyBypasses++;
+        return Issue(requested, currentLevel);
+    }
+
+    if (m_sinceChange < m_config.minDwell) {
+        m_stats.suppressed++;
+        return currentLevel;
+    }
+
+    const int direction = (requested > currentLevel) ? 1 : -1;
+    if (m_lastDirection != 0 && direction != m_lastDirection &&
+        m_sinceChange < m_config.reversalWindow) {
+        m_stats.reversalsCoalesced++;
+        m_stats.suppressed++;
+        return currentLevel;
+    }
+
+    const float rate = (direction > 0) ? m_config.upRate : m_config.downRate;
+    const int maxStep = (std::max)(1, (int)std::floor(rate * dt));
+    const int step = (std::min)(std::abs(requested - currentLevel), maxStep);
+    return Issue(currentLevel + direction * step, currentLevel);
+}
+
+} // namespace Core
@@ -0,0 +1,50 @@
+// Core/FanRamp.h - Slew-rate limiter and ramp scheduler for fan levels
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+#include "SensorConfig.h"
+
+namespace Core {
+
+/// Sits between a control algorithm and FanController and decides which of
+/// the requested level changes actually reach the EC.
+///
+/// - Each level is held for at least minDwell seconds.
+/// - A change moves at most upRate/downRate levels per second (at least one).
+/// - A request that reverses the previous change within reversalWindow is
+///   held, so a short spike doesn't cost a 0 -> 7 -> 0 round trip.
+/// - At or above criticalTemp every request passes through unthrottled.
+///
+/// BIOS control (0x80) and other non-numeric levels always pass through.
+class FanRamp {
+public:
+    explicit FanRamp(const FanRampConfig& config = FanRampConfig());
+
+    void SetConfig(const FanRampConfig& config) { m_config = config; }
+
+    /// Schedule a requested level. Call it every control cycle, with
+    /// requested == currentLevel when nothing changes, so the timers advance.
+    /// @param requested Level chosen by the control algorithm
+    /// @param currentLevel Level currently applied to the fan
+    /// @param maxTemp Current maximum temperature (for the emergency bypass)
+    /// @param dt Seconds since the previous call
+    /// @return Level to write now (== currentLevel for no write)
+    int Schedule(int requested, int currentLevel, int maxTemp, float dt);
+
+    /// Forget dwell and direction history
+    void Reset();
+
+    const FanRampStats& GetStats() const { return m_stats; }
+
+private:
+    int Issue(int level, int currentLevel);
+
+    FanRampConfig m_config;
+    FanRampStats m_stats;
+
+    float m_sinceChange{0.0f};
+    int m_lastDirection{0};     // +1 up, -1 down, 0 none yet
+};
+
+} // namespace Core
@@ -0,0 +1,125 @@
+// Core/FanRpmController.cpp - Implementation of the RPM target controller
+#include "FanRpmController.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+
+namespace {
+
+constexpr float kLearnRate = 0.2f;  // Weight of a new tach sample in the per-level average
+
+} // namespace
+
+void FanRpmController::SetConfig(const FanRpmConfig& config) {
+    m_config = config;
+    m_dither.SetSettings({
+        .minDwellSeconds = config.minDwellSeconds,
+        .maxWritesPerMinute = config.maxWritesPerMin,
+        .minLevel = 0,
+        .maxLevel = kLevels - 1
+    });
+}
+
+void FanRpmController::Reset() {
+    m_dither.Reset();
+    m_lastLevel = -1;
+    m_sinceChange = 0.0f;
+}
+
+void FanRpmController::ResetCurve() {
+    m_rpm.fill(0.0f);
+    m_samples.fill(0);
+}
+
+std::array<float, FanRpmController::kLevels> FanRpmController::BuildCurve() const {
+    std::array<float, kLevels> curve{};
+    for (int i = 0; i < kLevels; i++) {
+        if (m_samples[i] > 0) {
+            curve[i] = m_rpm[i];
+            continue;
+        }
+        int lo = i - 1, hi = i + 1;
+        while (lo >= 0 && m_samples[lo] == 0) lo--;
+        while (hi < kLevels && m_samples[hi] == 0) hi++;
+
+        if (lo >= 0 && hi < kLevels) {
+            float t = (float)(i - lo) / (float)(hi - lo);
+            curve[i] = m_rpm[lo] + (m_rpm[hi] - m_rpm[lo]) * t;
+        } else if (lo >= 0) {
+            curve[i] = m_rpm[lo] + (i - lo) * kDefaultRpmPerLevel;
+        } else if (hi < kLevels) {
+            curve[i] = std::max(0.0f, m_rpm[hi] - (hi - i) * kDefaultRpmPerLevel);
+        } else {
+            curve[i] = i * kDefaultRpmPerLevel;
+        }
+    }
+
+    // Tach noise must not make a higher level look slower
+    for (int i = 1; i < kLevels; i++) curve[i] = std::max(curve[i], curve[i - 1]);
+    return curve;
+}
+
+float FanRpmController::EstimateRpm(int level) const {
+    if (level < 0 || level >= kLevels) return 0.0f;
+    return BuildCurve()[level];
+}
+
+int FanRpmController::Update(int targetRpm, int measuredRpm, int currentLevel, float dt) {
+    if (dt <= 0.0f) dt = 0.0f;
+    m_sinceChange += dt;
+
+    if (currentLevel != m_lastLevel) {
+        m_lastLevel = currentLevel;
+        m_sinceChange = 0.0f;
+    }
+
+    const bool numeric = currentLevel >= 0 && currentLevel < kLevels;
+
+    // Learn the curve only from a fan that had time to spin up or down
+    if (numeric && measuredRpm >= 0 && m_sinceChange >= m_config.settleSeconds) {
+        float& rpm = m_rpm[currentLevel];
+        rpm = (m_samples[currentLevel] == 0) ? (float)measuredRpm
+                                             : rpm + kLearnRate * ((float)measuredRpm - rpm);
+        m_samples[currentLevel]++;
+    }
+
+    const auto curve = BuildCurve();
+    const float target = (float)std::max(targetRpm, 0);
+
+    // Current level is close enough: no EC traffic at all
+    if (numeric && std::abs(curve[currentLevel] - target) <= (float)m_config.toleranceRpm) {
+        return currentLevel;
+    }
+
+    // Position of the target on the curve as a fractional level
+    float demand = 0.0f;
+    if (target >= curve[kLevels - 1]) {
+        demand = (float)(kLevels - 1);
+    } else {
+        for (int i = 0; i + 1 < kLevels; i++) {
+            if (target >= curve[i] && target < curve[i + 1]) {
+                demand = i + (target - curve[i]) / (curve[i + 1] - curve[i]);
+                break;
+            }
+        }
+    }
+
+    int level;
+    if (m_config.dither) {
+        level = m_dither.Update(demand, currentLevel, dt);
+    } else {
+        level = (int)std::lround(demand);
+        if (numeric && level != currentLevel && m_sinceChange < m_config.minDwellSeconds) {
+            level = currentLevel;
+        }
+    }
+
+    if (level != currentLevel) {
+        m_lastLevel = level;
+        m_sinceChange = 0.0f;
+    }
+    return level;
+}
+
+} // namespace Core
@@ -0,0 +1,68 @@
+// Core/FanRpmController.h - Tach-based closed-loop RPM target control
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "SensorConfig.h"
+#include "FanDither.h"
+
+#include <array>
+
+namespace Core {
+
+/// Holds a requested fan RPM by choosing (or dithering between) EC levels.
+///
+/// The RPM a level produces varies per machine, dust and fan age, so the
+/// controller learns the level -> RPM curve at runtime: every tach sample taken
+/// after the fan had settleSeconds on the same level updates a moving average
+/// for that level. Levels not yet seen are interpolated from their learned
+/// neighbours (with kDefaultRpmPerLevel as the slope), and the curve is made
+/// monotonic before use.
+///
+/// The target maps to a fractional level on that curve. With dithering the
+/// fraction is realized by FanDither (dwell + write budget); without it the
+/// nearest level is used. Either way the current level is kept while its
+/// learned RPM is within toleranceRpm of the target.
+class FanRpmController {
+public:
+    static constexpr int kLevels = 8;
+    static constexpr float kDefaultRpmPerLevel = 600.0f;
+
+    void SetConfig(const FanRpmConfig& config);
+
+    /// Process one tach sample.
+    /// @param targetRpm Requested fan speed
+    /// @param measuredRpm Tach reading of fan 1
+    /// @param currentLevel Level currently reported by the EC (>= 0x80 for BIOS)
+    /// @param dt Seconds since the previous sample
+    /// @return The level that should be commanded (== currentLevel for no change)
+    int Update(int targetRpm, int measuredRpm, int currentLevel, float dt);
+
+    /// Learned or interpolated RPM of a level
+    float EstimateRpm(int level) const;
+
+    /// Whether the level has been measured at least once
+    bool IsLearned(int level) const {
+        return level >= 0 && level < kLevels && m_samples[level] > 0;
+    }
+
+    /// Clear the dwell and dither state; the learned curve is kept
+    void Reset();
+
+    /// Forget the learned curve
+    void ResetCurve();
+
+private:
+    /// Monotonic RPM estimate of every level
+    std::array<float, kLevels> BuildCurve() const;
+
+    FanRpmConfig m_config;
+    FanDither m_dither;
+
+    std::array<float, kLevels> m_rpm{};
+    std::array<int, kLevels> m_samples{};
+
+    int m_lastLevel{-1};
+    float m_sinceChange{0.0f};
+};
+
+} // namespace Core
@@ -0,0 +1,63 @@
+// Core/FanZone.cpp - Implementation of per-fan control zones
+#include "FanZone.h"
+#include <algorithm>
+
+namespace Core {
+
+int FanZone::ComputeZoneTemp(const FanZoneConfig& config,
+                             const std::vector<SensorReading>& sensors,
+                             const std::string& ignoreList) {
+    auto isUsable = [](const SensorReading& r) {
+        return r.isAvailable && r.rawTemp > 0 && r.rawTemp < 128;
+    };
+
+    int maxTemp = 0;
+    if (config.sensorIndices.empty()) {
+        const std::string searchList = " " + ignoreList + " ";
+        for (const auto& r : sensors) {
+            if (!isUsable(r)) continue;
+            if (!r.name.empty() && searchList.find(" " + r.name + " ") != std::string::npos) continue;
+            maxTemp = (std::max)(maxTemp, (int)(r.biasedTemp * r.weight));
+        }
+        return maxTemp;
+    }
+
+    // Explicitly assigned sensors are used even if globally ignored
+    for (int index : config.sensorIndices) {
+        if (index < 0 || index >= (int)sensors.size()) continue;
+        const auto& r = sensors[index];
+        if (!isUsable(r)) continue;
+        maxTemp = (std::max)(maxTemp, (int)(r.biasedTemp * r.weight));
+    }
+    return maxTemp;
+}
+
+int FanZone::Evaluate(const FanZoneConfig& config, const SmartLevelTable* profile,
+                      int zoneTemp, int currentLevel, float dt) {
+    if (config.usePID) {
+        PIDSettings settings{
+            .targetTemp = config.pid.targetTemp,
+            .Kp = config.pid.Kp,
+            .Ki = config.pid.Ki,
+            .Kd = config.pid.Kd,
+            .minFan = static_cast<float>(config.pid.minFan),
+            .maxFan = static_cast<float>(config.pid.maxFan)
+        };
+        float output = FanController::ComputePIDOutput(m_pid, static_cast<float>(zoneTemp), settings, dt);
+        return FanController::MapPIDOutputToLevel(output, currentLevel, settings);
+    }
+
+    if (!profile || profile->IsEmpty()) return currentLevel;
+    return profile->Request(zoneTemp, currentLevel, m_smart);
+}
+
+void FanZone::Confirm(const SmartLevelTable* profile, int appliedLevel) {
+    if (profile) profile->Confirm(appliedLevel, m_smart);
+}
+
+void FanZone::Reset() {
+    m_smart.Reset();
+    m_pid = PIDState{};
+}
+
+} // namespace Core
@@ -0,0 +1,49 @@
+// Core/FanZone.h - Per-fan control zone for dual-fan machines
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+#include "SensorConfig.h"
+#include "SmartLevelTable.h"
+#include "../FanController.h"
+
+#include <string>
+#include <vector>
+
+namespace Core {
+
+/// Decision state for one fan of a dual-fan machine.
+/// Each zone watches its own sensor subset and runs either a smart profile
+/// or a PID loop, keeping its own hysteresis and integrator state. The zone
+/// only decides; ThermalManager batches both zones into one SetFanLevels().
+class FanZone {
+public:
+    /// Hottest weighted temperature among the zone's sensors.
+    /// An empty sensor list means every sensor not in ignoreList.
+    static int ComputeZoneTemp(const FanZoneConfig& config,
+                               const std::vector<SensorReading>& sensors,
+                               const std::string& ignoreList);
+
+    /// Decide the level for this fan
+    /// @param config Zone configuration
+    /// @param profile Compiled smart profile of the zone (unused for PID zones)
+    /// @param zoneTemp Output of ComputeZoneTemp()
+    /// @param currentLevel Last verified level of this fan
+    /// @param dt Seconds since the previous cycle
+    /// @return Level to command (== currentLevel for no change)
+    int Evaluate(const FanZoneConfig& config, const SmartLevelTable* profile,
+                 int zoneTemp, int currentLevel, float dt);
+
+    /// Report the level now on this fan (after the ramp and the write), so
+    /// smart hysteresis only advances once a requested level is reached
+    void Confirm(const SmartLevelTable* profile, int appliedLevel);
+
+    /// Forget hysteresis and integrator state (e.g. after a mode change)
+    void Reset();
+
+private:
+    SmartLevelState m_smart;
+    PIDState m_pid;
+};
+
+} // namespace Core
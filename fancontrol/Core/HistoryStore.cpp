@@ -0,0 +1,177 @@
+// Core/HistoryStore.cpp - Implementation of the temperature history store
+#include "HistoryStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+namespace Core {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x48465054;  // "TPFH"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 256;
+
+size_t RingValues(int tier) {
+    return 2 * (size_t)HistoryStore::kTiers[tier].capacity;
+}
+
+size_t TierOffset(int tier) {
+    size_t offset = 0;
+    for (int t = 0; t < tier; t++) offset += RingValues(t) * HistoryStore::kSensors;
+    return offset;
+}
+
+} // namespace
+
+struct HistoryStore::FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sensors;
+    uint32_t tiers;
+    HistoryTierSpec specs[kHistoryTierCount];
+};
+
+struct HistoryStore::RingState {
+    int64_t bucket;     // Bucket index (unixMs / resolution) of the newest value
+    uint32_t head;      // Slot of the newest value
+    uint32_t count;     // Valid values, at most the capacity
+    double sum;         // Samples accumulated in the newest bucket
+    uint32_t samples;
+    uint32_t reserved;
+};
+
+size_t HistoryStore::StorageSize() {
+    return kHeaderSize + sizeof(RingState) * kHistoryTierCount * kSensors
+         + TierOffset(kHistoryTierCount) * sizeof(float);
+}
+
+HistoryStore::HistoryStore(const std::string& path) {
+    const size_t size = StorageSize();
+    if (!path.empty() && m_file.Open(path, size)) {
+        Attach(m_file.Data());
+    } else {
+        m_memory = std::make_unique<uint64_t[]>((size + 7) / 8);
+        Attach(m_memory.get());
+        Reset();
+    }
+}
+
+HistoryStore::~HistoryStore() {
+    m_file.Close();
+}
+
+void HistoryStore::Attach(void* base) {
+    static_assert(sizeof(FileHeader) <= kHeaderSize);
+
+    auto* bytes = static_cast<uint8_t*>(base);
+    m_header = reinterpret_cast<FileHeader*>(bytes);
+    m_rings = reinterpret_cast<RingState*>(bytes + kHeaderSize);
+    m_data = reinterpret_cast<float*>(bytes + kHeaderSize + sizeof(RingState) * kHistoryTierCount * kSensors);
+
+    bool valid = m_header->magic == kMagic && m_header->version == kVersion
+              && m_header->sensors == (uint32_t)kSensors && m_header->tiers == (uint32_t)kHistoryTierCount;
+    for (int t = 0; valid && t < kHistoryTierCount; t++) {
+        valid = m_header->specs[t].resolutionMs == kTiers[t].resolutionMs
+             && m_header->specs[t].capacity == kTiers[t].capacity;
+    }
+    if (!valid) {
+        Reset();
+        return;
+    }
+
+    // A torn write (crash mid-update) must not send a reader out of bounds
+    for (int t = 0; t < kHistoryTierCount; t++) {
+        for (int s = 0; s < kSensors; s++) {
+            RingState& ring = Ring(t, s);
+            if (ring.head >= kTiers[t].capacity || ring.count > kTiers[t].capacity) ring = {};
+        }
+    }
+}
+
+void HistoryStore::Reset() {
+    std::memset(m_header, 0, kHeaderSize);
+    std::memset(m_rings, 0, sizeof(RingState) * kHistoryTierCount * kSensors);
+    m_header->magic = kMagic;
+    m_header->version = kVersion;
+    m_header->sensors = kSensors;
+    m_header->tiers = kHistoryTierCount;
+    for (int t = 0; t < kHistoryTierCount; t++) m_header->specs[t] = kTiers[t];
+}
+
+HistoryStore::RingState& HistoryStore::Ring(int tier, int sensor) const {
+    return m_rings[tier * kSensors + sensor];
+}
+
+float* HistoryStore::Data(int tier, int sensor) const {
+    return m_data + TierOffset(tier) + RingValues(tier) * sensor;
+}
+
+void HistoryStore::Append(RingState& ring, float* data, uint32_t capacity, float value) {
+    ring.head = (ring.count == 0) ? 0 : (ring.head + 1) % capacity;
+    data[ring.head] = value;
+    data[ring.head + capacity] = value;
+    ring.count = std::min(ring.count + 1, capacity);
+}
+
+void HistoryStore::Push(int sensor, int64_t unixMs, float value) {
+    if (sensor < 0 || sensor >= kSensors || unixMs < 0) return;
+
+    std::unique_lock lock(m_mutex);
+    for (int t = 0; t < kHistoryTierCount; t++) {
+        const HistoryTierSpec& spec = kTiers[t];
+        RingState& ring = Ring(t, sensor);
+        float* data = Data(t, sensor);
+        const int64_t bucket = unixMs / spec.resolutionMs;
+
+        if (ring.count > 0 && bucket == ring.bucket) {
+            ring.sum += value;
+            ring.samples++;
+            float average = (float)(ring.sum / ring.samples);
+            data[ring.head] = average;
+            data[ring.head + spec.capacity] = average;
+            continue;
+        }
+        if (ring.count > 0 && bucket < ring.bucket) continue;  // Clock stepped back
+
+        if (ring.count > 0) {
+            const int64_t missing = bucket - ring.bucket - 1;
+            const float fill = (missing * spec.resolutionMs <= kMaxHoldMs)
+                ? data[ring.head] : std::numeric_limits<float>::quiet_NaN();
+            for (int64_t i = 0; i < std::min<int64_t>(missing, spec.capacity); i++) {
+                Append(ring, data, spec.capacity, fill);
+            }
+        }
+        Append(ring, data, spec.capacity, value);
+        ring.bucket = bucket;
+        ring.sum = value;
+        ring.samples = 1;
+    }
+}
+
+void HistoryStore::Flush() {
+    std::shared_lock lock(m_mutex);
+    m_file.Flush();
+}
+
+std::span<const float> HistoryStore::Reader::Series(HistoryTier tier, int sensor) const {
+    const int t = (int)tier;
+    if (t < 0 || t >= kHistoryTierCount || sensor < 0 || sensor >= kSensors) return {};
+
+    const RingState& ring = m_store.Ring(t, sensor);
+    const uint32_t capacity = kTiers[t].capacity;
+    const uint32_t start = (ring.head + capacity - ring.count + 1) % capacity;
+    return { m_store.Data(t, sensor) + start, ring.count };
+}
+
+int64_t HistoryStore::Reader::NewestTime(HistoryTier tier, int sensor) const {
+    const int t = (int)tier;
+    if (t < 0 || t >= kHistoryTierCount || sensor < 0 || sensor >= kSensors) return 0;
+
+    const RingState& ring = m_store.Ring(t, sensor);
+    return ring.count > 0 ? ring.bucket * kTiers[t].resolutionMs : 0;
+}
+
+} // namespace Core
@@ -0,0 +1,110 @@
+// Core/HistoryStore.h - Persistent multi-resolution temperature history
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "MappedFile.h"
+#include "SensorConfig.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <span>
+#include <string>
+
+namespace Core {
+
+/// Resolution tiers of the history, finest first
+enum class HistoryTier { Seconds, TenSeconds, Minutes, Count };
+
+constexpr int kHistoryTierCount = (int)HistoryTier::Count;
+
+struct HistoryTierSpec {
+    int64_t resolutionMs;
+    uint32_t capacity;
+};
+
+/// Fixed-size temperature history of every sensor slot, kept in three tiers
+/// (1 s for an hour, 10 s for a day, 1 min for a week).
+///
+/// Each tier holds one ring per sensor index. A sample lands in the bucket of
+/// its wall-clock time; the newest bucket shows the running average of its
+/// samples. Missing buckets are filled with the last value for short gaps and
+/// with NaN for longer ones (app not running, sensor gone), so the series
+/// always has one value per bucket.
+///
+/// Rings store every value twice (at i and i + capacity), which keeps the
+/// valid window one contiguous range: readers get a std::span straight into
+/// the storage instead of a copy. The storage is a memory-mapped file when a
+/// path is given, so the history survives restarts; a file written with a
+/// different layout is reset.
+class HistoryStore {
+public:
+    static constexpr int kSensors = SensorAddresses::TOTAL_COUNT;
+    static constexpr std::array<HistoryTierSpec, kHistoryTierCount> kTiers{{
+        {1000, 3600},      // 1 h
+        {10000, 8640},     // 24 h
+        {60000, 10080}     // 7 days
+    }};
+    static constexpr int64_t kMaxHoldMs = 30000;  // Longer gaps read as NaN
+
+    /// Open (or create) the backing file; an empty path or a file that
+    /// cannot be mapped keeps the history in memory only
+    explicit HistoryStore(const std::string& path = "");
+    ~HistoryStore();
+
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    /// Whether the history is backed by a file
+    bool IsPersistent() const { return m_file.IsOpen(); }
+
+    /// Add a sample of a sensor slot
+    /// @param unixMs Wall-clock time; samples older than the newest bucket are dropped
+    void Push(int sensor, int64_t unixMs, float value);
+
+    /// Schedule dirty pages for writing (also done on destruction)
+    void Flush();
+
+    /// Shared-locked view of the history. Spans stay valid while the reader
+    /// lives; writers wait for it, so keep it for one frame at most.
+    class Reader {
+    public:
+        /// Values oldest to newest, one per bucket of the tier (NaN in gaps)
+        std::span<const float> Series(HistoryTier tier, int sensor) const;
+
+        /// Start of the newest bucket in unix ms, 0 if the series is empty
+        int64_t NewestTime(HistoryTier tier, int sensor) const;
+
+    private:
+        friend class HistoryStore;
+        explicit Reader(const HistoryStore& store) : m_store(store), m_lock(store.m_mutex) {}
+
+        const HistoryStore& m_store;
+        std::shared_lock<std::shared_mutex> m_lock;
+    };
+
+    Reader Read() const { return Reader(*this); }
+
+private:
+    struct FileHeader;
+    struct RingState;
+
+    void Attach(void* base);
+    void Reset();
+    RingState& Ring(int tier, int sensor) const;
+    float* Data(int tier, int sensor) const;
+    static void Append(RingState& ring, float* data, uint32_t capacity, float value);
+
+    static size_t StorageSize();
+
+    MappedFile m_file;
+    std::unique_ptr<uint64_t[]> m_memory;  // Used when there is no file
+    FileHeader* m_header{nullptr};
+    RingState* m_rings{nullptr};
+    float* m_data{nullptr};
+
+    mutable std::shared_mutex m_mutex;
+};
+
+} // namespace Core
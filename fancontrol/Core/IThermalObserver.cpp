@@ -0,0 +1,266 @@
+// Core/IThermalObserver.cpp - Implementation of the event dispatcher
+#include "IThermalObserver.h"
+#include <algorithm>
+
+namespace Core {
+
+/// Bounded ring of pending events of one async subscriber
+struct EventDispatcher::AsyncQueue {
+    using Clock = std::chrono::steady_clock;
+
+    struct Pending {
+        ThermalEvent event;
+        Clock::time_point queued;
+    };
+
+    explicit AsyncQueue(const EventDeliveryOptions& opts)
+        : options(opts), ring(std::max<size_t>(opts.queueCapacity, 1)) {}
+
+    const EventDeliveryOptions options;
+
+    std::mutex mutex;                   // Guards the ring; never held during a callback
+    std::condition_variable notFull;    // Producers waiting under EventOverflowPolicy::Block
+    std::vector<Pending> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+    std::mutex deliveryMutex;           // Held while the callback runs
+    std::atomic<bool> closed{false};
+
+    size_t maxQueued = 0;               // Protected by mutex
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> coalesced{0};
+    std::atomic<uint32_t> lastLagUs{0};
+    std::atomic<uint32_t> maxLagUs{0};
+};
+
+EventDispatcher::EventDispatcher()
+    : m_subscribers(std::make_shared<const SubscriberList>())
+{
+}
+
+EventDispatcher::~EventDispatcher() {
+    if (m_deliveryThread.joinable()) {
+        m_deliveryThread.request_stop();
+        m_deliveryThread.join();
+    }
+}
+
+EventDispatcher::SubscriptionId EventDispatcher::Subscribe(Callback callback, const EventDeliveryOptions& options) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    SubscriptionId id = m_nextId++;
+    std::shared_ptr<AsyncQueue> queue;
+    if (options.async) {
+        queue = std::make_shared<AsyncQueue>(options);
+        if (!m_deliveryThread.joinable()) {
+            m_deliveryThread = std::jthread([this](std::stop_token token) { DeliveryLoop(token); });
+        }
+    }
+    auto subscribers = m_subscribers.load()->all;
+    subscribers.push_back({id, options.events & AllEvents, std::move(callback), std::move(queue)});
+    Publish(std::move(subscribers));
+    return id;
+}
+
+EventDispatcher::SubscriptionId EventDispatcher::Subscribe(std::weak_ptr<IThermalObserver> observer,
+                                                           const EventDeliveryOptions& options) {
+    return Subscribe([observer](const ThermalEvent& event) {
+        if (auto obs = observer.lock()) {
+            obs->OnThermalEvent(event);
+        }
+    }, options);
+}
+
+void EventDispatcher::Unsubscribe(SubscriptionId id) {
+    std::shared_ptr<AsyncQueue> queue;
+    std::thread::id deliveryThread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        deliveryThread = m_deliveryThread.get_id();
+        auto subscribers = m_subscribers.load()->all;
+        auto it = std::find_if(subscribers.begin(), subscribers.end(),
+                               [id](const Subscriber& s) { return s.id == id; });
+        if (it == subscribers.end()) return;
+        queue = std::move(it->queue);
+        subscribers.erase(it);
+        Publish(std::move(subscribers));
+    }
+    if (queue) Close(*queue, deliveryThread);
+}
+
+void EventDispatcher::Clear() {
+    std::shared_ptr<const SubscriberList> old;
+    std::thread::id deliveryThread;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        deliveryThread = m_deliveryThread.get_id();
+        old = m_subscribers.load();
+        Publish({});
+    }
+    for (const auto& subscriber : old->all) {
+        if (subscriber.queue) Close(*subscriber.queue, deliveryThread);
+    }
+}
+
+void EventDispatcher::Publish(std::vector<Subscriber> subscribers) {
+    auto list = std::make_shared<SubscriberList>();
+    list->all = std::move(subscribers);
+    uint32_t listening = 0;
+    for (const auto& subscriber : list->all) {
+        listening |= subscriber.events;
+        for (size_t type = 0; type < EventTypeCount; type++) {
+            if (subscriber.events & (1u << type)) list->byType[type].push_back(&subscriber);
+        }
+    }
+    m_listening.store(listening, std::memory_order_release);
+    m_subscribers.store(std::move(list));
+}
+
+void EventDispatcher::Close(AsyncQueue& queue, std::thread::id deliveryThread) {
+    {
+        // Under the ring lock, so a producer about to wait under Block sees it
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.closed = true;
+    }
+    queue.notFull.notify_all();
+    // Wait for a callback in progress, unless we are that callback
+    if (std::this_thread::get_id() != deliveryThread) {
+        std::lock_guard<std::mutex> lock(queue.deliveryMutex);
+    }
+}
+
+void EventDispatcher::Dispatch(const ThermalEvent& event) {
+    const size_t type = event.index();
+    if ((m_listening.load(std::memory_order_acquire) & (1u << type)) == 0) return;
+
+    auto list = m_subscribers.load();
+    bool queued = false;
+    for (const Subscriber* subscriber : list->byType[type]) {
+        if (subscriber->queue) {
+            Enqueue(*subscriber->queue, event);
+            queued = true;
+        } else {
+            subscriber->callback(event);
+        }
+    }
+    if (queued) {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_pending = true;
+        }
+        m_wakeCv.notify_one();
+    }
+}
+
+void EventDispatcher::Enqueue(AsyncQueue& queue, const ThermalEvent& event) {
+    const size_t capacity = queue.ring.size();
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    if (queue.closed) return;
+
+    if (queue.count == capacity) {
+        switch (queue.options.overflow) {
+            case EventOverflowPolicy::CoalesceLatest:
+                for (size_t i = queue.count; i-- > 0;) {
+                    auto& pending = queue.ring[(queue.head + i) % capacity];
+                    if (pending.event.index() == event.index()) {
+                        // Keep the original enqueue time: the consumer is that far behind
+                        pending.event = event;
+                        queue.coalesced++;
+                        return;
+                    }
+                }
+                break;
+            case EventOverflowPolicy::Block:
+                queue.notFull.wait_for(lock, queue.options.blockTimeout, [&] {
+                    return queue.count < capacity || queue.closed;
+                });
+                if (queue.closed) return;
+                break;
+            case EventOverflowPolicy::DropOldest:
+                break;
+        }
+        if (queue.count == capacity) {
+            queue.ring[queue.head].event = {};
+            queue.head = (queue.head + 1) % capacity;
+            queue.count--;
+            queue.dropped++;
+        }
+    }
+
+    auto& slot = queue.ring[(queue.head + queue.count) % capacity];
+    slot.event = event;
+    slot.queued = AsyncQueue::Clock::now();
+    queue.count++;
+    queue.maxQueued = std::max(queue.maxQueued, queue.count);
+}
+
+void EventDispatcher::DeliveryLoop(std::stop_token stopToken) {
+    while (!stopToken.stop_requested()) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            if (!m_wakeCv.wait(lock, stopToken, [this] { return m_pending; })) break;
+            m_pending = false;
+        }
+
+        // One event per subscriber per round, until every queue is empty
+        auto list = m_subscribers.load();
+        bool more = true;
+        while (more && !stopToken.stop_requested()) {
+            more = false;
+            for (const auto& subscriber : list->all) {
+                if (!subscriber.queue) continue;
+                auto& queue = *subscriber.queue;
+
+                AsyncQueue::Pending item;
+                {
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.count == 0) continue;
+                    auto& slot = queue.ring[queue.head];
+                    item.event = std::move(slot.event);
+                    item.queued = slot.queued;
+                    slot.event = {};  // Release shared payloads held by the slot
+                    queue.head = (queue.head + 1) % queue.ring.size();
+                    queue.count--;
+                    more |= queue.count > 0;
+                }
+                queue.notFull.notify_one();
+
+                std::lock_guard<std::mutex> lock(queue.deliveryMutex);
+                if (queue.closed) continue;
+                auto lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                    AsyncQueue::Clock::now() - item.queued).count();
+                uint32_t lagUs = static_cast<uint32_t>(std::min<long long>(lag, UINT32_MAX));
+                queue.lastLagUs = lagUs;
+                if (lagUs > queue.maxLagUs) queue.maxLagUs = lagUs;
+                subscriber.callback(item.event);
+                queue.delivered++;
+            }
+        }
+    }
+}
+
+std::vector<EventSubscriberStats> EventDispatcher::GetSubscriberStats() const {
+    std::vector<EventSubscriberStats> result;
+    auto list = m_subscribers.load();
+    for (const auto& subscriber : list->all) {
+        if (!subscriber.queue) continue;
+        auto& queue = *subscriber.queue;
+        EventSubscriberStats stats;
+        stats.id = subscriber.id;
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            stats.queued = queue.count;
+            stats.maxQueued = queue.maxQueued;
+        }
+        stats.delivered = queue.delivered;
+        stats.dropped = queue.dropped;
+        stats.coalesced = queue.coalesced;
+        stats.lastLagUs = queue.lastLagUs;
+        stats.maxLagUs = queue.maxLagUs;
+        result.push_back(stats);
+    }
+    return result;
+}
+
+} // namespace Core
@@ -3,11 +3,17 @@
 #pragma once
 
 #include "Events.h"
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <variant>
 #include <vector>
 #include <mutex>
+#include <array>
 #include <atomic>
+#include <condition_variable>
+#include <thread>
 
 namespace Core {
 
@@ -37,6 +43,7 @@ protected:
     virtual void OnModeChange(const ModeChangeEvent& /*event*/) {}
     virtual void OnError(const ErrorEvent& /*event*/) {}
     virtual void OnLog(const LogEvent& /*event*/) {}
+    virtual void OnCycleProfile(const CycleProfileEvent& /*event*/) {}
 
 private:
     void DispatchEvent(const TemperatureUpdateEvent& e) { OnTemperatureUpdate(e); }
@@ -44,65 +51,172 @@ private:
     void DispatchEvent(const ModeChangeEvent& e) { OnModeChange(e); }
     void DispatchEvent(const ErrorEvent& e) { OnError(e); }
     void DispatchEvent(const LogEvent& e) { OnLog(e); }
+    void DispatchEvent(const CycleProfileEvent& e) { OnCycleProfile(e); }
+};
+
+/// Position of an event type among the ThermalEvent alternatives
+template <typename E, typename Variant = ThermalEvent>
+struct EventTypeIndex;
+
+template <typename E, typename... Ts>
+struct EventTypeIndex<E, std::variant<Ts...>> {
+    static constexpr size_t value = [] {
+        constexpr bool matches[] = {std::is_same_v<E, Ts>...};
+        for (size_t i = 0; i < sizeof...(Ts); i++) {
+            if (matches[i]) return i;
+        }
+        return sizeof...(Ts);
+    }();
+    static_assert(value < sizeof...(Ts), "not a ThermalEvent alternative");
+};
+
+/// Bit of an event type in an event mask
+template <typename E>
+constexpr uint32_t EventBit = 1u << EventTypeIndex<E>::value;
+
+/// Mask of several event types, e.g. EventMask<TemperatureUpdateEvent, FanStateChangeEvent>
+template <typename... Es>
+constexpr uint32_t EventMask = (EventBit<Es> | ... | 0u);
+
+/// Number of ThermalEvent alternatives
+constexpr size_t EventTypeCount = std::variant_size_v<ThermalEvent>;
+
+/// Mask with every ThermalEvent alternative set
+constexpr uint32_t AllEvents = (1u << EventTypeCount) - 1;
+
+/// What an async subscriber's queue does when its consumer falls behind
+enum class EventOverflowPolicy {
+    DropOldest,     // Discard the oldest queued event
+    CoalesceLatest, // Overwrite the newest queued event of the same type (state-like streams)
+    Block           // Let the producer wait up to blockTimeout for space, then drop the oldest
+};
+
+/// Which events reach one subscriber, and how.
+///
+/// Async delivery normally means the control loop never waits on a consumer.
+/// EventOverflowPolicy::Block gives that up: while the queue is full the
+/// producer, usually the ThermalManager worker in the middle of a cycle,
+/// stalls for up to blockTimeout per event before the oldest one is dropped.
+/// Use it only for consumers that must not lose events, with a timeout well
+/// below the cycle period.
+struct EventDeliveryOptions {
+    uint32_t events = AllEvents;    // EventMask of the types to receive
+    bool async = false;             // Deliver on the dispatcher thread instead of the producer's
+    size_t queueCapacity = 256;     // Bound of the async queue
+    EventOverflowPolicy overflow = EventOverflowPolicy::DropOldest;
+    std::chrono::milliseconds blockTimeout{50};  // Longest producer wait per event under Block
+};
+
+/// Delivery counters of one async subscriber
+struct EventSubscriberStats {
+    size_t id = 0;
+    size_t queued = 0;          // Events waiting right now
+    size_t maxQueued = 0;       // High-water mark of the queue
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;       // Lost to overflow
+    uint64_t coalesced = 0;     // Replaced by a newer event of the same type
+    uint32_t lastLagUs = 0;     // Enqueue to callback start of the last delivered event
+    uint32_t maxLagUs = 0;
 };
 
 /// Thread-safe event dispatcher
 /// ThermalManager uses this internally to notify observers
+///
+/// The subscriber list is copy-on-write: Subscribe/Unsubscribe build a new
+/// immutable list and swap it in, Dispatch only loads the current one. A
+/// dispatch therefore takes no dispatcher lock, copies no callbacks and does
+/// not allocate for synchronous subscribers.
+///
+/// Each subscription names the event types it wants (options.events, or the
+/// typed Subscribe<E>). The published list is indexed by type, so an event
+/// only visits its own subscribers, and an event type nobody wants returns
+/// after one mask test.
+///
+/// Synchronous subscribers run on the producer's thread. Async subscribers
+/// get a bounded queue each; the producer only enqueues (a short, callback-
+/// free critical section) and a single dispatcher thread drains the queues
+/// round-robin, so a slow consumer delays neither the producer nor, beyond
+/// one event at a time, the other consumers.
 class EventDispatcher {
 public:
     using Callback = std::function<void(const ThermalEvent&)>;
     using SubscriptionId = size_t;
 
+    EventDispatcher();
+    ~EventDispatcher();
+    EventDispatcher(const EventDispatcher&) = delete;
+    EventDispatcher& operator=(const EventDispatcher&) = delete;
+
     /// Subscribe a callback. Returns an ID that can be used to unsubscribe.
-    SubscriptionId Subscribe(Callback callback) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        SubscriptionId id = m_nextId++;
-        m_callbacks[id] = std::move(callback);
-        return id;
-    }
+    SubscriptionId Subscribe(Callback callback, const EventDeliveryOptions& options = {});
 
     /// Subscribe an observer object
-    SubscriptionId Subscribe(std::weak_ptr<IThermalObserver> observer) {
-        return Subscribe([observer](const ThermalEvent& event) {
-            if (auto obs = observer.lock()) {
-                obs->OnThermalEvent(event);
-            }
-        });
+    SubscriptionId Subscribe(std::weak_ptr<IThermalObserver> observer, const EventDeliveryOptions& options = {});
+
+    /// Subscribe to a single event type; the handler takes the event itself.
+    /// options.events is replaced by that type.
+    template <typename E, typename Handler>
+    SubscriptionId Subscribe(Handler handler, EventDeliveryOptions options = {}) {
+        options.events = EventBit<E>;
+        return Subscribe(Callback([handler = std::move(handler)](const ThermalEvent& event) {
+            handler(*std::get_if<E>(&event));
+        }), options);
     }
 
-    /// Unsubscribe by ID
-    void Unsubscribe(SubscriptionId id) {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_callbacks.erase(id);
+    /// Unsubscribe by ID. Once this returns the callback is not running and
+    /// will not be called again (unless called from within that callback).
+    void Unsubscribe(SubscriptionId id);
+
+    /// Whether anyone receives events of type E.
+    /// Producers check this before building a payload nobody would see.
+    template <typename E>
+    bool HasSubscribers() const {
+        return (m_listening.load(std::memory_order_acquire) & EventBit<E>) != 0;
     }
 
     /// Dispatch an event to all subscribers
     /// Thread-safe: can be called from any thread
-    void Dispatch(const ThermalEvent& event) {
-        std::vector<Callback> callbacks;
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            callbacks.reserve(m_callbacks.size());
-            for (const auto& [id, cb] : m_callbacks) {
-                callbacks.push_back(cb);
-            }
-        }
-        // Call callbacks outside of lock to prevent deadlocks
-        for (const auto& cb : callbacks) {
-            cb(event);
-        }
-    }
+    void Dispatch(const ThermalEvent& event);
 
     /// Clear all subscriptions
-    void Clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_callbacks.clear();
-    }
+    void Clear();
+
+    /// Queue and lag counters of every async subscriber
+    std::vector<EventSubscriberStats> GetSubscriberStats() const;
 
 private:
-    std::mutex m_mutex;
-    std::unordered_map<SubscriptionId, Callback> m_callbacks;
-    std::atomic<SubscriptionId> m_nextId{1};
+    struct AsyncQueue;
+    struct Subscriber {
+        SubscriptionId id;
+        uint32_t events;
+        Callback callback;
+        std::shared_ptr<AsyncQueue> queue;  // Null for synchronous delivery
+    };
+    /// Immutable once published; byType points into all
+    struct SubscriberList {
+        std::vector<Subscriber> all;
+        std::array<std::vector<const Subscriber*>, EventTypeCount> byType;
+    };
+
+    /// Index a new subscriber set by type and swap it in (m_mutex held)
+    void Publish(std::vector<Subscriber> subscribers);
+
+    /// Stop delivering to a removed subscriber and wait out a running callback
+    void Close(AsyncQueue& queue, std::thread::id deliveryThread);
+
+    void Enqueue(AsyncQueue& queue, const ThermalEvent& event);
+    void DeliveryLoop(std::stop_token stopToken);
+
+    mutable std::mutex m_mutex;  // Serializes writers only
+    std::atomic<std::shared_ptr<const SubscriberList>> m_subscribers;
+    std::atomic<uint32_t> m_listening{0};
+    SubscriptionId m_nextId{1};
+
+    // Async delivery (thread started with the first async subscriber)
+    std::mutex m_wakeMutex;
+    std::condition_variable_any m_wakeCv;
+    bool m_pending{false};
+    std::jthread m_deliveryThread;
 };
 
 } // namespace Core
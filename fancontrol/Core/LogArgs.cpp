@@ -0,0 +1,117 @@
+// Core/LogArgs.cpp - Implementation of signature-driven log argument decoding
+#include "LogArgs.h"
+
+#include <charconv>
+#include <variant>
+#include <vector>
+
+namespace Core::LogArgs {
+
+namespace {
+
+using Value = std::variant<bool, char, int64_t, uint64_t, float, double, long double,
+                           const void*, std::string_view>;
+
+template <typename T>
+bool ReadRaw(const std::byte* args, size_t size, size_t& pos, T& value) {
+    if (pos + sizeof(T) > size) return false;
+    std::memcpy(&value, args + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+template <typename Narrow, typename Wide>
+bool ReadInt(const std::byte* args, size_t size, size_t& pos, Value& value) {
+    Narrow raw;
+    if (!ReadRaw(args, size, pos, raw)) return false;
+    value = (Wide)raw;
+    return true;
+}
+
+bool ReadValue(char code, const std::byte* args, size_t size, size_t& pos, Value& value) {
+    switch (code) {
+        case 'b': { bool v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 'c': { char v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 'a': return ReadInt<int8_t, int64_t>(args, size, pos, value);
+        case 'h': return ReadInt<int16_t, int64_t>(args, size, pos, value);
+        case 'i': return ReadInt<int32_t, int64_t>(args, size, pos, value);
+        case 'l': return ReadInt<int64_t, int64_t>(args, size, pos, value);
+        case 'A': return ReadInt<uint8_t, uint64_t>(args, size, pos, value);
+        case 'H': return ReadInt<uint16_t, uint64_t>(args, size, pos, value);
+        case 'I': return ReadInt<uint32_t, uint64_t>(args, size, pos, value);
+        case 'L': return ReadInt<uint64_t, uint64_t>(args, size, pos, value);
+        case 'f': { float v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 'd': { double v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 'e': { long double v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 'p': { const void* v; if (!ReadRaw(args, size, pos, v)) return false; value = v; return true; }
+        case 's': {
+            uint16_t length;
+            if (!ReadRaw(args, size, pos, length) || pos + length > size) return false;
+            value = std::string_view(reinterpret_cast<const char*>(args + pos), length);
+            pos += length;
+            return true;
+        }
+        default: return false;
+    }
+}
+
+} // namespace
+
+bool FormatDynamic(std::string_view fmt, std::string_view signature,
+                   const std::byte* args, size_t size, std::string& out) {
+    std::vector<Value> values(signature.size());
+    size_t pos = 0;
+    for (size_t i = 0; i < signature.size(); i++) {
+        if (!ReadValue(signature[i], args, size, pos, values[i])) return false;
+    }
+
+    size_t nextArg = 0;
+    std::string spec;
+    for (size_t i = 0; i < fmt.size(); i++) {
+        const char c = fmt[i];
+        if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+            out += c;
+            i++;
+            continue;
+        }
+        if (c != '{') {
+            out += c;
+            continue;
+        }
+
+        size_t close = fmt.find('}', i);
+        if (close == std::string_view::npos) {
+            out.append(fmt.substr(i));
+            break;
+        }
+        std::string_view field = fmt.substr(i + 1, close - i - 1);
+        std::string_view specText;
+        if (size_t colon = field.find(':'); colon != std::string_view::npos) {
+            specText = field.substr(colon + 1);
+            field = field.substr(0, colon);
+        }
+
+        size_t index = nextArg++;
+        if (!field.empty()) {
+            std::from_chars(field.data(), field.data() + field.size(), index);
+        }
+        if (index >= values.size() || specText.find('{') != std::string_view::npos) {
+            out.append(fmt.substr(i, close - i + 1));
+            i = close;
+            continue;
+        }
+
+        spec.assign("{:").append(specText).append("}");
+        std::visit([&](auto value) {
+            try {
+                std::vformat_to(std::back_inserter(out), spec, std::make_format_args(value));
+            } catch (const std::format_error&) {
+                out.append(fmt.substr(i, close - i + 1));
+            }
+        }, values[index]);
+        i = close;
+    }
+    return true;
+}
+
+} // namespace Core::LogArgs
@@ -0,0 +1,171 @@
+// Core/LogArgs.h - Binary capture of log arguments for deferred formatting
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace Core::LogArgs {
+
+/// Formats captured arguments: the format ID of a log call site. There is one
+/// instantiation per argument type list, so the hot path only stores a pointer.
+using FormatFn = void (*)(const std::byte* args, std::string_view fmt, std::string& out);
+
+template <typename T>
+constexpr bool IsString = std::is_convertible_v<const std::decay_t<T>&, std::string_view>;
+
+/// How an argument is kept after capture: strings become views into the buffer
+template <typename T>
+using Stored = std::conditional_t<IsString<T>, std::string_view, std::decay_t<T>>;
+
+/// Bytes an argument needs regardless of its value (strings: the length prefix)
+template <typename T>
+constexpr size_t FixedBytes() {
+    if constexpr (IsString<T>) {
+        return sizeof(uint16_t);
+    } else {
+        using V = std::decay_t<T>;
+        static_assert(std::is_arithmetic_v<V> || std::is_pointer_v<V>,
+                      "Log arguments must be numbers, pointers or strings");
+        return sizeof(V);
+    }
+}
+
+template <typename... Args>
+constexpr size_t kFixedBytes = (FixedBytes<Args>() + ... + 0);
+
+/// One-letter type code of a stored argument, so a decoder without the
+/// FormatFn (offline, another process) can still read the arguments back
+template <typename T>
+constexpr char TypeCode() {
+    using V = std::decay_t<T>;
+    if constexpr (IsString<T>) return 's';
+    else if constexpr (std::is_same_v<V, bool>) return 'b';
+    else if constexpr (std::is_same_v<V, char>) return 'c';
+    else if constexpr (std::is_pointer_v<V>) return 'p';
+    else if constexpr (std::is_same_v<V, float>) return 'f';
+    else if constexpr (std::is_same_v<V, double>) return 'd';
+    else if constexpr (std::is_same_v<V, long double>) return 'e';
+    else {
+        static_assert(std::is_integral_v<V> && sizeof(V) <= 8, "Unsupported log argument type");
+        constexpr char kSigned[] = {'a', 'h', 0, 'i', 0, 0, 0, 'l'};
+        constexpr char kUnsigned[] = {'A', 'H', 0, 'I', 0, 0, 0, 'L'};
+        return std::is_signed_v<V> ? kSigned[sizeof(V) - 1] : kUnsigned[sizeof(V) - 1];
+    }
+}
+
+/// Type codes of an argument list as a C string
+template <typename... Args>
+inline constexpr char kSignature[] = {TypeCode<Args>()..., '\0'};
+
+template <typename T>
+std::string_view ToView(const T& value) {
+    if constexpr (std::is_pointer_v<T>) {
+        if (value == nullptr) return {};
+    }
+    return std::string_view(value);
+}
+
+/// Encoded size of the arguments with every string cut to maxString bytes
+template <typename... Args>
+size_t EncodedSize([[maybe_unused]] size_t maxString, const Args&... args) {
+    size_t size = kFixedBytes<Args...>;
+    ([&] {
+        if constexpr (IsString<Args>) size += std::min(ToView(args).size(), maxString);
+    }(), ...);
+    return size;
+}
+
+/// Appends arguments to a buffer of fixed capacity. Strings are length-prefixed
+/// and truncated so the fixed-size parts of later arguments still fit.
+class Writer {
+public:
+    /// @param reserved Fixed bytes of all arguments that will be written (kFixedBytes)
+    Writer(std::byte* out, size_t capacity, size_t reserved,
+           size_t maxString = std::numeric_limits<uint16_t>::max())
+        : m_out(out), m_capacity(capacity), m_reserved(reserved), m_maxString(maxString) {}
+
+    template <typename T>
+    void Put(const T& value) {
+        if constexpr (IsString<T>) {
+            std::string_view text = ToView(value);
+            m_reserved -= sizeof(uint16_t);
+            size_t room = m_capacity - m_size - m_reserved - sizeof(uint16_t);
+            uint16_t length = (uint16_t)std::min({text.size(), room, m_maxString});
+            Write(&length, sizeof(length));
+            Write(text.data(), length);
+        } else {
+            std::decay_t<T> stored = value;
+            m_reserved -= sizeof(stored);
+            Write(&stored, sizeof(stored));
+        }
+    }
+
+    size_t Size() const { return m_size; }
+
+private:
+    void Write(const void* data, size_t size) {
+        std::memcpy(m_out + m_size, data, size);
+        m_size += size;
+    }
+
+    std::byte* m_out;
+    size_t m_size = 0;
+    size_t m_capacity;
+    size_t m_reserved;  // Bytes still needed by the fixed-size parts of later arguments
+    size_t m_maxString;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::byte* in) : m_in(in) {}
+
+    template <typename T>
+    Stored<T> Get() {
+        if constexpr (IsString<T>) {
+            uint16_t length;
+            std::memcpy(&length, m_in + m_pos, sizeof(length));
+            std::string_view text(reinterpret_cast<const char*>(m_in + m_pos + sizeof(length)), length);
+            m_pos += sizeof(length) + length;
+            return text;
+        } else {
+            std::decay_t<T> value;
+            std::memcpy(&value, m_in + m_pos, sizeof(value));
+            m_pos += sizeof(value);
+            return value;
+        }
+    }
+
+private:
+    const std::byte* m_in;
+    size_t m_pos = 0;
+};
+
+/// The FormatFn of an argument type list
+template <typename... Args>
+void FormatTo(const std::byte* args, std::string_view fmt, std::string& out) {
+    Reader in(args);
+    // Braced initialization decodes the arguments left to right
+    std::tuple<Stored<Args>...> values{ in.template Get<Args>()... };
+    std::apply([&](auto&... value) {
+        std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(value...));
+    }, values);
+}
+
+/// Format captured arguments from their signature alone (offline decoding).
+/// Handles automatic and manual field numbering with per-field format specs;
+/// fields with nested width/precision arguments are copied through unformatted.
+/// @return false if the arguments do not match the signature
+bool FormatDynamic(std::string_view fmt, std::string_view signature,
+                   const std::byte* args, size_t size, std::string& out);
+
+} // namespace Core::LogArgs
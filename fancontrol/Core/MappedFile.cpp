@@ -0,0 +1,110 @@
+// Core/MappedFile.cpp - Implementation of the file mapping (Win32 / POSIX)
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Core {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path, size_t size) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    
+    LARGE_INTEGER length;
+    length.QuadPart = (LONGLONG)size;
+    if (!SetFilePointerEx(file, length, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!data) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    m_mapping = mapping;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) {
+        FlushViewOfFile(m_data, 0);
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file) CloseHandle(m_file);
+    m_data = nullptr;
+    m_mapping = nullptr;
+    m_file = nullptr;
+    m_size = 0;
+}
+
+void MappedFile::Flush() {
+    if (m_data) FlushViewOfFile(m_data, 0);
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path, size_t size) {
+    Close();
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    
+    if (::ftruncate(fd, (off_t)size) != 0) {
+        ::close(fd);
+        return false;
+    }
+    void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        ::close(fd);
+        return false;
+    }
+    m_fd = fd;
+    m_data = data;
+    m_size = size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_data) {
+        ::msync(m_data, m_size, MS_ASYNC);
+        ::munmap(m_data, m_size);
+    }
+    if (m_fd >= 0) ::close(m_fd);
+    m_data = nullptr;
+    m_fd = -1;
+    m_size = 0;
+}
+
+void MappedFile::Flush() {
+    if (m_data) ::msync(m_data, m_size, MS_ASYNC);
+}
+
+#endif
+
+} // namespace Core
@@ -0,0 +1,45 @@
+// Core/MappedFile.h - Read-write memory mapping of a file
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace Core {
+
+/// A file mapped read-write into memory, created or resized to a fixed size.
+/// Writes go to the page cache and reach the disk on Flush() or unmap, so a
+/// crash of the process loses nothing (a crash of the OS may).
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /// Map path with exactly size bytes (new bytes read as zero)
+    /// @return false if the file cannot be created, resized or mapped
+    bool Open(const std::string& path, size_t size);
+    
+    void Close();
+    
+    /// Ask the OS to write dirty pages back (asynchronous where supported)
+    void Flush();
+    
+    bool IsOpen() const { return m_data != nullptr; }
+    void* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    
+private:
+#ifdef _WIN32
+    void* m_file{nullptr};      // HANDLE
+    void* m_mapping{nullptr};   // HANDLE
+#else
+    int m_fd{-1};
+#endif
+    void* m_data{nullptr};
+    size_t m_size{0};
+};
+
+} // namespace Core
@@ -0,0 +1,86 @@
+// Core/PlotDecimator.cpp - Implementation of the plot min/max decimation
+#include "PlotDecimator.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CORE_PLOT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Core {
+
+namespace {
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+// (v < lo) is false for NaN, so gaps never win; same for the SSE min/max,
+// which return their second operand when either one is NaN
+void ScanRange(const float* data, size_t begin, size_t end, float& lo, float& hi) {
+    size_t i = begin;
+#ifdef CORE_PLOT_SSE2
+    if (end - begin >= 8) {
+        __m128 vlo = _mm_set1_ps(kInf);
+        __m128 vhi = _mm_set1_ps(-kInf);
+        for (; i + 4 <= end; i += 4) {
+            __m128 v = _mm_loadu_ps(data + i);
+            vlo = _mm_min_ps(v, vlo);
+            vhi = _mm_max_ps(v, vhi);
+        }
+        vlo = _mm_min_ps(vlo, _mm_shuffle_ps(vlo, vlo, _MM_SHUFFLE(1, 0, 3, 2)));
+        vlo = _mm_min_ps(vlo, _mm_shuffle_ps(vlo, vlo, _MM_SHUFFLE(2, 3, 0, 1)));
+        vhi = _mm_max_ps(vhi, _mm_shuffle_ps(vhi, vhi, _MM_SHUFFLE(1, 0, 3, 2)));
+        vhi = _mm_max_ps(vhi, _mm_shuffle_ps(vhi, vhi, _MM_SHUFFLE(2, 3, 0, 1)));
+        lo = std::min(lo, _mm_cvtss_f32(vlo));
+        hi = std::max(hi, _mm_cvtss_f32(vhi));
+    }
+#endif
+    for (; i < end; i++) {
+        float v = data[i];
+        lo = (v < lo) ? v : lo;
+        hi = (v > hi) ? v : hi;
+    }
+}
+
+} // namespace
+
+void DecimateMinMax(std::span<const float> values, std::span<PlotColumn> columns) {
+    const size_t n = values.size();
+    const size_t count = columns.size();
+    if (count == 0) return;
+
+    for (size_t c = 0; c < count; c++) {
+        // First sample of column c is ceil(c * n / count)
+        const size_t begin = (c * n + count - 1) / count;
+        const size_t end = std::min(n, ((c + 1) * n + count - 1) / count);
+        float lo = kInf, hi = -kInf;
+        if (begin < end) ScanRange(values.data(), begin, end, lo, hi);
+
+        if (lo > hi) {
+            columns[c] = {kNaN, kNaN};
+        } else {
+            columns[c] = {lo, hi};
+        }
+    }
+}
+
+std::span<const PlotColumn> PlotDecimator::Update(std::span<const float> values, int64_t newestTime, int columns) {
+    const size_t count = std::min<size_t>((size_t)std::max(columns, 0), values.size());
+    const float newest = values.empty() ? 0.0f : values.back();
+
+    // Bitwise compare: NaN != NaN would defeat the cache in a gap
+    m_cached = m_size == values.size() && m_newestTime == newestTime && m_columns.size() == count
+            && std::memcmp(&m_newest, &newest, sizeof(float)) == 0;
+    if (m_cached) return m_columns;
+
+    m_columns.resize(count);
+    DecimateMinMax(values, m_columns);
+    m_size = values.size();
+    m_newestTime = newestTime;
+    m_newest = newest;
+    return m_columns;
+}
+
+} // namespace Core
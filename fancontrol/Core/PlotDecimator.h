@@ -0,0 +1,46 @@
+// Core/PlotDecimator.h - Min/max reduction of history series for plotting
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Core {
+
+/// Range of the samples falling into one pixel column (NaN/NaN: only gaps)
+struct PlotColumn {
+    float min;
+    float max;
+};
+
+/// Reduce values to columns.size() min/max pairs in one pass. Sample i goes
+/// to column i * columns / values.size(); NaN samples are skipped. Uses SSE2
+/// when the target has it.
+void DecimateMinMax(std::span<const float> values, std::span<PlotColumn> columns);
+
+/// DecimateMinMax() with a cache: the columns are recomputed only when the
+/// series got a new bucket, its newest bucket changed, or the width changed.
+/// Drawing one polyline through the columns costs O(pixels) however long the
+/// series is.
+class PlotDecimator {
+public:
+    /// @param values Series oldest to newest (e.g. HistoryStore::Reader::Series)
+    /// @param newestTime Time of the last value, identifies new buckets
+    /// @param columns Pixel columns available; capped at values.size()
+    std::span<const PlotColumn> Update(std::span<const float> values, int64_t newestTime, int columns);
+
+    /// Whether the last Update() returned the cached columns
+    bool WasCached() const { return m_cached; }
+
+    void Invalidate() { m_size = 0; }
+
+private:
+    std::vector<PlotColumn> m_columns;
+    size_t m_size{0};
+    int64_t m_newestTime{0};
+    float m_newest{0.0f};
+    bool m_cached{false};
+};
+
+} // namespace Core
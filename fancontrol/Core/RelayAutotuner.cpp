@@ -0,0 +1,138 @@
+// Core/RelayAutotuner.cpp - Implementation of the relay-feedback autotuner
+#include "RelayAutotuner.h"
+#include <algorithm>
+
+namespace Core {
+
+namespace {
+constexpr float kPi = 3.14159265f;
+constexpr float kMinAmplitude = 0.25f;  // °C; smaller swings are sensor noise
+}
+
+void RelayAutotuner::Start(const AutotuneSettings& settings, double now) {
+    m_settings = settings;
+    m_settings.cycles = std::clamp(m_settings.cycles, 1, kMaxCycles);
+    if (m_settings.highLevel <= m_settings.lowLevel) {
+        m_settings.highLevel = m_settings.lowLevel + 1;
+    }
+
+    m_progress = AutotuneProgress{};
+    m_progress.phase = AutotunePhase::Settling;
+    m_progress.targetCycles = m_settings.cycles;
+
+    m_startTime = now;
+    m_hasSample = false;
+    m_relayHigh = false;    // Let the machine warm up to the setpoint first
+    m_crossings = 0;
+    m_cycleMax = settings.setpoint;
+    m_cycleMin = settings.setpoint;
+}
+
+void RelayAutotuner::Cancel() {
+    m_progress.phase = AutotunePhase::Idle;
+}
+
+int RelayAutotuner::Update(float temp, double now) {
+    if (!IsActive()) {
+        return m_settings.lowLevel;
+    }
+
+    if (now - m_startTime > m_settings.timeoutSeconds) {
+        Fail();
+        return m_settings.lowLevel;
+    }
+
+    const float sp = m_settings.setpoint;
+    if (m_hasSample) {
+        // Rising through the setpoint: interpolate the crossing instant
+        if (m_lastTemp < sp && temp >= sp && now > m_lastTime) {
+            double frac = (sp - m_lastTemp) / (temp - m_lastTemp);
+            OnUpwardCrossing(m_lastTime + frac * (now - m_lastTime));
+        }
+    }
+    m_lastTemp = temp;
+    m_lastTime = now;
+    m_hasSample = true;
+
+    m_cycleMax = (std::max)(m_cycleMax, temp);
+    m_cycleMin = (std::min)(m_cycleMin, temp);
+
+    // Relay with hysteresis: hot -> high fan, cool -> low fan
+    if (temp > sp + m_settings.noiseBand) {
+        m_relayHigh = true;
+    } else if (temp < sp - m_settings.noiseBand) {
+        m_relayHigh = false;
+    }
+
+    return m_relayHigh ? m_settings.highLevel : m_settings.lowLevel;
+}
+
+void RelayAutotuner::OnUpwardCrossing(double crossingTime) {
+    if (m_progress.phase == AutotunePhase::Settling) {
+        m_progress.phase = AutotunePhase::Relay;
+    } else {
+        // The crossing closes one full oscillation period
+        m_amplitudes[m_crossings - 1] = (m_cycleMax - m_cycleMin) / 2.0f;
+    }
+    m_crossTimes[m_crossings++] = crossingTime;
+    m_cycleMax = m_settings.setpoint;
+    m_cycleMin = m_settings.setpoint;
+
+    // First period is discarded: it still carries the settling transient
+    const int periods = m_crossings - 2;
+    m_progress.completedCycles = (std::max)(0, periods);
+    if (periods < m_settings.cycles) {
+        return;
+    }
+
+    float sumA = 0.0f;
+    double sumP = 0.0;
+    for (int i = 1; i <= periods; i++) {
+        sumA += m_amplitudes[i];
+        sumP += m_crossTimes[i + 1] - m_crossTimes[i];
+    }
+    const float a = sumA / periods;
+    const float pu = (float)(sumP / periods);
+
+    if (a < kMinAmplitude || pu <= 0.0f) {
+        Fail();
+        return;
+    }
+
+    const float d = (m_settings.highLevel - m_settings.lowLevel) / 2.0f;
+    m_progress.ultimateGain = (4.0f * d) / (kPi * a);
+    m_progress.ultimatePeriod = pu;
+    m_progress.phase = AutotunePhase::Success;
+}
+
+void RelayAutotuner::Fail() {
+    // A seeded run still ends with usable gains
+    m_progress.fromSeed = m_settings.hasSeed;
+    m_progress.phase = m_settings.hasSeed ? AutotunePhase::Success : AutotunePhase::Failed;
+}
+
+PIDConfig RelayAutotuner::GetResult(const PIDConfig& base) const {
+    PIDConfig result = base;
+    if (m_progress.phase != AutotunePhase::Success) {
+        return result;
+    }
+    if (m_progress.fromSeed) {
+        result.Kp = m_settings.seed.Kp;
+        result.Ki = m_settings.seed.Ki;
+        result.Kd = m_settings.seed.Kd;
+        result.targetTemp = m_settings.setpoint;
+        return result;
+    }
+
+    const float ku = m_progress.ultimateGain;
+    const float pu = m_progress.ultimatePeriod;
+    const float ti = 0.5f * pu;
+    const float td = 0.33f * pu;
+    result.Kp = 0.2f * ku;
+    result.Ki = result.Kp / ti;
+    result.Kd = result.Kp * td;
+    result.targetTemp = m_settings.setpoint;
+    return result;
+}
+
+} // namespace Core
@@ -0,0 +1,97 @@
+// Core/RelayAutotuner.h - Relay-feedback (Astrom-Hagglund) PID autotuner
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "SensorConfig.h"
+
+#include <array>
+
+namespace Core {
+
+enum class AutotunePhase {
+    Idle,       // Not running
+    Settling,   // Driving towards the setpoint, waiting for the first crossing
+    Relay,      // Relay oscillation in progress
+    Success,    // Result available
+    Failed      // Timed out or oscillation too small to measure
+};
+
+/// Parameters of one autotune run
+struct AutotuneSettings {
+    float setpoint = 60.0f;         // Temperature the relay switches around
+    int lowLevel = 0;               // Fan level below the setpoint
+    int highLevel = 7;              // Fan level above the setpoint
+    float noiseBand = 0.5f;         // Relay hysteresis in °C
+    int cycles = 4;                 // Oscillation periods to average (after one discarded)
+    float timeoutSeconds = 1800.0f; // Give up after this long
+    bool hasSeed = false;           // seed holds model-based gains (ThermalModel::SuggestPID)
+    PIDConfig seed;                 // Result of a run that finds no usable oscillation
+};
+
+/// Progress snapshot, safe to copy to the UI
+struct AutotuneProgress {
+    AutotunePhase phase = AutotunePhase::Idle;
+    int completedCycles = 0;
+    int targetCycles = 0;
+    float ultimateGain = 0.0f;      // Ku in fan levels per °C
+    float ultimatePeriod = 0.0f;    // Pu in seconds
+    bool fromSeed = false;          // No usable oscillation; the result is the seed
+};
+
+/// Relay-feedback autotuner.
+/// While running it owns the fan: above setpoint + noiseBand it commands
+/// highLevel, below setpoint - noiseBand lowLevel. The resulting limit cycle
+/// gives the ultimate gain Ku = 4d / (pi * a) (d: relay amplitude, a: temperature
+/// amplitude) and the ultimate period Pu. Setpoint crossings are interpolated
+/// between samples, so Pu is resolved more finely than the control cycle.
+class RelayAutotuner {
+public:
+    /// Begin a run
+    /// @param now Sample time base in seconds (monotonic)
+    void Start(const AutotuneSettings& settings, double now);
+
+    /// Abort a run; the tuner returns to Idle
+    void Cancel();
+
+    /// True while the tuner is driving the fan
+    bool IsActive() const {
+        return m_progress.phase == AutotunePhase::Settling || m_progress.phase == AutotunePhase::Relay;
+    }
+
+    /// Feed one temperature sample
+    /// @param temp Controlled temperature
+    /// @param now Sample timestamp in seconds, same base as Start()
+    /// @return Fan level to command while active
+    int Update(float temp, double now);
+
+    const AutotuneProgress& GetProgress() const { return m_progress; }
+
+    /// Tuned gains (conservative Ziegler-Nichols "no overshoot" rule), or the
+    /// seed gains when the relay failed on a seeded run.
+    /// Only meaningful in the Success phase; other fields are copied from base.
+    PIDConfig GetResult(const PIDConfig& base) const;
+
+private:
+    void OnUpwardCrossing(double crossingTime);
+    void Fail();
+
+    static constexpr int kMaxCycles = 16;
+
+    AutotuneSettings m_settings;
+    AutotuneProgress m_progress;
+
+    double m_startTime{0.0};
+    double m_lastTime{0.0};
+    float m_lastTemp{0.0f};
+    bool m_hasSample{false};
+    bool m_relayHigh{true};
+
+    // Per-cycle measurements, indexed by completed cycle
+    std::array<double, kMaxCycles + 2> m_crossTimes{};
+    std::array<float, kMaxCycles + 1> m_amplitudes{};
+    int m_crossings{0};
+    float m_cycleMax{0.0f};
+    float m_cycleMin{0.0f};
+};
+
+} // namespace Core
@@ -27,6 +27,8 @@ struct SensorDefinition {
     SensorDefinition(int idx, int addr, const std::string& n = "")
         : index(idx), address(addr), name(n), offset(0),
           hystMin(-1), hystMax(-1), weight(1.0f), enabled(true) {}
+    
+    bool operator==(const SensorDefinition&) const = default;
 };
 
 /// Smart mode fan level configuration
@@ -43,6 +45,8 @@ struct SmartLevelDefinition {
         : temperature(temp), fanLevel(fan), hystUp(up), hystDown(down) {}
         
     bool IsValid() const { return temperature >= 0; }
+    
+    bool operator==(const SmartLevelDefinition&) const = default;
 };
 
 /// PID controller settings
@@ -54,8 +58,107 @@ struct PIDConfig {
     int minFan;                 // Minimum fan level
     int maxFan;                 // Maximum fan level
     
+    // Temporal dithering of the fractional PID output (see FanDither)
+    bool dither;                // Alternate adjacent levels instead of rounding
+    float ditherMinDwell;       // Minimum seconds a dithered level is held
+    int ditherMaxWritesPerMin;  // Cap on dither-induced EC writes per minute
+    
     PIDConfig()
-        : Kp(1.0f), Ki(0.1f), Kd(0.5f), targetTemp(60.0f), minFan(0), maxFan(7) {}
+        : Kp(1.0f), Ki(0.1f), Kd(0.5f), targetTemp(60.0f), minFan(0), maxFan(7),
+          dither(false), ditherMinDwell(5.0f), ditherMaxWritesPerMin(6) {}
+    
+    bool operator==(const PIDConfig&) const = default;
+};
+
+/// Slew-rate limits applied between the control algorithm and the EC
+struct FanRampConfig {
+    bool enabled;               // Ramp scheduler active
+    float upRate;               // Max levels per second when speeding up
+    float downRate;             // Max levels per second when slowing down
+    float minDwell;             // Minimum seconds between two level changes
+    float reversalWindow;       // Direction flips within this many seconds are held
+    int criticalTemp;           // At or above this temperature requests pass unthrottled
+    
+    FanRampConfig()
+        : enabled(false), upRate(0.5f), downRate(0.2f), minDwell(5.0f),
+          reversalWindow(15.0f), criticalTemp(85) {}
+    
+    bool operator==(const FanRampConfig&) const = default;
+};
+
+/// Model-predictive control (ControlMode::MPC, see FanMPC)
+struct MPCConfig {
+    float targetTemp;           // Upper temperature limit the controller plans against
+    float horizonSeconds;       // Prediction horizon
+    int moveBlocks;             // Points in the horizon where the single planned move may happen
+    float levelCost;            // Cost per fan level per second
+    float writeCost;            // Cost of one level change
+    float overTempCost;         // Cost per (°C over target)² per second
+    int minFan;                 // Lowest level the controller may choose
+    int maxFan;                 // Highest level the controller may choose
+    
+    MPCConfig()
+        : targetTemp(65.0f), horizonSeconds(60.0f), moveBlocks(4), levelCost(1.0f),
+          writeCost(10.0f), overTempCost(50.0f), minFan(0), maxFan(7) {}
+    
+    bool operator==(const MPCConfig&) const = default;
+};
+
+/// Tach-based RPM target control (ControlMode::RPM, see FanRpmController)
+struct FanRpmConfig {
+    int targetRpm;              // Initial target speed of fan 1
+    int loopMs;                 // Inner tach loop period (runs between thermal cycles)
+    int toleranceRpm;           // No level change while the learned RPM is this close
+    float settleSeconds;        // Spin-up time ignored after a level change when learning
+    bool dither;                // Alternate adjacent levels for targets between levels
+    float minDwellSeconds;      // Minimum hold time of a level
+    int maxWritesPerMin;        // Cap on dither-induced EC writes per minute
+    
+    FanRpmConfig()
+        : targetRpm(3000), loopMs(500), toleranceRpm(150), settleSeconds(3.0f), dither(true),
+          minDwellSeconds(10.0f), maxWritesPerMin(4) {}
+    
+    bool operator==(const FanRpmConfig&) const = default;
+};
+
+/// Control loop period, optionally adapted to how fast temperatures move
+struct CycleConfig {
+    int periodMs;               // Fixed period in ms (0: use cycleSeconds)
+    bool adaptive;              // Vary the period between minPeriodMs and maxPeriodMs
+    int minPeriodMs;            // Period while temperatures rise or warm up near a threshold
+    int maxPeriodMs;            // Period the loop backs off to when thermals are stable
+    float riseRate;             // °C/s at or above which the loop runs fast
+    int thresholdMargin;        // °C around a control threshold that counts as close
+    
+    CycleConfig()
+        : periodMs(0), adaptive(false), minPeriodMs(500), maxPeriodMs(5000),
+          riseRate(0.5f), thresholdMargin(2) {}
+    
+    bool operator==(const CycleConfig&) const = default;
+};
+
+/// Deadline watchdog of the control worker (see CycleWatchdog)
+struct WatchdogConfig {
+    bool enabled;               // Hand the fan to the BIOS when the worker stalls
+    int stallMs;                // Grace beyond the expected heartbeat before it fires
+    
+    WatchdogConfig()
+        : enabled(true), stallMs(5000) {}
+    
+    bool operator==(const WatchdogConfig&) const = default;
+};
+
+/// Independent control zone for one fan of a dual-fan machine
+struct FanZoneConfig {
+    std::vector<int> sensorIndices; // Sensors driving this fan (empty: all non-ignored)
+    int smartProfile;               // Smart profile used in Smart mode (0 or 1)
+    bool usePID;                    // Use PID instead of the smart profile
+    PIDConfig pid;                  // PID settings when usePID is set
+    
+    FanZoneConfig()
+        : smartProfile(0), usePID(false) {}
+    
+    bool operator==(const FanZoneConfig&) const = default;
 };
 
 /// Icon color level thresholds
@@ -66,6 +169,8 @@ struct IconLevelConfig {
         // Default thresholds: Blue < 50, Green < 60, Yellow < 70, Red >= 70
         thresholds = {50, 60, 70};
     }
+    
+    bool operator==(const IconLevelConfig&) const = default;
 };
 
 /// Complete thermal configuration
@@ -80,6 +185,19 @@ struct ThermalConfig {
     // PID configuration
     PIDConfig pid;
     
+    // Model-predictive control
+    MPCConfig mpc;
+    
+    // Tach-based RPM target control
+    FanRpmConfig rpm;
+    
+    // Fan ramp scheduler (Smart, Manual, PID and MPC modes)
+    FanRampConfig ramp;
+    
+    // Per-fan control zones (dual-fan machines, Smart/PID modes only)
+    bool fanZonesEnabled;
+    std::array<FanZoneConfig, 2> fanZones;
+    
     // Hardware settings
     bool isDualFan;
     int fanSpeedAddr;
@@ -88,7 +206,9 @@ struct ThermalConfig {
     
     // Timing
     int cycleSeconds;           // Main control loop interval
+    CycleConfig cycle;          // Millisecond / adaptive period (overrides cycleSeconds)
     int iconCycleSeconds;       // Icon update interval
+    WatchdogConfig watchdog;    // Stall detection and BIOS fail-safe
     
     // Display
     bool useFahrenheit;
@@ -99,7 +219,7 @@ struct ThermalConfig {
     int manModeExitTemp;        // Auto-exit manual mode above this temp
     
     ThermalConfig() 
-        : isDualFan(false), useBiasedTemps(true), noExtSensor(false),
+        : fanZonesEnabled(false), isDualFan(false), useBiasedTemps(true), noExtSensor(false),
           cycleSeconds(5), iconCycleSeconds(3), useFahrenheit(false),
           manualFanSpeed(7), manModeExitTemp(90) {}
 };
@@ -0,0 +1,71 @@
+// Core/SmartLevelTable.cpp - Compilation and evaluation of smart-mode tables
+#include "SmartLevelTable.h"
+#include <algorithm>
+
+namespace Core {
+
+SmartLevelTable::SmartLevelTable(const std::vector<SmartLevelDefinition>& profile) {
+    std::vector<int> temps;
+    for (const auto& def : profile) {
+        if (!def.IsValid()) continue;
+        m_levels.push_back({def.fanLevel, def.temperature - def.hystDown, def.temperature + def.hystUp});
+        temps.push_back(def.temperature);
+    }
+
+    // Last matching entry wins, as in the linear scan this replaces
+    for (int t = 0; t < kTempCount; t++) {
+        int index = -1;
+        for (int i = 0; i < (int)temps.size(); i++) {
+            if (t >= temps[i]) index = i;
+        }
+        m_indexByTemp[t] = (int8_t)index;
+    }
+}
+
+int SmartLevelTable::Evaluate(int maxTemp, int currentLevel, int& lastLevelIndex) const {
+    const int levelIndex = m_indexByTemp[std::clamp(maxTemp, 0, kTempCount - 1)];
+    if (levelIndex < 0) return -1;
+
+    const int newFanCtrl = m_levels[levelIndex].fan;
+    if (newFanCtrl == currentLevel) return -1;
+
+    if (lastLevelIndex >= 0 && lastLevelIndex < (int)m_levels.size()) {
+        if (levelIndex < lastLevelIndex) { // Cooling down
+            if (maxTemp >= m_levels[lastLevelIndex].downThreshold) return -1;
+        } else { // Heating up
+            if (maxTemp < m_levels[levelIndex].upThreshold) return -1;
+        }
+    }
+
+    lastLevelIndex = levelIndex;
+    return newFanCtrl;
+}
+
+int SmartLevelTable::Request(int maxTemp, int currentLevel, SmartLevelState& state) const {
+    int index = state.appliedIndex;
+    int level = Evaluate(maxTemp, currentLevel, index);
+    if (level == -1) {
+        index = state.appliedIndex;
+        level = (index >= 0 && index < (int)m_levels.size()) ? m_levels[index].fan : currentLevel;
+    }
+    state.requestedIndex = index;
+    return level;
+}
+
+void SmartLevelTable::Confirm(int appliedLevel, SmartLevelState& state) const {
+    const int index = state.requestedIndex;
+    if (index >= 0 && index < (int)m_levels.size() && m_levels[index].fan == appliedLevel) {
+        state.appliedIndex = index;
+    }
+}
+
+std::shared_ptr<const SmartProfileSet> CompileSmartProfiles(const ThermalConfig& config) {
+    auto set = std::make_shared<SmartProfileSet>();
+    set->reserve(config.smartProfiles.size());
+    for (const auto& profile : config.smartProfiles) {
+        set->emplace_back(profile);
+    }
+    return set;
+}
+
+} // namespace Core
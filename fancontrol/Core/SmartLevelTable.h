@@ -0,0 +1,71 @@
+// Core/SmartLevelTable.h - Precompiled smart-mode lookup tables
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "SensorConfig.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Core {
+
+/// Hysteresis state of one fan driven by a SmartLevelTable. The index only
+/// moves once the chosen level is actually on the fan, so a step the ramp
+/// scheduler holds back or only partly applies is not taken as done.
+struct SmartLevelState {
+    int appliedIndex{-1};       // Level entry the fan is known to be at
+    int requestedIndex{-1};     // Level entry of the last Request()
+
+    void Reset() { appliedIndex = requestedIndex = -1; }
+};
+
+/// A smart profile compiled into a 0-127 °C lookup table.
+/// Built once when the configuration changes; a control decision is then a
+/// single array index plus two threshold compares, with no allocation.
+/// Semantics match FanController::SelectSmartLevel() exactly.
+class SmartLevelTable {
+public:
+    static constexpr int kTempCount = 128;
+
+    /// Compile a profile. Invalid entries (temperature < 0) are skipped.
+    explicit SmartLevelTable(const std::vector<SmartLevelDefinition>& profile);
+
+    /// Decide the fan level for maxTemp
+    /// @param maxTemp Current (weighted) maximum temperature
+    /// @param currentLevel Level currently applied to the fan
+    /// @param lastLevelIndex Hysteresis state, -1 initially; updated on change
+    /// @return Level to command, or -1 to keep the current one
+    int Evaluate(int maxTemp, int currentLevel, int& lastLevelIndex) const;
+
+    /// Level to request this cycle: a new decision from Evaluate(), otherwise
+    /// the level of the applied entry (completing or undoing a step that was
+    /// only partly applied), otherwise currentLevel
+    int Request(int maxTemp, int currentLevel, SmartLevelState& state) const;
+
+    /// Report the level now on the fan; commits the requested entry once reached
+    void Confirm(int appliedLevel, SmartLevelState& state) const;
+
+    bool IsEmpty() const { return m_levels.empty(); }
+    int GetLevelCount() const { return (int)m_levels.size(); }
+
+private:
+    struct Level {
+        int fan;
+        int downThreshold;  // Stay at this level while temp >= threshold
+        int upThreshold;    // Don't enter this level while temp < threshold
+    };
+
+    std::vector<Level> m_levels;
+    std::array<int8_t, kTempCount> m_indexByTemp{};  // -1: below first level
+};
+
+/// Immutable set of compiled profiles, indexed like ThermalConfig::smartProfiles
+using SmartProfileSet = std::vector<SmartLevelTable>;
+
+/// Compile every profile of a configuration
+std::shared_ptr<const SmartProfileSet> CompileSmartProfiles(const ThermalConfig& config);
+
+} // namespace Core
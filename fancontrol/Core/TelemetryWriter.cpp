@@ -0,0 +1,294 @@
+// Core/TelemetryWriter.cpp - Implementation of the background telemetry writer
+#include "TelemetryWriter.h"
+#include <algorithm>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <type_traits>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace Core {
+
+namespace {
+
+std::tm LocalTime(std::time_t t) {
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    return tm;
+}
+
+/// Append an integer in little-endian byte order, whatever the host order
+template <typename T>
+void AppendLE(std::string& out, T value) {
+    auto bits = static_cast<std::make_unsigned_t<T>>(value);
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+void AppendColumn(std::string& out, const std::vector<const TelemetryRecord*>& rows, T (*get)(const TelemetryRecord&)) {
+    for (const TelemetryRecord* r : rows) {
+        AppendLE<T>(out, get(*r));
+    }
+}
+
+} // namespace
+
+TelemetryWriter::TelemetryWriter(TelemetryConfig config)
+    : m_config(std::move(config))
+{
+    m_thread = std::thread([this] { Run(); });
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool TelemetryWriter::Push(const TelemetryRecord& record) {
+    return Enqueue(record);
+}
+
+bool TelemetryWriter::PushLine(std::string line) {
+    if (m_config.format != TelemetryFormat::Csv) return false;
+    return Enqueue(std::move(line));
+}
+
+bool TelemetryWriter::Enqueue(Entry entry) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop || m_queue.size() >= m_config.queueCapacity) {
+            m_stats.dropped++;
+            return false;
+        }
+        m_queue.push_back(std::move(entry));
+        m_queued++;
+        wake = m_queue.size() == m_config.batchSize;
+    }
+    if (wake) m_wake.notify_one();
+    return true;
+}
+
+void TelemetryWriter::Flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const uint64_t target = m_queued;
+    m_flushRequested = true;
+    m_wake.notify_one();
+    m_written.wait(lock, [&] { return m_done >= target || m_stop; });
+}
+
+TelemetryStats TelemetryWriter::GetStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void TelemetryWriter::Run() {
+    const auto interval = std::chrono::milliseconds(std::max(m_config.flushIntervalMs, 10));
+    std::deque<Entry> batch;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_wake.wait_for(lock, interval, [&] {
+            return m_stop || m_flushRequested || m_queue.size() >= m_config.batchSize;
+        });
+        m_flushRequested = false;
+        if (m_queue.empty()) {
+            if (m_stop) break;
+            continue;
+        }
+
+        batch.swap(m_queue);
+        lock.unlock();
+        WriteBatch(batch);
+        const size_t count = batch.size();
+        batch.clear();
+        lock.lock();
+
+        m_done += count;
+        m_written.notify_all();
+    }
+    lock.unlock();
+    if (m_file.is_open()) m_file.close();
+}
+
+void TelemetryWriter::WriteBatch(std::deque<Entry>& batch) {
+    if (m_file.is_open()) {
+        const bool full = m_config.maxFileBytes > 0 && m_fileBytes >= m_config.maxFileBytes;
+        const bool old = m_config.rotateIntervalSec > 0
+            && std::chrono::steady_clock::now() - m_fileOpened >= std::chrono::seconds(m_config.rotateIntervalSec);
+        if (full || old) Rotate();
+    }
+    bool ok = m_file.is_open() || OpenFile();
+
+    m_buffer.clear();
+    if (ok && m_config.format == TelemetryFormat::Csv) {
+        if (m_fileBytes == 0) {
+            m_buffer += "Time";
+            for (int i = 0; i < SensorAddresses::TOTAL_COUNT; i++) m_buffer += std::format(";T{}", i);
+            m_buffer += ";MaxTemp;FanLevel;Fan1Rpm;Fan2Rpm\r\n";
+        }
+        FormatCsv(batch, m_buffer);
+    } else if (ok) {
+        FormatBinary(batch, m_buffer);
+    }
+
+    uint64_t records = 0;
+    for (const Entry& entry : batch) records += std::holds_alternative<TelemetryRecord>(entry);
+
+    if (ok && !m_buffer.empty()) {
+        m_file.write(m_buffer.data(), (std::streamsize)m_buffer.size());
+        m_file.flush();
+        ok = m_file.good();
+        if (ok) m_fileBytes += m_buffer.size();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (ok) {
+        m_stats.records += records;
+        m_stats.lines += batch.size() - records;
+        m_stats.batches++;
+        m_stats.bytesWritten += m_buffer.size();
+    } else {
+        m_stats.writeErrors++;
+        m_file.close();  // Reopen on the next batch
+        m_file.clear();
+    }
+}
+
+bool TelemetryWriter::OpenFile() {
+    m_file.clear();
+    m_file.open(m_config.path, std::ios::binary | std::ios::app);
+    if (!m_file.is_open()) return false;
+
+    std::error_code ec;
+    m_fileBytes = fs::file_size(m_config.path, ec);
+    if (ec) m_fileBytes = 0;
+    m_fileOpened = std::chrono::steady_clock::now();
+    return true;
+}
+
+void TelemetryWriter::Rotate() {
+    m_file.close();
+
+    const fs::path path(m_config.path);
+    std::tm tm = LocalTime(std::time(nullptr));
+    std::string stamp = std::format("{:04}{:02}{:02}-{:02}{:02}{:02}",
+        tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+    fs::path segment = path.parent_path() / (path.stem().string() + "." + stamp + path.extension().string());
+    std::error_code ec;
+    for (int n = 1; fs::exists(segment, ec); n++) {
+        // "_" sorts after ".", so retention still sees these as newer
+        segment = path.parent_path() / std::format("{}.{}_{:02}{}", path.stem().string(), stamp, n, path.extension().string());
+    }
+    fs::rename(path, segment, ec);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ec) m_stats.writeErrors++;
+        else m_stats.rotations++;
+    }
+    if (!ec && m_config.onRotated) m_config.onRotated(segment.string());
+    PruneSegments();
+}
+
+void TelemetryWriter::PruneSegments() {
+    const fs::path path(m_config.path);
+    const std::string prefix = path.stem().string() + ".";
+    fs::path dir = path.parent_path().empty() ? fs::path(".") : path.parent_path();
+
+    // Timestamps sort lexically, so the newest segments come last
+    std::vector<fs::path> segments;
+    std::error_code ec;
+    for (const auto& item : fs::directory_iterator(dir, ec)) {
+        std::string name = item.path().filename().string();
+        if (name.starts_with(prefix) && name != path.filename().string()) segments.push_back(item.path());
+    }
+    std::sort(segments.begin(), segments.end());
+
+    const size_t keep = (size_t)std::max(m_config.keepSegments, 0);
+    for (size_t i = 0; i + keep < segments.size(); i++) fs::remove(segments[i], ec);
+}
+
+void TelemetryWriter::FormatCsv(const std::deque<Entry>& batch, std::string& out) {
+    for (const Entry& entry : batch) {
+        if (const auto* line = std::get_if<std::string>(&entry)) {
+            out += *line;
+            continue;
+        }
+        const auto& r = std::get<TelemetryRecord>(entry);
+        std::time_t seconds = (std::time_t)(r.unixMs / 1000);
+        std::tm tm = LocalTime(seconds);
+        std::format_to(std::back_inserter(out), "{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03}",
+            tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec, (int)(r.unixMs % 1000));
+        for (int16_t temp : r.temps) {
+            if (temp != 0) std::format_to(std::back_inserter(out), ";{}", temp);
+            else out += ';';
+        }
+        std::format_to(std::back_inserter(out), ";{};{};{};{}\r\n", r.maxTemp, (int)r.fanLevel, r.fan1Rpm, r.fan2Rpm);
+    }
+}
+
+void TelemetryWriter::FormatBinary(const std::deque<Entry>& batch, std::string& out) {
+    std::vector<const TelemetryRecord*> rows;
+    rows.reserve(batch.size());
+    for (const Entry& entry : batch) {
+        if (const auto* record = std::get_if<TelemetryRecord>(&entry)) rows.push_back(record);
+    }
+    if (rows.empty()) return;
+
+    TelemetryBlockHeader header{kBlockMagic, 1, (uint16_t)SensorAddresses::TOTAL_COUNT, (uint32_t)rows.size()};
+    AppendLE(out, header.magic);
+    AppendLE(out, header.version);
+    AppendLE(out, header.sensors);
+    AppendLE(out, header.rows);
+
+    AppendColumn<int64_t>(out, rows, [](const TelemetryRecord& r) { return r.unixMs; });
+    for (int i = 0; i < SensorAddresses::TOTAL_COUNT; i++) {
+        for (const TelemetryRecord* r : rows) {
+            AppendLE(out, r->temps[i]);
+        }
+    }
+    AppendColumn<int16_t>(out, rows, [](const TelemetryRecord& r) { return r.maxTemp; });
+    AppendColumn<uint8_t>(out, rows, [](const TelemetryRecord& r) { return r.fanLevel; });
+    AppendColumn<uint16_t>(out, rows, [](const TelemetryRecord& r) { return r.fan1Rpm; });
+    AppendColumn<uint16_t>(out, rows, [](const TelemetryRecord& r) { return r.fan2Rpm; });
+}
+
+void TelemetryRecorder::OnFanStateChange(const FanStateChangeEvent& event) {
+    m_fan = event;
+}
+
+void TelemetryRecorder::OnTemperatureUpdate(const TemperatureUpdateEvent& event) {
+    if (!event.sensors) return;
+
+    TelemetryRecord record;
+    auto age = std::chrono::steady_clock::now() - event.timestamp;
+    record.unixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch() - age).count();
+    for (const auto& reading : *event.sensors) {
+        if (reading.index < 0 || reading.index >= SensorAddresses::TOTAL_COUNT) continue;
+        if (reading.isAvailable && reading.rawTemp > 0 && reading.rawTemp < 128) {
+            record.temps[reading.index] = (int16_t)reading.rawTemp;
+        }
+    }
+    record.maxTemp = (int16_t)event.maxTemp;
+    record.fanLevel = (uint8_t)m_fan.currentLevel;
+    record.fan1Rpm = (uint16_t)std::clamp(m_fan.fan1Speed, 0, 65535);
+    record.fan2Rpm = (uint16_t)std::clamp(m_fan.fan2Speed, 0, 65535);
+    m_writer.Push(record);
+}
+
+} // namespace Core
@@ -0,0 +1,161 @@
+// Core/TelemetryWriter.h - Background telemetry (CSV / binary) writer with rotation
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "IThermalObserver.h"
+#include "SensorConfig.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <variant>
+
+namespace Core {
+
+enum class TelemetryFormat {
+    Csv,        // One ';'-separated line per record, header at the top of every file
+    Binary      // Columnar blocks, one per batch (see TelemetryWriter)
+};
+
+/// One telemetry sample
+struct TelemetryRecord {
+    int64_t unixMs = 0;
+    std::array<int16_t, SensorAddresses::TOTAL_COUNT> temps{};  // °C, 0 = unavailable
+    int16_t maxTemp = 0;
+    uint8_t fanLevel = 0;       // EC value, 0x80 = BIOS
+    uint16_t fan1Rpm = 0;
+    uint16_t fan2Rpm = 0;
+};
+
+struct TelemetryConfig {
+    std::string path;                   // Active file; rotated segments get a timestamp before the extension
+    TelemetryFormat format = TelemetryFormat::Csv;
+    size_t queueCapacity = 4096;        // Entries waiting for the writer; more are dropped
+    size_t batchSize = 256;             // Wake the writer early at this many entries
+    int flushIntervalMs = 2000;         // Longest time an entry waits in memory
+    uint64_t maxFileBytes = 10u << 20;  // Rotate at this size (0 = never)
+    int rotateIntervalSec = 0;          // Rotate after this long (0 = never)
+    int keepSegments = 5;               // Rotated segments kept, older ones are deleted
+
+    /// Called on the writer thread for every rotated segment, e.g. to compress it.
+    /// Files it creates next to the segment count toward keepSegments.
+    std::function<void(const std::string& segmentPath)> onRotated;
+};
+
+struct TelemetryStats {
+    uint64_t records = 0;       // Records written
+    uint64_t lines = 0;         // Text lines written
+    uint64_t dropped = 0;       // Entries rejected because the queue was full
+    uint64_t batches = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t rotations = 0;
+    uint64_t writeErrors = 0;
+};
+
+/// Writes telemetry from a background thread so producers never touch a file.
+///
+/// Push() and PushLine() only append to a bounded queue. The writer thread
+/// takes the whole queue every flushIntervalMs (or once batchSize entries are
+/// waiting), formats it and writes it with a single write call.
+///
+/// Before a batch the active file is rotated when it reached maxFileBytes or is
+/// older than rotateIntervalSec: it is renamed to "<stem>.<YYYYmmdd-HHMMSS><ext>",
+/// onRotated runs, and all but the newest keepSegments files with that prefix
+/// are deleted.
+///
+/// Binary files are a sequence of blocks, each a TelemetryBlockHeader followed
+/// by the columns of its rows: unixMs (int64), temps (int16, one column per
+/// sensor), maxTemp (int16), fanLevel (uint8), fan1Rpm, fan2Rpm (uint16).
+/// Header and values are serialized field by field in little-endian order on
+/// any host. Use a path of its own for binary telemetry: the active file is
+/// appended to, and CSV lines in it would corrupt the block stream.
+class TelemetryWriter {
+public:
+    /// Layout of a block header on disk (12 bytes, little-endian, no padding)
+    struct TelemetryBlockHeader {
+        uint32_t magic;         // kBlockMagic
+        uint16_t version;
+        uint16_t sensors;
+        uint32_t rows;
+    };
+    static constexpr uint32_t kBlockMagic = 0x54465054;  // "TPFT"
+
+    explicit TelemetryWriter(TelemetryConfig config);
+
+    /// Writes what is still queued, then stops the thread
+    ~TelemetryWriter();
+
+    TelemetryWriter(const TelemetryWriter&) = delete;
+    TelemetryWriter& operator=(const TelemetryWriter&) = delete;
+
+    /// Queue a record; false if the queue is full
+    bool Push(const TelemetryRecord& record);
+
+    /// Queue a preformatted text line (written as-is, Csv format only)
+    /// @return false if the queue is full or the format is Binary
+    bool PushLine(std::string line);
+
+    /// Block until everything queued so far has been written
+    void Flush();
+
+    TelemetryStats GetStats() const;
+
+private:
+    using Entry = std::variant<TelemetryRecord, std::string>;
+
+    bool Enqueue(Entry entry);
+    void Run();
+    void WriteBatch(std::deque<Entry>& batch);
+    bool OpenFile();
+    void Rotate();
+    void PruneSegments();
+    void FormatCsv(const std::deque<Entry>& batch, std::string& out);
+    void FormatBinary(const std::deque<Entry>& batch, std::string& out);
+
+    TelemetryConfig m_config;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_written;
+    std::deque<Entry> m_queue;
+    uint64_t m_queued{0};           // Entries accepted so far
+    uint64_t m_done{0};             // Entries written (or failed) so far
+    bool m_flushRequested{false};
+    bool m_stop{false};
+    TelemetryStats m_stats;
+
+    // Writer thread only
+    std::ofstream m_file;
+    uint64_t m_fileBytes{0};
+    std::chrono::steady_clock::time_point m_fileOpened;
+    std::string m_buffer;
+
+    std::thread m_thread;
+};
+
+/// Turns temperature and fan events into telemetry records. Subscribe it with
+/// queued delivery; every temperature update yields one record carrying the
+/// last known fan state.
+class TelemetryRecorder : public ThermalObserverBase {
+public:
+    explicit TelemetryRecorder(TelemetryConfig config) : m_writer(std::move(config)) {}
+
+    TelemetryWriter& Writer() { return m_writer; }
+
+protected:
+    void OnTemperatureUpdate(const TemperatureUpdateEvent& event) override;
+    void OnFanStateChange(const FanStateChangeEvent& event) override;
+
+private:
+    TelemetryWriter m_writer;
+    FanStateChangeEvent m_fan{};
+};
+
+} // namespace Core
@@ -2,36 +2,76 @@
 #include "ThermalManager.h"
 #include <format>
 #include <algorithm>
+#include <utility>
 
 namespace Core {
 
+namespace {
+
+/// Fixed control period of a configuration in ms
+int BasePeriodMs(const ThermalConfig& config) {
+    if (config.cycle.periodMs > 0) return std::max(config.cycle.periodMs, 50);
+    return std::max(config.cycleSeconds, 1) * 1000;
+}
+
+/// Sub-second cycles read each sensor once instead of double sampling
+constexpr int kSingleSamplePeriodMs = 1000;
+
+/// How long the watchdog fail-safe waits for a preempted worker to release the EC
+constexpr int kFailSafeLockMs = 2000;
+
+} // namespace
+
 ThermalManager::ThermalManager(
     std::shared_ptr<ECManager> ecManager,
     const ThermalConfig& config
 )
     : m_ecManager(std::move(ecManager))
-    , m_config(config)
+    , m_activeConfig(std::make_shared<const ConfigSnapshot>(ConfigSnapshot{1, config}))
+    , m_watchdog([this](std::chrono::milliseconds overdue, int attempt) {
+          return ForceBiosFailSafe(overdue, attempt);
+      })
 {
+    m_publishedConfig.store(m_activeConfig);
+    
+    m_log.SetSink(
+        [this](LogLevel level, std::chrono::steady_clock::time_point time, std::string message) {
+            m_dispatcher.Dispatch(LogEvent{
+                .timestamp = time,
+                .level = level,
+                .message = std::move(message)
+            });
+        },
+        [this](LogLevel) { return m_dispatcher.HasSubscribers<LogEvent>(); });
+    
     // Create sensor manager with the EC manager
     m_sensorManager = std::make_unique<SensorManager>(m_ecManager);
     Log(LogLevel::Info, "Internal SensorManager created.");
     
     // Create fan controller
     m_fanController = std::make_unique<FanController>(m_ecManager);
-    m_fanController->SetDualFanMode(m_config.isDualFan);
-    m_fanController->SetFanSpeedAddr(m_config.fanSpeedAddr);
+    m_fanController->SetDualFanMode(config.isDualFan);
+    m_fanController->SetFanSpeedAddr(config.fanSpeedAddr);
+    m_activeDualFan.store(config.isDualFan);
     
     // Apply initial sensor configuration
-    for (const auto& sensor : m_config.sensors) {
+    for (const auto& sensor : config.sensors) {
         m_sensorManager->SetOffset(sensor.index, sensor.offset, sensor.hystMin, sensor.hystMax);
         m_sensorManager->SetSensorName(sensor.index, sensor.name);
         m_sensorManager->SetSensorWeight(sensor.index, sensor.weight);
     }
     
+    m_smartTables.store(CompileSmartProfiles(config));
+    m_targetRpm.store(std::max(config.rpm.targetRpm, 0));
+    m_cyclePeriodMs.store(BasePeriodMs(config));
+    for (auto& ramp : m_fanRamps) ramp.SetConfig(config.ramp);
+    m_rpmController.SetConfig(config.rpm);
+    
     // Initialize state
     m_state.currentMode = ControlMode::BIOS;
     m_state.isOperational = false;
     m_state.sensors.resize(SensorAddresses::TOTAL_COUNT);
+    PublishState();
     
     m_lastCycleTime = std::chrono::steady_clock::now();
 }
@@ -47,6 +87,7 @@ void ThermalManager::Start() {
     
     Log(LogLevel::Info, "ThermalManager starting...");
     
+    m_watchdog.Start();
     m_workerThread = std::jthread([this](std::stop_token token) {
         WorkerLoop(token);
     });
@@ -66,18 +107,33 @@ void ThermalManager::Stop() {
     if (m_workerThread.joinable()) {
         m_workerThread.join();
     }
+    m_watchdog.Disarm();
+    m_watchdog.Stop();
     
-    // Return fan control to BIOS
+    // Return fan control to BIOS, even if the shadow state claims it already is
     if (m_fanController) {
-        m_fanController->SetFanLevel(0x80); // BIOS control
+        m_fanController->ReapplyFanLevel(0x80); // BIOS control
     }
     
     Log(LogLevel::Info, "ThermalManager stopped.");
+    m_log.Flush();
 }
 
 ThermalState ThermalManager::GetState() const {
-    std::lock_guard<std::mutex> lock(m_stateMutex);
-    return m_state;
+    return *m_snapshot.load();
+}
+
+void ThermalManager::PublishState() {
+    std::shared_ptr<ThermalState> snapshot;
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        version = ++m_state.version;
+        snapshot = std::make_shared<ThermalState>(m_state);
+    }
+    // Store the pointer before the version so a reader seeing version N finds snapshot >= N
+    m_snapshot.store(std::move(snapshot));
+    m_stateVersion.store(version, std::memory_order_release);
 }
 
 ControlMode ThermalManager::GetMode() const {
@@ -93,61 +149,170 @@ void ThermalManager::SetMode(ControlMode mode, int smartProfile) {
     m_smartProfile.store(smartProfile);
     
     if (oldMode != mode) {
-        ModeChangeEvent event{
+        m_dispatcher.Dispatch(ModeChangeEvent{
             .timestamp = std::chrono::steady_clock::now(),
             .newMode = mode,
             .previousMode = oldMode,
             .smartProfileIndex = smartProfile
-        };
-        m_dispatcher.Dispatch(event);
+        });
         
-        Log(LogLevel::Info, std::format("Mode changed from {} to {}", 
-            static_cast<int>(oldMode), static_cast<int>(mode)));
+        Log(LogLevel::Info, "Mode changed from {} to {}", 
+            static_cast<int>(oldMode), static_cast<int>(mode));
         
         // Force an immediate update when mode changes
-        m_forceUpdate.store(true);
+        RequestWake(WakeReason::ModeChange);
+    }
+}
+
+void ThermalManager::SetTargetRpm(int rpm) {
+    m_targetRpm.store(std::max(rpm, 0));
+    if (m_mode.load() == ControlMode::RPM) {
+        RequestWake(WakeReason::Setpoint);
     }
 }
 
+void ThermalManager::SetThermalModels(std::shared_ptr<const ThermalModelEstimator> models) {
+    std::lock_guard<std::mutex> lock(m_configMutex);
+    m_thermalModels = std::move(models);
+}
+
 void ThermalManager::SetManualLevel(int level) {
     m_manualLevel.store(std::clamp(level, 0, 7));
     if (m_mode.load() == ControlMode::Manual) {
-        m_forceUpdate.store(true);
+        RequestWake(WakeReason::Setpoint);
     }
 }
 
 void ThermalManager::UpdateConfig(const ThermalConfig& config) {
+    uint64_t version;
     {
         std::lock_guard<std::mutex> lock(m_configMutex);
-        m_config = config;
+        version = m_publishedConfig.load()->version + 1;
+        m_publishedConfig.store(std::make_shared<const ConfigSnapshot>(ConfigSnapshot{version, config}));
     }
+    Log(LogLevel::Info, "Configuration v{} published", version);
     
-    // Reapply hardware settings
-    if (m_fanController) {
+    // The worker diffs and applies it at the start of its next cycle
+    RequestWake(WakeReason::Config);
+}
+
+void ThermalManager::SyncConfig() {
+    auto published = m_publishedConfig.load();
+    if (published == m_activeConfig) {
+        return;
+    }
+    const ThermalConfig& config = published->config;
+    ConfigDiff diff = DiffConfig(m_activeConfig->config, config);
+    m_activeConfig = std::move(published);
+    
+    if (diff.hardware) {
         m_fanController->SetDualFanMode(config.isDualFan);
         m_fanController->SetFanSpeedAddr(config.fanSpeedAddr);
+        m_activeDualFan.store(config.isDualFan);
     }
-
-    // Reapply sensor configuration
     for (const auto& sensor : config.sensors) {
-        m_sensorManager->SetOffset(sensor.index, sensor.offset, sensor.hystMin, sensor.hystMax);
-        m_sensorManager->SetSensorName(sensor.index, sensor.name);
-        m_sensorManager->SetSensorWeight(sensor.index, sensor.weight);
+        auto changed = [&sensor](const std::vector<int>& indices) {
+            return std::find(indices.begin(), indices.end(), sensor.index) != indices.end();
+        };
+        if (changed(diff.sensorOffsets)) {
+            m_sensorManager->SetOffset(sensor.index, sensor.offset, sensor.hystMin, sensor.hystMax);
+        }
+        if (changed(diff.sensorNames)) m_sensorManager->SetSensorName(sensor.index, sensor.name);
+        if (changed(diff.sensorWeights)) m_sensorManager->SetSensorWeight(sensor.index, sensor.weight);
+    }
+    // A dropped sensor goes back to the unconfigured defaults
+    for (int index : diff.sensorsRemoved) {
+        const SensorDefinition unconfigured;
+        m_sensorManager->SetOffset(index, unconfigured.offset, unconfigured.hystMin, unconfigured.hystMax);
+        m_sensorManager->SetSensorName(index, unconfigured.name);
+        m_sensorManager->SetSensorWeight(index, unconfigured.weight);
     }
     
-    Log(LogLevel::Info, "Configuration updated");
+    // A recompiled table resets the smart-mode hysteresis, so only on real edits
+    if (diff.smartProfiles) m_smartTables.store(CompileSmartProfiles(config));
+    if (diff.ramp) {
+        for (auto& ramp : m_fanRamps) ramp.SetConfig(config.ramp);
+    }
+    if (diff.fanZones || diff.smartProfiles || diff.pid) {
+        for (auto& zone : m_fanZones) zone.Reset();
+    }
+    if (diff.rpm) m_rpmController.SetConfig(config.rpm);
+    if (diff.cyclePeriod) m_cyclePeriodMs.store(BasePeriodMs(config));
+    if (diff.thresholds) m_cycleThresholdsDirty.store(true);
+    
+    Log(LogLevel::Info, "Configuration v{} applied: {}", m_activeConfig->version, diff.Describe());
 }
 
 void ThermalManager::ForceUpdate() {
-    m_forceUpdate.store(true);
+    RequestWake(WakeReason::ForceUpdate);
+}
+
+void ThermalManager::RequestWake(WakeReason reason) {
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeReasons |= static_cast<unsigned>(reason);
+    }
+    m_wakeCv.notify_all();
+}
+
+void ThermalManager::StartAutotune(const AutotuneSettings& settings) {
+    AutotuneSettings seeded = settings;
+    if (!seeded.hasSeed) {
+        int sensorIndex;
+        {
+            std::lock_guard<std::mutex> lock(m_stateMutex);
+            sensorIndex = m_state.maxTempIndex;
+        }
+        seeded.hasSeed = SuggestModelGains(sensorIndex, m_publishedConfig.load()->config.pid,
+                                           settings.setpoint, seeded.seed);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_autotuneMutex);
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        m_autotuner.Start(seeded, now);
+    }
+    Log(LogLevel::Info, "Autotune started: setpoint {:.1f}, relay {}/{}",
+        settings.setpoint, settings.lowLevel, settings.highLevel);
+    if (seeded.hasSeed) {
+        Log(LogLevel::Info, "Autotune seeded from the thermal model: Kp={:.3f}, Ki={:.4f}",
+            seeded.seed.Kp, seeded.seed.Ki);
+    }
+    RequestWake(WakeReason::Autotune);
 }
 
-EventDispatcher::SubscriptionId ThermalManager::Subscribe(EventDispatcher::Callback callback) {
-    return m_dispatcher.Subscribe(std::move(callback));
+void ThermalManager::CancelAutotune() {
+    {
+        std::lock_guard<std::mutex> lock(m_autotuneMutex);
+        if (!m_autotuner.IsActive()) return;
+        m_autotuner.Cancel();
+    }
+    Log(LogLevel::Info, "Autotune cancelled");
+    RequestWake(WakeReason::Autotune);
 }
 
-EventDispatcher::SubscriptionId ThermalManager::Subscribe(std::weak_ptr<IThermalObserver> observer) {
-    return m_dispatcher.Subscribe(std::move(observer));
+AutotuneProgress ThermalManager::GetAutotuneProgress() const {
+    std::lock_guard<std::mutex> lock(m_autotuneMutex);
+    return m_autotuner.GetProgress();
+}
+
+PIDConfig ThermalManager::GetAutotuneResult() const {
+    {
+        std::lock_guard<std::mutex> lock(m_autotuneMutex);
+        if (m_autotuner.GetProgress().phase == AutotunePhase::Success) {
+            return m_autotuneResult;
+        }
+    }
+    return m_publishedConfig.load()->config.pid;
+}
+
+EventDispatcher::SubscriptionId ThermalManager::Subscribe(EventDispatcher::Callback callback,
+                                                          const EventDeliveryOptions& options) {
+    return m_dispatcher.Subscribe(std::move(callback), options);
+}
+
+EventDispatcher::SubscriptionId ThermalManager::Subscribe(std::weak_ptr<IThermalObserver> observer,
+                                                          const EventDeliveryOptions& options) {
+    return m_dispatcher.Subscribe(std::move(observer), options);
 }
 
 void ThermalManager::Unsubscribe(EventDispatcher::SubscriptionId id) {
@@ -157,40 +322,82 @@ void ThermalManager::Unsubscribe(EventDispatcher::SubscriptionId id) {
 void ThermalManager::WorkerLoop(std::stop_token stopToken) {
     Log(LogLevel::Debug, "Worker thread started");
     
-    int cycleMs;
-    {
-        std::lock_guard<std::mutex> lock(m_configMutex);
-        cycleMs = m_config.cycleSeconds * 1000;
-    }
+    using Clock = std::chrono::steady_clock;
+    auto period = std::chrono::milliseconds(m_cyclePeriodMs.load());
+    SyncConfig();
+    int tachMs = std::max(Config().rpm.loopMs, 20);
+    
+    // Cycles run on an absolute grid: deadline(n) = deadline(n-1) + period.
+    // Cycle duration, EC retries and forced cycles never shift the grid.
+    auto deadline = Clock::now();
+    bool scheduled = true;
     
     while (!stopToken.stop_requested()) {
-        auto cycleStart = std::chrono::steady_clock::now();
+        auto cycleStart = Clock::now();
+        BeatWatchdog(cycleStart);
         
         // Perform control cycle
         PerformCycle();
+        RecordCycleTiming(scheduled, cycleStart - deadline);
+        PublishState();
         
-        // Wait for next cycle, but wake up early if force update is requested
-        auto cycleEnd = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(cycleEnd - cycleStart);
-        auto sleepTime = std::chrono::milliseconds(cycleMs) - elapsed;
+        if (scheduled) {
+            deadline += period;
+        }
+        auto cycleEnd = Clock::now();
+        if (scheduled && cycleEnd >= deadline) {
+            // Skip the slots we overran instead of bursting to catch up.
+            // A forced cycle that runs past the deadline is no miss: the
+            // scheduled cycle of that slot follows right after it.
+            auto missed = (cycleEnd - deadline) / period + 1;
+            m_schedulerStats.missedDeadlines += missed;
+            deadline += missed * period;
+        }
         
-        if (sleepTime > std::chrono::milliseconds(0)) {
-            // Sleep in small intervals to be responsive to stop requests
-            auto sleepEnd = cycleEnd + sleepTime;
-            while (!stopToken.stop_requested() && 
-                   !m_forceUpdate.load() &&
-                   std::chrono::steady_clock::now() < sleepEnd) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Block until the next deadline, a control change wakes us, or
+        // stop is requested (the stop token notifies the condition variable).
+        // In RPM mode the tach loop runs in between thermal cycles.
+        auto nextTach = cycleEnd + std::chrono::milliseconds(tachMs);
+        BeatWatchdog(deadline);
+        unsigned reasons;
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            while (true) {
+                bool tach = m_mode.load() == ControlMode::RPM && m_rpmActive;
+                auto until = tach ? std::min(deadline, nextTach) : deadline;
+                if (m_wakeCv.wait_until(lock, stopToken, until, [this] { return m_wakeReasons != 0; })) {
+                    break;
+                }
+                if (stopToken.stop_requested() || !tach || Clock::now() >= deadline) {
+                    break;
+                }
+                lock.unlock();
+                BeatWatchdog(Clock::now());
+                PerformTachCycle();
+                PublishState();
+                BeatWatchdog(deadline);
+                nextTach += std::chrono::milliseconds(tachMs);
+                lock.lock();
             }
+            reasons = std::exchange(m_wakeReasons, 0u);
+        }
+        scheduled = Clock::now() >= deadline;
+        
+        if (reasons != 0) {
+            Log(LogLevel::Debug, "Worker woken early (reasons 0x{:02X})", reasons);
         }
         
-        m_forceUpdate.store(false);
+        // Adopt a newly published config once per cycle
+        SyncConfig();
         
-        // Update config-based timing
-        {
-            std::lock_guard<std::mutex> lock(m_configMutex);
-            cycleMs = m_config.cycleSeconds * 1000;
+        // A new period re-anchors the grid on the last scheduled cycle
+        auto newPeriod = std::chrono::milliseconds(m_cyclePeriodMs.load());
+        if (newPeriod != period) {
+            deadline += newPeriod - period;
+            period = newPeriod;
+            scheduled = Clock::now() >= deadline;
         }
+        tachMs = std::max(Config().rpm.loopMs, 20);
     }
     
     Log(LogLevel::Debug, "Worker thread exiting");
@@ -201,25 +408,149 @@ void ThermalManager::PerformCycle() {
     float dt = std::chrono::duration<float>(now - m_lastCycleTime).count();
     m_lastCycleTime = now;
     
+    m_profiler.BeginCycle();
+    
     // Update sensors
-    if (!UpdateSensors()) {
+    bool sensorsOk = UpdateSensors(m_cyclePeriodMs.load() < kSingleSamplePeriodMs);
+    
+    if (!sensorsOk) {
         ReportError(ErrorSeverity::Error, "ThermalManager", 
                     "Critical: Failed to communicate with EC! Sensor readings stopped.", 0xFF01);
-        return;
+    } else {
+        // Apply control based on mode (fan writes inside are timed as FanWrite)
+        CycleProfiler::Scope scope(m_profiler, CyclePhase::ControlDecision);
+        ApplyControl(dt);
+        UpdateCyclePeriod(dt);
     }
+    m_profiler.EndCycle();
+    m_schedulerStats.lastCycle = m_profiler.LastCycle();
+    PublishProfile();
+}
+
+void ThermalManager::PublishProfile() {
+    CycleProfile profile = m_profiler.Snapshot();
+    ECManager::Counters ec = m_ecManager->GetCounters();
+    profile.ec = ECTrafficStats{
+        .bytesRead = ec.bytesRead,
+        .bytesWritten = ec.bytesWritten,
+        .timeouts = ec.timeouts,
+        .retries = ec.retries,
+        .typeSwitches = ec.typeSwitches
+    };
     
-    // Apply control based on mode
-    ApplyControl(dt);
+    if (m_dispatcher.HasSubscribers<CycleProfileEvent>()) {
+        m_dispatcher.Dispatch(CycleProfileEvent{
+            .timestamp = std::chrono::steady_clock::now(),
+            .profile = profile
+        });
+    }
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state.profile = profile;
 }
 
-bool ThermalManager::UpdateSensors() {
-    bool useBiasedTemps, noExtSensor;
+void ThermalManager::UpdateCyclePeriod(float dt) {
+    const CycleConfig& cycle = Config().cycle;
+    const ControlMode mode = m_mode.load();
+    const int smartProfile = m_smartProfile.load();
+    if (m_cycleThresholdsDirty.exchange(false) || mode != m_thresholdMode || smartProfile != m_thresholdProfile) {
+        m_adaptiveCycle.SetThresholds(AdaptiveCycle::CollectThresholds(Config(), mode, smartProfile));
+        m_thresholdMode = mode;
+        m_thresholdProfile = smartProfile;
+    }
+    if (!cycle.adaptive) {
+        return;
+    }
+    
+    int maxTemp;
     {
-        std::lock_guard<std::mutex> lock(m_configMutex);
-        useBiasedTemps = m_config.useBiasedTemps;
-        noExtSensor = m_config.noExtSensor;
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        maxTemp = m_state.maxTemp;
+    }
+    int periodMs = m_adaptiveCycle.Update(maxTemp, dt, cycle);
+    if (periodMs != m_cyclePeriodMs.load()) {
+        Log(LogLevel::Debug, "Cycle period {} ms (rise {:.2f}°C/s)",
+            periodMs, m_adaptiveCycle.GetRiseRate());
+        m_cyclePeriodMs.store(periodMs);
+    }
+}
+
+void ThermalManager::RecordCycleTiming(bool scheduled, std::chrono::steady_clock::duration lateness) {
+    SchedulerStats& stats = m_schedulerStats;
+    stats.cycles++;
+    
+    if (!scheduled) {
+        stats.forcedCycles++;
+    } else {
+        auto jitterUs = static_cast<uint32_t>(std::max<int64_t>(0,
+            std::chrono::duration_cast<std::chrono::microseconds>(lateness).count()));
+        const auto& bounds = SchedulerStats::kJitterBoundsUs;
+        auto bucket = std::upper_bound(bounds.begin(), bounds.end(), jitterUs) - bounds.begin();
+        stats.jitterHistogram[bucket]++;
+        stats.maxJitterUs = std::max(stats.maxJitterUs, jitterUs);
+    }
+    
+    if (stats.lastCycle.TotalUs() > static_cast<uint32_t>(m_cyclePeriodMs.load()) * 1000u) {
+        stats.overruns++;
+    }
+    if (stats.lastCycle.TotalUs() >= stats.worstCycle.TotalUs()) {
+        stats.worstCycle = stats.lastCycle;
+    }
+    
+    WatchdogStats watchdog = m_watchdog.GetStats();
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state.scheduler = stats;
+    m_state.watchdog = watchdog;
+}
+
+void ThermalManager::BeatWatchdog(std::chrono::steady_clock::time_point due) {
+    const WatchdogConfig& config = Config().watchdog;
+    if (!config.enabled) {
+        m_watchdog.Disarm();
+        return;
+    }
+    if (m_watchdog.Beat(due + std::chrono::milliseconds(std::max(config.stallMs, 100)))) {
+        // The fan may still be under BIOS control; the next cycle reads it back and takes over
+        Log(LogLevel::Warning, "Control worker recovered after a {} ms stall",
+            m_watchdog.GetStats().lastStallMs);
+    }
+}
+
+bool ThermalManager::ForceBiosFailSafe(std::chrono::milliseconds overdue, int attempt) {
+    // A worker stuck inside an EC transaction is preempted and lets go of the
+    // EC mutex; the fail-safe then writes under the lock like any other caller.
+    // FanController state belongs to the worker, so the EC is written directly.
+    auto lock = m_ecManager->Preempt(kFailSafeLockMs);
+    if (!lock.owns_lock()) {
+        if (attempt == 1) {
+            ReportError(ErrorSeverity::Critical, "Watchdog", std::format(
+                "Control cycle {} ms overdue, EC still busy, retrying the BIOS fail-safe", overdue.count()));
+        }
+        return false;
     }
     
+    bool ok = true;
+    if (m_activeDualFan.load()) {
+        ok = m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN2) &&
+             m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)0x80);
+        ok = m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN1) && ok;
+    }
+    ok = m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)0x80) && ok;
+    lock.unlock();
+    
+    if (ok) {
+        ReportError(ErrorSeverity::Critical, "Watchdog", std::format(
+            "Control cycle {} ms overdue, fan handed to BIOS control", overdue.count()));
+    } else if (attempt == 1) {
+        ReportError(ErrorSeverity::Critical, "Watchdog", std::format(
+            "Control cycle {} ms overdue, BIOS fail-safe write failed, retrying", overdue.count()));
+    }
+    return ok;
+}
+
+bool ThermalManager::UpdateSensors(bool singleSample) {
+    const bool useBiasedTemps = Config().useBiasedTemps;
+    const bool noExtSensor = Config().noExtSensor;
+    
     // Legacy-style double sampling and retry logic to ensure reliable EC communication
     int numTries = 10;
     int sleepTicks = 200;
@@ -227,22 +558,36 @@ bool ThermalManager::UpdateSensors() {
     bool success = false;
     int fan1 = 0, fan2 = 0;
     int maxTemp = 0, maxIndex = 0;
-    std::vector<SensorReading> readings;
     int currentLevel = 0;
+    
+    if (!m_sensorPayload || m_sensorPayload.use_count() > 1) {
+        m_sensorPayload = std::make_shared<std::vector<SensorReading>>(SensorAddresses::TOTAL_COUNT);
+    }
+    auto& readings = *m_sensorPayload;
+    
+    // Temperatures plus the fan control register, timed separately
+    auto readSample = [&]() {
+        {
+            CycleProfiler::Scope scope(m_profiler, CyclePhase::SensorRead);
+            if (!m_sensorManager->UpdateSensors(useBiasedTemps, noExtSensor, false)) return false;
+        }
+        CycleProfiler::Scope scope(m_profiler, CyclePhase::FanLevelRead);
+        return m_fanController->RefreshCurrentLevel();
+    };
 
     for (int i = 0; i < numTries; i++) {
+        if (i > 0) m_profiler.CountSampleRetry();
+        
         // Sample 1
-        if (!m_sensorManager->UpdateSensors(useBiasedTemps, noExtSensor, false) ||
-            !m_fanController->RefreshCurrentLevel()) {
+        if (!readSample()) {
             Log(LogLevel::Warning, "Cycle sample1 failed: sensor or fan level read error");
             std::this_thread::sleep_for(std::chrono::milliseconds(sleepTicks));
             continue;
         }
         int level1 = m_fanController->GetCurrentLevel();
 
-        // Sample 2
-        if (!m_sensorManager->UpdateSensors(useBiasedTemps, noExtSensor, false) ||
-            !m_fanController->RefreshCurrentLevel()) {
+        // Sample 2 (skipped on fast cycles, where the next cycle is the confirmation)
+        if (!singleSample && !readSample()) {
             Log(LogLevel::Warning, "Cycle sample2 failed: sensor or fan level read error");
             std::this_thread::sleep_for(std::chrono::milliseconds(sleepTicks));
             continue;
@@ -253,7 +598,12 @@ bool ThermalManager::UpdateSensors() {
         if (level1 == level2) {
             currentLevel = level2;
 
-            if (!m_fanController->GetFanSpeeds(fan1, fan2)) {
+            bool tachOk;
+            {
+                CycleProfiler::Scope scope(m_profiler, CyclePhase::TachRead);
+                tachOk = m_fanController->GetFanSpeeds(fan1, fan2);
+            }
+            if (!tachOk) {
                 Log(LogLevel::Warning, "Fan tach read failed after sensor sync; retrying sample");
                 std::this_thread::sleep_for(std::chrono::milliseconds(sleepTicks));
                 continue;
@@ -261,26 +611,20 @@ bool ThermalManager::UpdateSensors() {
 
             EvaluateFanFeedback(currentLevel, fan1);
             
-            std::string ignoreList;
-            {
-                std::lock_guard<std::mutex> lock(m_configMutex);
-                ignoreList = m_config.ignoreList;
-            }
-            maxTemp = m_sensorManager->GetMaxTemp(maxIndex, ignoreList);
+            CycleProfiler::Scope scope(m_profiler, CyclePhase::MaxTemp);
+            maxTemp = m_sensorManager->GetMaxTemp(maxIndex, Config().ignoreList);
             
-            readings.clear();
-            readings.reserve(SensorAddresses::TOTAL_COUNT);
+            // Assign field by field so the name strings keep their buffers
             for (int j = 0; j < SensorAddresses::TOTAL_COUNT; j++) {
                 const auto& sensor = m_sensorManager->GetSensor(j);
-                readings.push_back({
-                    .index = j,
-                    .address = sensor.addr,
-                    .name = sensor.name,
-                    .rawTemp = sensor.rawTemp,
-                    .biasedTemp = sensor.biasedTemp,
-                    .weight = sensor.weight,
-                    .isAvailable = sensor.isAvailable
-                });
+                auto& reading = readings[j];
+                reading.index = j;
+                reading.address = sensor.addr;
+                reading.name = sensor.name;
+                reading.rawTemp = sensor.rawTemp;
+                reading.biasedTemp = sensor.biasedTemp;
+                reading.weight = sensor.weight;
+                reading.isAvailable = sensor.isAvailable;
             }
             success = true;
             break;
@@ -309,20 +653,24 @@ bool ThermalManager::UpdateSensors() {
         m_state.fanState.fan1Speed = fan1;
         m_state.fanState.fan2Speed = fan2;
         m_state.fanState.currentLevel = currentLevel;
+        m_state.fanState.fan2Level = m_fanController->GetFanLevel(1);
         m_state.fanState.isDualFan = m_fanController->IsDualFanActive();
         m_state.currentMode = m_mode.load();
         m_state.smartProfileIndex = m_smartProfile.load();
+        m_state.configVersion = m_activeConfig->version;
         m_state.isOperational = true;
     }
 
-    FanStateChangeEvent fanEvent{
-        .timestamp = std::chrono::steady_clock::now(),
-        .fan1Speed = fan1,
-        .fan2Speed = fan2,
-        .currentLevel = currentLevel,
-        .previousLevel = previousFanState.currentLevel
-    };
-    m_dispatcher.Dispatch(fanEvent);
+    CycleProfiler::Scope dispatchScope(m_profiler, CyclePhase::EventDispatch);
+    if (m_dispatcher.HasSubscribers<FanStateChangeEvent>()) {
+        m_dispatcher.Dispatch(FanStateChangeEvent{
+            .timestamp = std::chrono::steady_clock::now(),
+            .fan1Speed = fan1,
+            .fan2Speed = fan2,
+            .currentLevel = currentLevel,
+            .previousLevel = previousFanState.currentLevel
+        });
+    }
 
     if (!m_state.isOperational || availableCount == 0) {
         static int warnCounter = 0;
@@ -331,22 +679,64 @@ bool ThermalManager::UpdateSensors() {
         }
     }
     
-    // Dispatch temperature update event
-    TemperatureUpdateEvent event{
-        .timestamp = std::chrono::steady_clock::now(),
-        .sensors = readings,
-        .maxTempIndex = maxIndex,
-        .maxTemp = maxTemp,
-        .maxSensorName = readings[maxIndex].name
-    };
-    m_dispatcher.Dispatch(event);
+    // Dispatch temperature update event (shares the readings, no copy)
+    if (m_dispatcher.HasSubscribers<TemperatureUpdateEvent>()) {
+        m_dispatcher.Dispatch(TemperatureUpdateEvent{
+            .timestamp = std::chrono::steady_clock::now(),
+            .sensors = m_sensorPayload,
+            .maxTempIndex = maxIndex,
+            .maxTemp = maxTemp,
+            .maxSensorName = readings[maxIndex].name
+        });
+    }
     
     return true;
 }
 
 void ThermalManager::ApplyControl(float dt) {
     ControlMode mode = m_mode.load();
+    m_cycleDt = dt;
+    
+    // Zone integrators and hysteresis belong to the mode that built them
+    if (mode != m_lastControlMode) {
+        for (auto& zone : m_fanZones) zone.Reset();
+        m_lastControlMode = mode;
+    }
+    
+    int maxTemp;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        maxTemp = m_state.maxTemp;
+    }
     
+    if (ApplyAutotune(maxTemp)) {
+        // The autotuner owns the fan for the duration of the run
+    } else if ((mode == ControlMode::Smart || mode == ControlMode::PID) && UseFanZones()) {
+        ApplyZoneControl(dt);
+    } else {
+        ApplyModeControl(mode, dt);
+    }
+    if (mode != ControlMode::RPM) {
+        m_rpmActive = false;
+    }
+    
+    // Publish ramp scheduler counters summed over both fans
+    FanRampStats stats;
+    for (const auto& ramp : m_fanRamps) {
+        const auto& s = ramp.GetStats();
+        stats.requested += s.requested;
+        stats.issued += s.issued;
+        stats.suppressed += s.suppressed;
+        stats.reversalsCoalesced += s.reversalsCoalesced;
+        stats.emergencyBypasses += s.emergencyBypasses;
+    }
+    std::lock_guard<std::mutex> lock(m_stateMutex);
+    m_state.rampStats = stats;
+    m_state.fanCommands.issued = m_fanController->GetIssuedCommands();
+    m_state.fanCommands.suppressed = m_fanController->GetSuppressedCommands();
+}
+
+void ThermalManager::ApplyModeControl(ControlMode mode, float dt) {
     switch (mode) {
         case ControlMode::BIOS:
             ApplyBIOSMode();
@@ -360,14 +750,19 @@ void ThermalManager::ApplyControl(float dt) {
         case ControlMode::PID:
             ApplyPIDMode(dt);
             break;
+        case ControlMode::MPC:
+            ApplyMPCMode(dt);
+            break;
+        case ControlMode::RPM:
+            ApplyRpmMode();
+            break;
     }
 }
 
 void ThermalManager::ApplyBIOSMode() {
-    // Set fan to BIOS control (0x80)
-    if (m_fanController->GetCurrentLevel() != 0x80) {
-        m_fanController->SetFanLevel(0x80);
-    }
+    // Set fan to BIOS control (0x80); a no-op once the EC reports it
+    CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+    m_fanController->SetFanLevel(0x80);
 }
 
 void ThermalManager::ApplySmartMode() {
@@ -377,29 +772,31 @@ void ThermalManager::ApplySmartMode() {
         maxTemp = m_state.maxTemp;
     }
     
-    std::vector<SmartLevel> levels;
-    {
-        std::lock_guard<std::mutex> lock(m_configMutex);
-        int profileIndex = m_smartProfile.load();
-        const auto& profile = m_config.smartProfiles[profileIndex];
-        
-        for (const auto& def : profile) {
-            if (def.IsValid()) {
-                levels.push_back({def.temperature, def.fanLevel, def.hystUp, def.hystDown});
-            }
-        }
+    auto tables = m_smartTables.load();
+    int profileIndex = m_smartProfile.load();
+    if (!tables || profileIndex < 0 || profileIndex >= (int)tables->size()) {
+        return;
+    }
+    
+    // A new profile or a recompiled config invalidates the hysteresis state
+    if (tables != m_activeSmartTables || profileIndex != m_activeSmartProfile) {
+        m_activeSmartTables = tables;
+        m_activeSmartProfile = profileIndex;
+        m_smartLevel.Reset();
     }
     
-    m_fanController->UpdateSmartControl(maxTemp, levels);
+    const SmartLevelTable& table = (*tables)[profileIndex];
+    if (table.IsEmpty()) {
+        return;
+    }
+    
+    int level = table.Request(maxTemp, m_fanController->GetCurrentLevel(), m_smartLevel);
+    table.Confirm(CommandFanLevel(level, maxTemp), m_smartLevel);
 }
 
 void ThermalManager::ApplyManualMode() {
     int level = m_manualLevel.load();
-    int manModeExitTemp;
-    {
-        std::lock_guard<std::mutex> lock(m_configMutex);
-        manModeExitTemp = m_config.manModeExitTemp;
-    }
+    const int manModeExitTemp = Config().manModeExitTemp;
     
     int maxTemp;
     {
@@ -409,28 +806,26 @@ void ThermalManager::ApplyManualMode() {
     
     // Check if we should auto-exit manual mode
     if (maxTemp > manModeExitTemp) {
-        Log(LogLevel::Warning, std::format(
+        Log(LogLevel::Warning,
             "Temperature {}°C exceeds manual mode exit threshold {}°C, switching to Smart mode",
-            maxTemp, manModeExitTemp));
+            maxTemp, manModeExitTemp);
         SetMode(ControlMode::Smart);
         return;
     }
     
-    m_fanController->SetFanLevel(level);
+    CommandFanLevel(level, maxTemp);
 }
 
 void ThermalManager::ApplyPIDMode(float dt) {
-    int maxTemp;
+    int maxTemp, maxTempIndex;
     {
         std::lock_guard<std::mutex> lock(m_stateMutex);
         maxTemp = m_state.maxTemp;
+        maxTempIndex = m_state.maxTempIndex;
     }
+    if (!m_pidSeeded) SeedPIDFromModel(maxTempIndex);
     
-    PIDConfig pid;
-    {
-        std::lock_guard<std::mutex> lock(m_configMutex);
-        pid = m_config.pid;
-    }
+    const PIDConfig& pid = Config().pid;
     
     PIDSettings settings{
         .targetTemp = pid.targetTemp,
@@ -441,7 +836,294 @@ void ThermalManager::ApplyPIDMode(float dt) {
         .maxFan = static_cast<float>(pid.maxFan)
     };
     
-    m_fanController->UpdatePIDControl(static_cast<float>(maxTemp), settings, dt);
+    if (!pid.dither) {
+        int currentLevel = m_fanController->GetCurrentLevel();
+        float output = m_fanController->ComputePIDOutput(static_cast<float>(maxTemp), settings, dt);
+        int level = FanController::MapPIDOutputToLevel(output, currentLevel, settings);
+        if (level != currentLevel) {
+            Log(LogLevel::Info, "[PID] Temp={}, Output={:.2f}, Level {}->{}",
+                maxTemp, output, currentLevel, level);
+        }
+        CommandFanLevel(level, maxTemp);
+        return;
+    }
+    
+    // Dithered actuation: realize the fractional output by alternating levels.
+    // FanDither enforces its own dwell and write budget, so it bypasses the
+    // ramp scheduler (whose reversal hold would fight the alternation).
+    float demand = m_fanController->ComputePIDOutput(static_cast<float>(maxTemp), settings, dt);
+    m_fanDither.SetSettings({
+        .minDwellSeconds = pid.ditherMinDwell,
+        .maxWritesPerMinute = pid.ditherMaxWritesPerMin,
+        .minLevel = pid.minFan,
+        .maxLevel = pid.maxFan
+    });
+    
+    int currentLevel = m_fanController->GetCurrentLevel();
+    int level = m_fanDither.Update(demand, currentLevel, dt);
+    if (level != currentLevel) {
+        Log(LogLevel::Debug, "[PID] Dither output={:.2f}, level {}->{}", demand, currentLevel, level);
+        CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+        m_fanController->SetFanLevel(level);
+    }
+}
+
+void ThermalManager::ApplyMPCMode(float dt) {
+    int maxTemp, maxTempIndex;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        maxTemp = m_state.maxTemp;
+        maxTempIndex = m_state.maxTempIndex;
+    }
+    
+    const MPCConfig& mpc = Config().mpc;
+    std::shared_ptr<const ThermalModelEstimator> models;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        models = m_thermalModels;
+    }
+    
+    ThermalModel model = models ? models->GetModel(maxTempIndex) : ThermalModel();
+    if (!model.valid) {
+        if (m_mpcHasModel) {
+            Log(LogLevel::Warning,
+                "[MPC] No thermal model for sensor {} yet, using PID", maxTempIndex);
+            m_mpcHasModel = false;
+        }
+        m_fanMPC.Reset();
+        ApplyPIDMode(dt);
+        return;
+    }
+    if (!m_mpcHasModel) {
+        Log(LogLevel::Info, "[MPC] Using thermal model of sensor {} (tau={:.0f}s, dead time={:.0f}s)",
+            maxTempIndex, model.TimeConstant(3.0f), model.deadTime);
+        m_mpcHasModel = true;
+    }
+    
+    int currentLevel = m_fanController->GetCurrentLevel();
+    int level = m_fanMPC.Update(model, mpc, static_cast<float>(maxTemp), currentLevel, dt);
+    if (level != currentLevel) {
+        Log(LogLevel::Info, "[MPC] Temp={}, predicted peak={:.1f}, Level {}->{}",
+            maxTemp, m_fanMPC.GetPredictedPeak(), currentLevel, level);
+    }
+    CommandFanLevel(level, maxTemp);
+}
+
+void ThermalManager::ApplyRpmMode() {
+    int maxTemp, fan1Rpm;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        maxTemp = m_state.maxTemp;
+        fan1Rpm = m_state.fanState.fan1Speed;
+    }
+    
+    const int manModeExitTemp = Config().manModeExitTemp;
+    
+    // A fixed speed is as unsafe as a fixed level when the machine heats up
+    if (maxTemp > manModeExitTemp) {
+        Log(LogLevel::Warning,
+            "Temperature {}°C exceeds manual mode exit threshold {}°C, switching to Smart mode",
+            maxTemp, manModeExitTemp);
+        SetMode(ControlMode::Smart);
+        return;
+    }
+    
+    RunRpmControl(fan1Rpm);
+}
+
+void ThermalManager::PerformTachCycle() {
+    int fan1 = 0, fan2 = 0;
+    if (!m_fanController->GetFanSpeeds(fan1, fan2)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        m_state.fanState.fan1Speed = fan1;
+        m_state.fanState.fan2Speed = fan2;
+    }
+    RunRpmControl(fan1);
+}
+
+void ThermalManager::RunRpmControl(int fan1Rpm) {
+    auto now = std::chrono::steady_clock::now();
+    if (!m_rpmActive) {
+        m_rpmController.Reset();
+        m_lastTachTime = now;
+        m_rpmActive = true;
+    }
+    float dt = std::chrono::duration<float>(now - m_lastTachTime).count();
+    m_lastTachTime = now;
+    
+    int currentLevel = m_fanController->GetCurrentLevel();
+    bool known = m_rpmController.IsLearned(currentLevel);
+    int target = m_targetRpm.load();
+    int level = m_rpmController.Update(target, fan1Rpm, currentLevel, dt);
+    
+    if (!known && m_rpmController.IsLearned(currentLevel)) {
+        Log(LogLevel::Info, "[RPM] Level {} measured at {} RPM", currentLevel, fan1Rpm);
+    }
+    
+    // The controller enforces its own dwell and write budget, so it bypasses the ramp
+    if (level != currentLevel) {
+        Log(LogLevel::Debug, "[RPM] Target={}, measured={}, level {}->{}",
+            target, fan1Rpm, currentLevel, level);
+        CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+        m_fanController->SetFanLevel(level);
+    }
+}
+
+bool ThermalManager::ApplyAutotune(int maxTemp) {
+    int level;
+    AutotunePhase phase;
+    AutotuneProgress progress;
+    PIDConfig tuned;
+    {
+        std::lock_guard<std::mutex> lock(m_autotuneMutex);
+        if (!m_autotuner.IsActive()) return false;
+        
+        // Sample time is the acquisition timestamp, not the cycle boundary
+        std::chrono::steady_clock::time_point sampleTime;
+        {
+            std::lock_guard<std::mutex> stateLock(m_stateMutex);
+            sampleTime = m_state.timestamp;
+        }
+        double now = std::chrono::duration<double>(sampleTime.time_since_epoch()).count();
+        level = m_autotuner.Update(static_cast<float>(maxTemp), now);
+        progress = m_autotuner.GetProgress();
+        phase = progress.phase;
+        
+        if (phase == AutotunePhase::Success) {
+            // Publish the tuned gains as a new config version
+            std::lock_guard<std::mutex> configLock(m_configMutex);
+            auto published = m_publishedConfig.load();
+            ConfigSnapshot next{published->version + 1, published->config};
+            m_autotuneResult = m_autotuner.GetResult(next.config.pid);
+            next.config.pid = m_autotuneResult;
+            m_publishedConfig.store(std::make_shared<const ConfigSnapshot>(std::move(next)));
+            tuned = m_autotuneResult;
+        }
+    }
+    
+    // Log outside the lock: subscribers may query the autotuner
+    if (phase == AutotunePhase::Success && progress.fromSeed) {
+        Log(LogLevel::Warning,
+            "Autotune found no usable oscillation; using model gains Kp={:.3f}, Ki={:.4f}",
+            tuned.Kp, tuned.Ki);
+    } else if (phase == AutotunePhase::Success) {
+        Log(LogLevel::Info,
+            "Autotune complete: Ku={:.3f}, Pu={:.1f}s -> Kp={:.3f}, Ki={:.4f}, Kd={:.3f}",
+            progress.ultimateGain, progress.ultimatePeriod, tuned.Kp, tuned.Ki, tuned.Kd);
+    } else if (phase == AutotunePhase::Failed) {
+        Log(LogLevel::Warning, "Autotune failed: no usable oscillation");
+    }
+    
+    if (phase != AutotunePhase::Settling && phase != AutotunePhase::Relay) {
+        return false;
+    }
+    
+    // Relay switching must not be smoothed by the ramp scheduler
+    CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+    m_fanController->SetFanLevel(level);
+    return true;
+}
+
+bool ThermalManager::SuggestModelGains(int sensorIndex, const PIDConfig& base, float setpoint,
+                                       PIDConfig& gains) const {
+    std::shared_ptr<const ThermalModelEstimator> models;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        models = m_thermalModels;
+    }
+    ThermalModel model = models ? models->GetModel(sensorIndex) : ThermalModel();
+    if (!model.valid) return false;
+    
+    float level = std::clamp(model.HoldingLevel(setpoint),
+                             static_cast<float>(base.minFan), static_cast<float>(base.maxFan));
+    gains = model.SuggestPID(base, level);
+    return gains.Kp != base.Kp || gains.Ki != base.Ki || gains.Kd != base.Kd;
+}
+
+void ThermalManager::SeedPIDFromModel(int sensorIndex) {
+    // Tuned gains (config or autotune) are left alone
+    const PIDConfig& pid = Config().pid;
+    const PIDConfig defaults;
+    if (pid.Kp != defaults.Kp || pid.Ki != defaults.Ki || pid.Kd != defaults.Kd) {
+        m_pidSeeded = true;
+        return;
+    }
+    
+    PIDConfig gains;
+    if (!SuggestModelGains(sensorIndex, pid, pid.targetTemp, gains)) return;
+    
+    uint64_t version;
+    {
+        std::lock_guard<std::mutex> lock(m_configMutex);
+        auto published = m_publishedConfig.load();
+        if (published != m_activeConfig) return;   // A newer config is pending; retry after it
+        version = published->version + 1;
+        ConfigSnapshot next{version, published->config};
+        next.config.pid = gains;
+        m_publishedConfig.store(std::make_shared<const ConfigSnapshot>(std::move(next)));
+    }
+    m_pidSeeded = true;
+    Log(LogLevel::Info,
+        "[PID] Configuration v{}: gains from the thermal model of sensor {}: Kp={:.3f}, Ki={:.4f}, Kd={:.3f}",
+        version, sensorIndex, gains.Kp, gains.Ki, gains.Kd);
+}
+
+int ThermalManager::CommandFanLevel(int level, int maxTemp) {
+    int currentLevel = m_fanController->GetCurrentLevel();
+    int next = m_fanRamps[0].Schedule(level, currentLevel, maxTemp, m_cycleDt);
+    if (next == currentLevel) {
+        return currentLevel;
+    }
+    CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+    return m_fanController->SetFanLevel(next) ? next : currentLevel;
+}
+
+bool ThermalManager::UseFanZones() const {
+    if (!m_fanController->IsDualFanActive()) return false;
+    return Config().fanZonesEnabled;
+}
+
+void ThermalManager::ApplyZoneControl(float dt) {
+    // This cycle's readings; the worker thread owns the payload between cycles
+    const std::vector<SensorReading>& sensors = *m_sensorPayload;
+    int maxTemp;
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        maxTemp = m_state.maxTemp;
+    }
+    
+    const auto& zones = Config().fanZones;
+    const std::string& ignoreList = Config().ignoreList;
+    auto tables = m_smartTables.load();
+    
+    std::array<const SmartLevelTable*, 2> profiles{};
+    std::array<int, 2> current{};
+    std::array<int, 2> target{};
+    for (int z = 0; z < 2; z++) {
+        if (tables && zones[z].smartProfile >= 0 && zones[z].smartProfile < (int)tables->size()) {
+            profiles[z] = &(*tables)[zones[z].smartProfile];
+        }
+        int zoneTemp = FanZone::ComputeZoneTemp(zones[z], sensors, ignoreList);
+        current[z] = m_fanController->GetFanLevel(z);
+        target[z] = m_fanZones[z].Evaluate(zones[z], profiles[z], zoneTemp, current[z], dt);
+        target[z] = m_fanRamps[z].Schedule(target[z], current[z], maxTemp, dt);
+    }
+    
+    std::array<int, 2> applied = current;
+    if (target != current) {
+        Log(LogLevel::Debug, "Fan zones: fan1 {}->{}, fan2 {}->{}",
+            current[0], target[0], current[1], target[1]);
+        CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+        if (m_fanController->SetFanLevels(target[0], target[1])) {
+            applied = target;
+        } else {
+            Log(LogLevel::Warning, "Failed to apply per-fan zone levels");
+        }
+    }
+    for (int z = 0; z < 2; z++) m_fanZones[z].Confirm(profiles[z], applied[z]);
 }
 
 void ThermalManager::EvaluateFanFeedback(int currentLevel, int fan1Rpm) {
@@ -460,27 +1142,20 @@ void ThermalManager::EvaluateFanFeedback(int currentLevel, int fan1Rpm) {
     }
 
     m_fanNoSpinCounter = 0;
-    Log(LogLevel::Warning, std::format(
+    Log(LogLevel::Warning,
         "Fan tachometer reports {} RPM at EC level 0x{:02X}; reapplying control command",
-        fan1Rpm, currentLevel));
+        fan1Rpm, currentLevel);
 
-    if (!m_fanController->SetFanLevel(currentLevel)) {
-        Log(LogLevel::Error, std::format(
-            "Failed to reapply fan level 0x{:02X} after tach mismatch", currentLevel));
+    CycleProfiler::Scope scope(m_profiler, CyclePhase::FanWrite);
+    if (!m_fanController->ReapplyFanLevel(currentLevel)) {
+        Log(LogLevel::Error,
+            "Failed to reapply fan level 0x{:02X} after tach mismatch", currentLevel);
     }
 }
 
-void ThermalManager::Log(LogLevel level, const std::string& message) {
-    LogEvent event{
-        .timestamp = std::chrono::steady_clock::now(),
-        .level = level,
-        .message = message
-    };
-    m_dispatcher.Dispatch(event);
-}
-
 void ThermalManager::ReportError(ErrorSeverity severity, const std::string& source,
                                   const std::string& message, int code) {
+    if (!m_dispatcher.HasSubscribers<ErrorEvent>()) return;
     ErrorEvent event{
         .timestamp = std::chrono::steady_clock::now(),
         .severity = severity,
@@ -488,7 +1163,7 @@ void ThermalManager::ReportError(ErrorSeverity severity, const std::string& sour
         .message = message,
         .errorCode = code
     };
-    m_dispatcher.Dispatch(event);
+    m_dispatcher.Dispatch(std::move(event));
 }
 
 } // namespace Core
@@ -5,16 +5,31 @@
 #include "Events.h"
 #include "IThermalObserver.h"
 #include "SensorConfig.h"
+#include "FanDither.h"
+#include "FanZone.h"
+#include "SmartLevelTable.h"
+#include "FanRamp.h"
+#include "RelayAutotuner.h"
+#include "ThermalModel.h"
+#include "FanMPC.h"
+#include "FanRpmController.h"
+#include "AdaptiveCycle.h"
+#include "ConfigDiff.h"
+#include "CycleWatchdog.h"
+#include "CycleProfiler.h"
+#include "BinaryLog.h"
 #include "../ECManager.h"
 #include "../SensorManager.h"
 #include "../FanController.h"
 
+#include <array>
 #include <memory>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <format>
 
 namespace Core {
 
@@ -61,6 +76,28 @@ public:
     /// This is safe to call from any thread
     ThermalState GetState() const;
     
+    /// Shared immutable snapshot of the last published state, without a copy.
+    /// The worker publishes a new snapshot after every cycle; readers never
+    /// block it, and the returned object stays valid as long as it is held.
+    std::shared_ptr<const ThermalState> GetStateSnapshot() const { return m_snapshot.load(); }
+    
+    /// Version of the last published snapshot; poll this to skip unchanged frames
+    uint64_t GetStateVersion() const { return m_stateVersion.load(std::memory_order_acquire); }
+    
+    /// Per-phase timing histograms and EC counters as of the last cycle
+    /// (also in ThermalState::profile and CycleProfileEvent)
+    CycleProfile GetCycleProfile() const { return m_snapshot.load()->profile; }
+    
+    /// Stall statistics of the deadline watchdog (also in ThermalState::watchdog)
+    WatchdogStats GetWatchdogStats() const { return m_watchdog.GetStats(); }
+    
+    /// Counters of the log backend (records captured, dropped, formatted, written)
+    BinaryLog::Stats GetLogStats() const { return m_log.GetStats(); }
+    
+    /// Also append every log record to a binary file, formatted only when it is
+    /// decoded (BinaryLog::Decode); an empty path stops it
+    bool SetBinaryLogFile(const std::string& path) { return m_log.OpenFile(path); }
+    
     /// Get current control mode
     ControlMode GetMode() const;
     
@@ -78,22 +115,69 @@ public:
     /// @param level Fan level 0-7
     void SetManualLevel(int level);
     
-    /// Update configuration
+    /// Set the fan speed held in RPM mode
+    /// @param rpm Target speed of fan 1
+    void SetTargetRpm(int rpm);
+    
+    /// Get the fan speed held in RPM mode
+    int GetTargetRpm() const { return m_targetRpm.load(); }
+    
+    /// Publish a new configuration. The worker picks it up at its next cycle
+    /// and applies only what differs from the running one (see ConfigDiff).
     /// @param config New configuration to apply
     void UpdateConfig(const ThermalConfig& config);
     
+    /// Version of the last published configuration (the constructor's is 1)
+    uint64_t GetConfigVersion() const { return m_publishedConfig.load()->version; }
+    
     /// Force an immediate sensor update
     void ForceUpdate();
     
+    // --- PID Autotune (Thread-Safe) ---
+    
+    /// Start a relay-feedback autotune run. The worker drives the fan until
+    /// the run finishes; on success the tuned gains replace config.pid.
+    /// With a valid thermal model of the hottest sensor the run is seeded with
+    /// the model's gains, which it falls back to if the relay finds no oscillation.
+    void StartAutotune(const AutotuneSettings& settings);
+    
+    /// Abort a running autotune; normal mode control resumes
+    void CancelAutotune();
+    
+    /// Current autotune progress
+    AutotuneProgress GetAutotuneProgress() const;
+    
+    /// PID gains produced by the last successful run (config.pid otherwise)
+    PIDConfig GetAutotuneResult() const;
+    
+    // --- Model-Predictive Control ---
+    
+    /// Source of the identified thermal models used by ControlMode::MPC.
+    /// Without a valid model for the hottest sensor MPC falls back to PID.
+    /// The models also seed autotune runs and replace untuned (default) PID gains.
+    void SetThermalModels(std::shared_ptr<const ThermalModelEstimator> models);
+    
     // --- Event Subscription ---
     
     /// Subscribe to thermal events
     /// @param callback Function to call when events occur
+    /// @param options Synchronous (default) or queued delivery
     /// @return Subscription ID for later unsubscription
-    EventDispatcher::SubscriptionId Subscribe(EventDispatcher::Callback callback);
+    EventDispatcher::SubscriptionId Subscribe(EventDispatcher::Callback callback,
+                                              const EventDeliveryOptions& options = {});
     
     /// Subscribe an observer object
-    EventDispatcher::SubscriptionId Subscribe(std::weak_ptr<IThermalObserver> observer);
+    EventDispatcher::SubscriptionId Subscribe(std::weak_ptr<IThermalObserver> observer,
+                                              const EventDeliveryOptions& options = {});
+    
+    /// Subscribe to a single event type, e.g. Subscribe<LogEvent>([](const LogEvent& e) {...})
+    template <typename E, typename Handler>
+    EventDispatcher::SubscriptionId Subscribe(Handler handler, const EventDeliveryOptions& options = {}) {
+        return m_dispatcher.Subscribe<E>(std::move(handler), options);
+    }
+    
+    /// Queue and lag counters of the async subscribers
+    std::vector<EventSubscriberStats> GetSubscriberStats() const { return m_dispatcher.GetSubscriberStats(); }
     
     /// Unsubscribe from events
     void Unsubscribe(EventDispatcher::SubscriptionId id);
@@ -104,15 +188,45 @@ private:
     /// Main worker thread function
     void WorkerLoop(std::stop_token stopToken);
     
-    /// Perform one control cycle
+    /// Perform one control cycle, timing its phases into m_schedulerStats
     void PerformCycle();
     
+    /// Account one cycle in the scheduler statistics and publish them
+    /// @param scheduled False for extra cycles triggered by a wakeup
+    /// @param lateness Cycle start minus its deadline (scheduled cycles only)
+    void RecordCycleTiming(bool scheduled, std::chrono::steady_clock::duration lateness);
+    
     /// Update all sensor readings
-    bool UpdateSensors();
+    /// @param singleSample Skip the confirmation sample (fast cycles)
+    bool UpdateSensors(bool singleSample = false);
+    
+    /// Copy m_state into a new immutable snapshot and publish it
+    void PublishState();
+    
+    /// Store the cycle profile in m_state and send CycleProfileEvent
+    void PublishProfile();
+    
+    /// Heartbeat to the watchdog: the worker beats again by due + stallMs
+    void BeatWatchdog(std::chrono::steady_clock::time_point due);
+    
+    /// Watchdog thread: hand the fan to the BIOS around the stalled worker
+    bool ForceBiosFailSafe(std::chrono::milliseconds overdue, int attempt);
+    
+    /// Adopt the last published config, applying only its differences
+    void SyncConfig();
+    
+    /// Configuration the worker currently runs with (worker thread only)
+    const ThermalConfig& Config() const { return m_activeConfig->config; }
+    
+    /// Let the adaptive cycle pick the next period
+    void UpdateCyclePeriod(float dt);
     
     /// Apply control logic based on current mode
     void ApplyControl(float dt);
     
+    /// Run the single-fan control path of the given mode
+    void ApplyModeControl(ControlMode mode, float dt);
+    
     /// Apply BIOS mode (release control)
     void ApplyBIOSMode();
     
@@ -125,8 +239,59 @@ private:
     /// Apply PID control
     void ApplyPIDMode(float dt);
     
-    /// Log a message through the event system
-    void Log(LogLevel level, const std::string& message);
+    /// Apply model-predictive control
+    void ApplyMPCMode(float dt);
+    
+    /// Apply RPM target control at the thermal cycle (safety exit + tach step)
+    void ApplyRpmMode();
+    
+    /// Read the tach and run one step of the inner RPM loop
+    void PerformTachCycle();
+    
+    /// Feed a tach reading to the RPM controller and write its level
+    void RunRpmControl(int fan1Rpm);
+    
+    /// Drive the fan from the autotuner; returns false when no run is active
+    bool ApplyAutotune(int maxTemp);
+    
+    /// PI gains from the thermal model of a sensor around the level that holds setpoint.
+    /// Returns false without a valid model (or one where the fan has no effect).
+    bool SuggestModelGains(int sensorIndex, const PIDConfig& base, float setpoint, PIDConfig& gains) const;
+    
+    /// Publish model gains in place of the default PID gains, once
+    void SeedPIDFromModel(int sensorIndex);
+    
+    /// Pass a requested level through the ramp scheduler and write it. Call it
+    /// every cycle, also without a new request, so the ramp sees elapsed time.
+    /// @return The level now on the fan
+    int CommandFanLevel(int level, int maxTemp);
+    
+    /// Whether Smart/PID modes should run the per-fan zones
+    bool UseFanZones() const;
+    
+    /// Run both fan zones and write both levels in one EC transaction
+    void ApplyZoneControl(float dt);
+    
+    /// Why the worker is woken before its next cycle is due (bit flags)
+    enum class WakeReason : unsigned {
+        ForceUpdate = 1u << 0,
+        ModeChange  = 1u << 1,
+        Setpoint    = 1u << 2,  // Manual level or target RPM of the active mode
+        Autotune    = 1u << 3,
+        Config      = 1u << 4
+    };
+    
+    /// Wake the worker immediately
+    void RequestWake(WakeReason reason);
+    
+    /// Log a message through the event system. Only the format literal and the
+    /// arguments are captured here; m_log formats them on its consumer thread
+    /// and delivers the LogEvent from there.
+    template <typename... Args>
+    void Log(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+        if (!m_dispatcher.HasSubscribers<LogEvent>() && !m_log.HasFile()) return;
+        m_log.Write(level, fmt, std::forward<Args>(args)...);
+    }
     
     /// Report an error through the event system
     void ReportError(ErrorSeverity severity, const std::string& source, 
@@ -142,32 +307,100 @@ private:
     std::unique_ptr<SensorManager> m_sensorManager;
     std::unique_ptr<FanController> m_fanController;
     
-    // Configuration (protected by m_configMutex)
-    ThermalConfig m_config;
+    /// Immutable configuration with its publish counter
+    struct ConfigSnapshot {
+        uint64_t version;
+        ThermalConfig config;
+    };
+    
+    // Configuration: publishers swap in new versions (serialized by m_configMutex),
+    // the worker adopts the newest one once per cycle
+    std::atomic<std::shared_ptr<const ConfigSnapshot>> m_publishedConfig;
+    std::shared_ptr<const ConfigSnapshot> m_activeConfig;   // Worker thread only
+    std::atomic<bool> m_activeDualFan{false};               // isDualFan of m_activeConfig, for the watchdog
     mutable std::mutex m_configMutex;
     
-    // Current state (protected by m_stateMutex)
+    // Smart profiles compiled on every config change, swapped atomically
+    std::atomic<std::shared_ptr<const SmartProfileSet>> m_smartTables;
+    
+    // Smart mode hysteresis state (worker thread only)
+    std::shared_ptr<const SmartProfileSet> m_activeSmartTables;
+    int m_activeSmartProfile{-1};
+    SmartLevelState m_smartLevel;
+    
+    // Current state (protected by m_stateMutex, worker-side working copy)
     ThermalState m_state;
     mutable std::mutex m_stateMutex;
     
+    // Published snapshots (RCU: replaced as a whole, never modified)
+    std::atomic<std::shared_ptr<const ThermalState>> m_snapshot;
+    std::atomic<uint64_t> m_stateVersion{0};
+    
     // Control state
     std::atomic<ControlMode> m_mode{ControlMode::BIOS};
     std::atomic<int> m_smartProfile{0};
     std::atomic<int> m_manualLevel{7};
+    std::atomic<int> m_targetRpm{3000};
     
     // Worker thread
     std::jthread m_workerThread;
     std::atomic<bool> m_running{false};
-    std::atomic<bool> m_forceUpdate{false};
+    
+    // Deadline scheduler (period written by SyncConfig and the adaptive cycle, stats worker thread only)
+    std::atomic<int> m_cyclePeriodMs{5000};
+    SchedulerStats m_schedulerStats;
+    CycleProfiler m_profiler;
+    AdaptiveCycle m_adaptiveCycle;
+    std::atomic<bool> m_cycleThresholdsDirty{true};
+    ControlMode m_thresholdMode{ControlMode::BIOS};   // Mode/profile the thresholds were collected for
+    int m_thresholdProfile{0};
+    
+    // Worker wakeups (m_wakeReasons protected by m_wakeMutex)
+    std::mutex m_wakeMutex;
+    std::condition_variable_any m_wakeCv;
+    unsigned m_wakeReasons{0};
     
     // Event dispatcher
     EventDispatcher m_dispatcher;
     
+    // Log backend; its consumer thread dispatches LogEvents, so it is declared
+    // after m_dispatcher and drains into it one last time when destroyed
+    BinaryLog m_log;
+    
+    // Deadline watchdog (own thread; its fail-safe uses m_ecManager, m_activeDualFan
+    // and m_dispatcher, so it is declared after them and destroyed first)
+    CycleWatchdog m_watchdog;
+    
+    // Readings shared with TemperatureUpdateEvent subscribers (worker thread only).
+    // Refilled in place while no subscriber holds on to the previous cycle's copy.
+    std::shared_ptr<std::vector<SensorReading>> m_sensorPayload;
+    
     // PID state
     float m_pidIntegral{0.0f};
     float m_pidLastError{0.0f};
     std::chrono::steady_clock::time_point m_lastCycleTime;
+    FanDither m_fanDither;
+    std::array<FanRamp, 2> m_fanRamps;
+    float m_cycleDt{1.0f};
+    std::array<FanZone, 2> m_fanZones;
+    ControlMode m_lastControlMode{ControlMode::BIOS};  // Mode of the last cycle (worker thread only)
+    
+    // Model-predictive control (models protected by m_configMutex)
+    std::shared_ptr<const ThermalModelEstimator> m_thermalModels;
+    FanMPC m_fanMPC;
+    bool m_mpcHasModel{true};   // Last cycle ran on a model (worker thread only)
+    bool m_pidSeeded{false};    // Default PID gains were checked against the model (worker thread only)
+    
+    // RPM target control (worker thread only)
+    FanRpmController m_rpmController;
+    bool m_rpmActive{false};
+    std::chrono::steady_clock::time_point m_lastTachTime;
 
+    // Autotuner (shared between worker and callers, protected by m_autotuneMutex)
+    RelayAutotuner m_autotuner;
+    PIDConfig m_autotuneResult;
+    mutable std::mutex m_autotuneMutex;
+    
     // Fan response tracking
     int m_fanNoSpinCounter{0};
     static constexpr int kFanMinOperationalRpm = 300;
@@ -0,0 +1,365 @@
+// Core/ThermalModel.cpp - Implementation of thermal model identification
+#include "ThermalModel.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace Core {
+
+namespace {
+
+constexpr int kParams = 4;  // a0, a1, k0, k1
+using Vector = std::array<double, kParams>;
+using Matrix = std::array<Vector, kParams>;
+
+/// Normal equations of one least-squares problem
+struct NormalEquations {
+    Matrix xtx{};
+    Vector xty{};
+    double yty = 0.0;
+    int count = 0;
+
+    void Add(const Vector& x, double y) {
+        for (int i = 0; i < kParams; i++) {
+            for (int j = 0; j < kParams; j++) xtx[i][j] += x[i] * x[j];
+            xty[i] += x[i] * y;
+        }
+        yty += y * y;
+        count++;
+    }
+
+    /// Solve by Gaussian elimination with partial pivoting.
+    /// Returns false if the system is (numerically) singular.
+    bool Solve(Vector& theta) const {
+        Matrix a = xtx;
+        Vector b = xty;
+        double scale = 0.0;
+        for (int i = 0; i < kParams; i++) scale = std::max(scale, std::abs(a[i][i]));
+        if (scale <= 0.0) return false;
+
+        for (int col = 0; col < kParams; col++) {
+            int pivot = col;
+            for (int row = col + 1; row < kParams; row++) {
+                if (std::abs(a[row][col]) > std::abs(a[pivot][col])) pivot = row;
+            }
+            if (std::abs(a[pivot][col]) < scale * 1e-12) return false;
+            std::swap(a[col], a[pivot]);
+            std::swap(b[col], b[pivot]);
+
+            for (int row = col + 1; row < kParams; row++) {
+                double f = a[row][col] / a[col][col];
+                for (int k = col; k < kParams; k++) a[row][k] -= f * a[col][k];
+                b[row] -= f * b[col];
+            }
+        }
+        for (int row = kParams - 1; row >= 0; row--) {
+            double sum = b[row];
+            for (int k = row + 1; k < kParams; k++) sum -= a[row][k] * theta[k];
+            theta[row] = sum / a[row][row];
+        }
+        return true;
+    }
+
+    /// Residual sum of squares for theta, without a second pass over the data
+    double Residual(const Vector& theta) const {
+        double rss = yty;
+        for (int i = 0; i < kParams; i++) {
+            rss -= 2.0 * theta[i] * xty[i];
+            for (int j = 0; j < kParams; j++) rss += theta[i] * xtx[i][j] * theta[j];
+        }
+        return std::max(rss, 0.0);
+    }
+};
+
+constexpr int kMaxTachRpm = 0x1FFF;        // Higher readings are bus garbage
+constexpr float kMinRpmStep = 50.0f;        // Smaller RPM steps between levels: tach not usable
+
+bool IsNumericLevel(int level) {
+    return level >= 0 && level <= 7;
+}
+
+/// A stopped tach on a commanded fan is a broken or missing sensor, not airflow
+bool HasTach(const ThermalSample& sample) {
+    return sample.fanRpm >= 0 && sample.fanRpm <= kMaxTachRpm &&
+           (sample.fanLevel == 0 || sample.fanRpm > 0);
+}
+
+/// Median RPM of each level seen in the segments, strictly increasing with the
+/// level. Returns false if the tach is missing anywhere or does not follow the level.
+bool BuildRpmCurve(const std::vector<ThermalSample>& samples,
+                   const std::vector<std::pair<size_t, size_t>>& segments,
+                   std::vector<std::pair<float, float>>& curve) {
+    std::array<std::vector<int>, 8> perLevel;
+    for (const auto& [first, last] : segments) {
+        for (size_t i = first; i < last; i++) {
+            if (!HasTach(samples[i])) return false;
+            perLevel[samples[i].fanLevel].push_back(samples[i].fanRpm);
+        }
+    }
+    curve.clear();
+    for (int level = 0; level < 8; level++) {
+        auto& rpms = perLevel[level];
+        if (rpms.empty()) continue;
+        std::nth_element(rpms.begin(), rpms.begin() + rpms.size() / 2, rpms.end());
+        float median = (float)rpms[rpms.size() / 2];
+        if (!curve.empty() && median < curve.back().second + kMinRpmStep) return false;
+        curve.emplace_back((float)level, median);
+    }
+    return curve.size() >= 2;
+}
+
+/// Inverse of the RPM curve, clamped to the levels it covers
+double RpmToLevel(const std::vector<std::pair<float, float>>& curve, int rpm) {
+    if (rpm <= curve.front().second) return curve.front().first;
+    for (size_t i = 1; i < curve.size(); i++) {
+        const auto& [l0, r0] = curve[i - 1];
+        const auto& [l1, r1] = curve[i];
+        if (rpm <= r1) return l0 + (l1 - l0) * (rpm - r0) / (r1 - r0);
+    }
+    return curve.back().first;
+}
+
+} // namespace
+
+// --- ThermalModel ---
+
+ThermalModel ThermalModel::Fit(const std::vector<ThermalSample>& samples, const ThermalModelFitOptions& options) {
+    ThermalModel model;
+    if ((int)samples.size() < std::max(options.minSamples, 3)) return model;
+
+    // Contiguous buffers [begin, end): numeric fan level, increasing time, no long gaps
+    std::vector<std::pair<size_t, size_t>> segments;
+    std::vector<double> periods;
+    int minLevel = 7, maxLevel = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i <= samples.size(); i++) {
+        bool breaks = (i == samples.size()) || !IsNumericLevel(samples[i].fanLevel);
+        if (!breaks && i > begin) {
+            double gap = samples[i].time - samples[i - 1].time;
+            if (gap <= 0.0 || gap > options.maxGapSeconds) breaks = true;
+            else periods.push_back(gap);
+        }
+        if (breaks) {
+            if (i > begin + 1) segments.emplace_back(begin, i);
+            if (i == samples.size() || !IsNumericLevel(samples[i].fanLevel)) {
+                begin = i + 1;
+                continue;
+            }
+            begin = i;
+        }
+        minLevel = std::min(minLevel, samples[i].fanLevel);
+        maxLevel = std::max(maxLevel, samples[i].fanLevel);
+    }
+
+    // Without a level change the fan terms are not identifiable
+    if (segments.empty() || periods.empty() || minLevel == maxLevel) return model;
+
+    std::nth_element(periods.begin(), periods.begin() + periods.size() / 2, periods.end());
+    const double period = periods[periods.size() / 2];
+    const int maxDelay = std::max(0, (int)(options.maxDeadTime / period));
+
+    // Regressor per sample: measured airflow when the tach is usable, else the command
+    std::vector<std::pair<float, float>> rpmCurve;
+    const bool usesRpm = BuildRpmCurve(samples, segments, rpmCurve);
+    std::vector<double> regressor(samples.size(), 0.0);
+    for (const auto& [first, last] : segments) {
+        for (size_t i = first; i < last; i++) {
+            regressor[i] = usesRpm ? RpmToLevel(rpmCurve, samples[i].fanRpm) : samples[i].fanLevel;
+        }
+    }
+
+    // Try each candidate delay (in samples) and keep the best fit
+    double bestRms = -1.0;
+    for (int delay = 0; delay <= maxDelay; delay++) {
+        NormalEquations eq;
+        for (const auto& [first, last] : segments) {
+            for (size_t k = first + delay; k + 1 < last; k++) {
+                const auto& s0 = samples[k];
+                const auto& s1 = samples[k + 1];
+                double dt = s1.time - s0.time;
+                double u = regressor[k - delay];
+                double t = 0.5 * ((double)s0.temp + (double)s1.temp);
+                double y = ((double)s1.temp - (double)s0.temp) / dt;
+                eq.Add({1.0, u, -t, -u * t}, y);
+            }
+        }
+        if (eq.count < options.minSamples) break;
+
+        Vector theta{};
+        if (!eq.Solve(theta)) continue;
+
+        double rms = std::sqrt(eq.Residual(theta) / eq.count);
+        if (bestRms >= 0.0 && rms >= bestRms) continue;
+
+        ThermalModel candidate;
+        candidate.a0 = (float)theta[0];
+        candidate.a1 = (float)theta[1];
+        candidate.k0 = (float)theta[2];
+        candidate.k1 = (float)theta[3];
+        candidate.deadTime = (float)(delay * period);
+        candidate.rmsError = (float)rms;
+        candidate.samples = eq.count;
+        candidate.usesRpm = usesRpm;
+
+        // Physically plausible: net cooling over the whole level range
+        bool finite = std::isfinite(candidate.a0) && std::isfinite(candidate.a1) &&
+                      std::isfinite(candidate.k0) && std::isfinite(candidate.k1);
+        if (!finite || candidate.Cooling(0.0f) <= 0.0f || candidate.Cooling(7.0f) <= 0.0f) continue;
+
+        candidate.valid = true;
+        model = candidate;
+        bestRms = rms;
+    }
+    return model;
+}
+
+float ThermalModel::TimeConstant(float level) const {
+    float k = Cooling(level);
+    return k > 0.0f ? 1.0f / k : 0.0f;
+}
+
+float ThermalModel::SteadyStateTemp(float level) const {
+    float k = Cooling(level);
+    return k > 0.0f ? (a0 + a1 * level) / k : 0.0f;
+}
+
+float ThermalModel::StaticGain(float level) const {
+    // d/du of (a0 + a1*u) / (k0 + k1*u)
+    float k = Cooling(level);
+    if (k <= 0.0f) return 0.0f;
+    return (a1 * k - (a0 + a1 * level) * k1) / (k * k);
+}
+
+float ThermalModel::HoldingLevel(float temp) const {
+    // Solve (a0 + a1*u) = (k0 + k1*u) * temp for u
+    float denom = a1 - k1 * temp;
+    return std::abs(denom) > 1e-9f ? (k0 * temp - a0) / denom : 0.0f;
+}
+
+float ThermalModel::Ambient() const {
+    // Unidentifiable when the fan does not change the cooling coefficient
+    return std::abs(k1) > 1e-9f ? a1 / k1 : 0.0f;
+}
+
+float ThermalModel::HeatCapacity(float watts) const {
+    float q = HeatRate();
+    return q > 0.0f ? watts / q : 0.0f;
+}
+
+float ThermalModel::Predict(float temp, float level, float dt) const {
+    float k = Cooling(level);
+    if (!valid || k <= 0.0f) return temp;
+    float target = SteadyStateTemp(level);
+    return target + (temp - target) * std::exp(-k * dt);
+}
+
+PIDConfig ThermalModel::SuggestPID(const PIDConfig& base, float level) const {
+    PIDConfig result = base;
+    float gain = std::abs(StaticGain(level));   // °C per fan level
+    float tau = TimeConstant(level);
+    if (!valid || gain < 1e-3f || tau <= 0.0f) return result;
+
+    // SIMC: closed-loop time constant no faster than the dead time
+    float tc = std::max(deadTime, 0.25f * tau);
+    float Kc = tau / (gain * (tc + deadTime));
+    float Ti = std::min(tau, 4.0f * (tc + deadTime));
+
+    result.Kp = Kc;
+    result.Ki = Kc / Ti;
+    result.Kd = 0.0f;
+    return result;
+}
+
+// --- ThermalModelEstimator ---
+
+ThermalModelEstimator::ThermalModelEstimator(const Settings& settings)
+    : m_settings(settings)
+{
+}
+
+double ThermalModelEstimator::ToSeconds(std::chrono::steady_clock::time_point tp) {
+    if (!m_hasEpoch) {
+        m_epoch = tp;
+        m_hasEpoch = true;
+    }
+    return std::chrono::duration<double>(tp - m_epoch).count();
+}
+
+void ThermalModelEstimator::OnFanStateChange(const FanStateChangeEvent& event) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fanLevel = event.currentLevel;
+    m_fanRpm = event.fan1Speed;
+}
+
+void ThermalModelEstimator::OnTemperatureUpdate(const TemperatureUpdateEvent& event) {
+    bool refit = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fanLevel < 0 || !event.sensors) return;
+
+        double now = ToSeconds(event.timestamp);
+        for (const auto& sensor : *event.sensors) {
+            if (!sensor.isAvailable || sensor.index < 0) continue;
+            if ((size_t)sensor.index >= m_history.size()) {
+                m_history.resize(sensor.index + 1);
+                m_models.resize(sensor.index + 1);
+            }
+            auto& history = m_history[sensor.index];
+            history.push_back({now, (float)sensor.biasedTemp, m_fanLevel, m_fanRpm});
+            while (history.size() > m_settings.historySamples) history.pop_front();
+        }
+
+        if (++m_sinceRefit >= m_settings.refitInterval) {
+            m_sinceRefit = 0;
+            refit = true;
+        }
+    }
+    if (refit) Refit();
+}
+
+void ThermalModelEstimator::Refit() {
+    // Fit on copies so readers are not blocked by the least-squares passes
+    std::vector<std::vector<ThermalSample>> series;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        series.reserve(m_history.size());
+        for (const auto& history : m_history) {
+            series.emplace_back(history.begin(), history.end());
+        }
+    }
+
+    std::vector<ThermalModel> models;
+    models.reserve(series.size());
+    for (const auto& s : series) {
+        models.push_back(ThermalModel::Fit(s, m_settings.fit));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < models.size() && i < m_models.size(); i++) {
+        m_models[i] = models[i];
+    }
+}
+
+void ThermalModelEstimator::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_history.clear();
+    m_models.clear();
+    m_hasEpoch = false;
+    m_fanLevel = -1;
+    m_sinceRefit = 0;
+}
+
+ThermalModel ThermalModelEstimator::GetModel(int sensorIndex) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (sensorIndex < 0 || (size_t)sensorIndex >= m_models.size()) return ThermalModel();
+    return m_models[sensorIndex];
+}
+
+std::vector<ThermalSample> ThermalModelEstimator::GetHistory(int sensorIndex) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (sensorIndex < 0 || (size_t)sensorIndex >= m_history.size()) return {};
+    const auto& history = m_history[sensorIndex];
+    return std::vector<ThermalSample>(history.begin(), history.end());
+}
+
+} // namespace Core
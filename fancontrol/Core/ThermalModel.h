@@ -0,0 +1,151 @@
+// Core/ThermalModel.h - First-order-plus-dead-time thermal model identification
+// Part of the Core library - NO Windows UI dependencies allowed here
+#pragma once
+
+#include "Events.h"
+#include "IThermalObserver.h"
+#include "SensorConfig.h"
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Core {
+
+/// One point of a recorded (temperature, fan) series
+struct ThermalSample {
+    double time = 0.0;      // Seconds, monotonic
+    float temp = 0.0f;      // °C
+    int fanLevel = 0;       // 0-7, or 0x80 for BIOS control
+    int fanRpm = -1;        // Fan 1 RPM at the time of the sample, -1: no tach reading
+};
+
+/// Limits for ThermalModel::Fit
+struct ThermalModelFitOptions {
+    float maxGapSeconds = 10.0f;    // A larger gap between samples splits the series
+    float maxDeadTime = 30.0f;      // Upper bound of the dead-time search in seconds
+    int minSamples = 30;            // Usable samples required for a fit
+};
+
+/// First-order-plus-dead-time model of one sensor:
+///
+///     dT/dt = (a0 + a1*u) - (k0 + k1*u) * T        with u = fanLevel(t - deadTime)
+///
+/// which is C*dT/dt = P - h(u)*(T - Ta) with a fan-level-dependent cooling
+/// coefficient h(u) = C*(k0 + k1*u), divided through by the heat capacity C.
+/// The form is linear in its parameters, so it is fitted by ordinary least
+/// squares on the finite differences of contiguous sample buffers; the dead
+/// time is found by searching the delay with the smallest residual.
+///
+/// Power and heat capacity only appear as their ratio. HeatCapacity() turns
+/// the fitted heat rate back into J/°C once the dissipated power is known.
+///
+/// When every sample carries a plausible tach reading, u is the measured RPM
+/// mapped back to level units through the median RPM of each level: the fan's
+/// spin-up and spin-down then show up in the regressor rather than being
+/// lumped into the dead time, and the model still speaks in fan levels.
+struct ThermalModel {
+    bool valid = false;
+    float a0 = 0.0f;            // Drive term at fan level 0 (°C/s)
+    float a1 = 0.0f;            // Drive change per fan level (°C/s)
+    float k0 = 0.0f;            // Cooling coefficient with the fan off (1/s)
+    float k1 = 0.0f;            // Cooling coefficient added per fan level (1/s)
+    float deadTime = 0.0f;      // Transport lag from fan command to temperature (s)
+    float rmsError = 0.0f;      // RMS residual of dT/dt (°C/s)
+    int samples = 0;            // Samples used by the fit
+    bool usesRpm = false;       // Regressor was the measured RPM (in level units)
+
+    /// Identify a model from a recorded series.
+    /// Samples under BIOS control and gaps longer than maxGapSeconds split the
+    /// series; each contiguous buffer contributes only its own differences.
+    /// Returns an invalid model if the data is too short, the fan level never
+    /// changed (no excitation) or the fit is not physically plausible.
+    static ThermalModel Fit(const std::vector<ThermalSample>& samples,
+                            const ThermalModelFitOptions& options = ThermalModelFitOptions());
+
+    /// Cooling coefficient h(u)/C in 1/s
+    float Cooling(float level) const { return k0 + k1 * level; }
+
+    /// Time constant C/h(u) in seconds
+    float TimeConstant(float level) const;
+
+    /// Temperature the sensor settles at when the fan is held at level
+    float SteadyStateTemp(float level) const;
+
+    /// Sensitivity of the steady-state temperature to the fan level (°C per level)
+    float StaticGain(float level) const;
+
+    /// Fan level that holds the sensor at temp in steady state (may lie outside 0-7)
+    float HoldingLevel(float temp) const;
+
+    /// Ambient temperature implied by the fit (Ta = a1 / k1)
+    float Ambient() const;
+
+    /// Heat input P/C in °C/s
+    float HeatRate() const { return a0 - k0 * Ambient(); }
+
+    /// Heat capacity in J/°C for a known dissipated power
+    float HeatCapacity(float watts) const;
+
+    /// Temperature after holding the fan at level for dt seconds
+    float Predict(float temp, float level, float dt) const;
+
+    /// PI gains from the model (SIMC rule) around the given operating level.
+    /// Fields other than Kp/Ki/Kd are copied from base; base is returned
+    /// unchanged if the model is invalid or the fan has no measurable effect.
+    PIDConfig SuggestPID(const PIDConfig& base, float level) const;
+};
+
+/// Sliding window and refit period for ThermalModelEstimator
+struct ThermalModelEstimatorSettings {
+    size_t historySamples = 1800;   // Samples kept per sensor
+    int refitInterval = 60;         // Temperature updates between refits
+    ThermalModelFitOptions fit;
+};
+
+/// Online model identification.
+/// Subscribe to ThermalManager; the estimator records a (temperature, fan
+/// level, RPM) series per sensor from TemperatureUpdateEvent and
+/// FanStateChangeEvent and periodically refits ThermalModel on the most
+/// recent window. Thread-safe: events arrive on the worker thread, models
+/// can be read from any thread.
+class ThermalModelEstimator : public ThermalObserverBase {
+public:
+    using Settings = ThermalModelEstimatorSettings;
+
+    explicit ThermalModelEstimator(const Settings& settings = Settings());
+
+    /// Latest fitted model of a sensor (invalid until enough data was seen)
+    ThermalModel GetModel(int sensorIndex) const;
+
+    /// Copy of the recorded series of a sensor
+    std::vector<ThermalSample> GetHistory(int sensorIndex) const;
+
+    /// Refit all sensors now
+    void Refit();
+
+    /// Drop all recorded data and models
+    void Clear();
+
+protected:
+    void OnTemperatureUpdate(const TemperatureUpdateEvent& event) override;
+    void OnFanStateChange(const FanStateChangeEvent& event) override;
+
+private:
+    double ToSeconds(std::chrono::steady_clock::time_point tp);
+
+    Settings m_settings;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::deque<ThermalSample>> m_history;
+    std::vector<ThermalModel> m_models;
+
+    std::chrono::steady_clock::time_point m_epoch;
+    bool m_hasEpoch{false};
+    int m_fanLevel{-1};         // -1 until the first FanStateChangeEvent
+    int m_fanRpm{-1};
+    int m_sinceRefit{0};
+};
+
+} // namespace Core
@@ -6,17 +6,26 @@
 
 namespace Core {
 
-UIAdapter::UIAdapter(std::shared_ptr<ThermalManager> manager)
+UIAdapter::UIAdapter(std::shared_ptr<ThermalManager> manager, const std::string& historyPath)
     : m_manager(std::move(manager))
+    , m_history(historyPath)
 {
     // Initialize default state
     m_state.Sensors.resize(SensorAddresses::TOTAL_COUNT);
     m_state.SensorWeights.resize(16, 1.0f);
     m_state.SensorNames.resize(16);
+    m_state.TargetRpm = m_manager->GetTargetRpm();
     
-    // Subscribe to thermal events
+    // Subscribe to thermal events. Delivery is queued: the handlers take the
+    // UI mutex and write the log file, which must not stall the control loop.
+    // The cycle profile is polled on demand, so it is left out of the stream.
     m_subscriptionId = m_manager->Subscribe([this](const ThermalEvent& e) {
         OnThermalEvent(e);
+    }, {
+        .events = AllEvents & ~EventBit<CycleProfileEvent>,
+        .async = true,
+        .queueCapacity = 256,
+        .overflow = EventOverflowPolicy::DropOldest
     });
 }
 
@@ -25,6 +34,8 @@ UIAdapter::~UIAdapter() {
 }
 
 void UIAdapter::Update(float deltaTime) {
+    SyncAutotuneProgress();
+    
     std::lock_guard<std::mutex> lock(m_mutex);
     
     // Update smooth animations
@@ -86,6 +97,22 @@ void UIAdapter::SetManualLevel(int level) {
     m_manager->SetManualLevel(level);
 }
 
+void UIAdapter::SetTargetRpm(int rpm) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.TargetRpm = rpm;
+    }
+    m_manager->SetTargetRpm(rpm);
+}
+
+void UIAdapter::SetUseTargetRpm(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.UseTargetRpm = enabled;
+    }
+    m_manager->SetMode(enabled ? ControlMode::RPM : ControlMode::Manual, 0);
+}
+
 void UIAdapter::SetSmartProfile(int profile) {
     {
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -114,44 +141,73 @@ void UIAdapter::SetAlgorithm(int algorithm) {
     if (algorithm == 1) {  // PID
         // ThermalManager would switch to PID mode
         m_manager->SetMode(ControlMode::PID, 0);
+    } else if (algorithm == 2) {  // MPC
+        m_manager->SetMode(ControlMode::MPC, 0);
     } else {
         m_manager->SetMode(ControlMode::Smart, profile);
     }
 }
 
 void UIAdapter::StartAutotune() {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_state.Autotune.Stage = AutotuneStep::WaitingForHeat;
-    m_state.Autotune.CyclesCount = 0;
-    m_state.Autotune.CurrentMax = -1.0f;
-    m_state.Autotune.CurrentMin = 200.0f;
-    m_state.Autotune.Rising = true;
-    m_state.Autotune.Status = "Starting autotune...";
+    AutotuneSettings settings;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        settings.setpoint = m_state.PID.targetTemp;
+        settings.lowLevel = (int)m_state.PID.minFan;
+        settings.highLevel = (int)m_state.PID.maxFan;
+        m_state.Autotune = AutotuneContext{};
+        m_state.Autotune.Stage = AutotuneStep::WaitingForHeat;
+        m_state.Autotune.Status = "Starting autotune...";
+    }
+    m_manager->StartAutotune(settings);
 }
 
 void UIAdapter::CancelAutotune() {
+    m_manager->CancelAutotune();
     std::lock_guard<std::mutex> lock(m_mutex);
     m_state.Autotune.Stage = AutotuneStep::Idle;
     m_state.Autotune.Status = "Autotune cancelled";
 }
 
-void UIAdapter::SetTrayUpdateCallback(TrayUpdateCallback callback) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    m_trayCallback = std::move(callback);
-}
-
-std::deque<float> UIAdapter::GetTempHistory(const std::string& sensorName) const {
+void UIAdapter::SyncAutotuneProgress() {
+    AutotuneProgress progress = m_manager->GetAutotuneProgress();
+    PIDConfig tuned;
+    if (progress.phase == AutotunePhase::Success) {
+        tuned = m_manager->GetAutotuneResult();
+    }
+    
     std::lock_guard<std::mutex> lock(m_mutex);
-    auto it = m_state.TempHistory.find(sensorName);
-    if (it != m_state.TempHistory.end()) {
-        return it->second;
+    auto& at = m_state.Autotune;
+    if (at.Stage == AutotuneStep::Idle || at.Stage == AutotuneStep::Success || at.Stage == AutotuneStep::Failed) {
+        return;  // Only follow runs started from this adapter
+    }
+    
+    at.CyclesCount = progress.completedCycles;
+    switch (progress.phase) {
+        case AutotunePhase::Settling: at.Stage = AutotuneStep::WaitingForHeat; break;
+        case AutotunePhase::Relay:    at.Stage = AutotuneStep::Oscillating; break;
+        case AutotunePhase::Failed:
+            at.Stage = AutotuneStep::Failed;
+            at.Status = "Autotune failed";
+            break;
+        case AutotunePhase::Success:
+            m_state.PID.Kp = tuned.Kp;
+            m_state.PID.Ki = tuned.Ki;
+            m_state.PID.Kd = tuned.Kd;
+            at.UltimateGain = progress.ultimateGain;
+            at.UltimatePeriod = progress.ultimatePeriod;
+            at.Stage = AutotuneStep::Success;
+            at.Status = "Autotune complete!";
+            break;
+        case AutotunePhase::Idle:
+            at.Stage = AutotuneStep::Idle;
+            break;
     }
-    return {};
 }
 
-std::map<std::string, std::deque<float>> UIAdapter::GetAllTempHistory() const {
+void UIAdapter::SetTrayUpdateCallback(TrayUpdateCallback callback) {
     std::lock_guard<std::mutex> lock(m_mutex);
-    return m_state.TempHistory;
+    m_trayCallback = std::move(callback);
 }
 
 void UIAdapter::OnThermalEvent(const ThermalEvent& event) {
@@ -175,7 +231,14 @@ void UIAdapter::HandleTemperatureUpdate(const TemperatureUpdateEvent& e) {
     std::lock_guard<std::mutex> lock(m_mutex);
     
     // Update sensor data
-    for (const auto& reading : e.sensors) {
+    if (!e.sensors) return;
+    
+    // Wall-clock time of the reading, so the persisted history lines up across restarts
+    auto age = std::chrono::steady_clock::now() - e.timestamp;
+    int64_t unixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch() - age).count();
+    
+    for (const auto& reading : *e.sensors) {
         if (reading.index >= 0 && reading.index < (int)m_state.Sensors.size()) {
             auto& sensor = m_state.Sensors[reading.index];
             sensor.name = reading.name;
@@ -190,20 +253,9 @@ void UIAdapter::HandleTemperatureUpdate(const TemperatureUpdateEvent& e) {
                 m_state.SmoothTemps[reading.name].Target = (float)reading.rawTemp;
             }
             
-            // Update history
-            if (reading.isAvailable) {
-                auto& history = m_state.TempHistory[reading.name];
-                float valToPush = (float)reading.rawTemp;
-                
-                // Use last valid value if current is invalid
-                if ((reading.rawTemp <= 0 || reading.rawTemp >= 128) && !history.empty()) {
-                    valToPush = history.back();
-                }
-                
-                history.push_back(valToPush);
-                while (history.size() > HISTORY_MAX_SIZE) {
-                    history.pop_front();
-                }
+            // Update history; invalid readings are skipped and show as held or NaN gaps
+            if (reading.isAvailable && reading.rawTemp > 0 && reading.rawTemp < 128) {
+                m_history.Push(reading.index, unixMs, (float)reading.rawTemp);
             }
         }
     }
@@ -214,13 +266,6 @@ void UIAdapter::HandleTemperatureUpdate(const TemperatureUpdateEvent& e) {
     m_state.MaxSensorName = e.maxSensorName;
     m_state.LastUpdate = time(nullptr);
     m_state.IsOperational = true;
-    
-    // Run autotune logic if active
-    if (m_state.Autotune.Stage != AutotuneStep::Idle &&
-        m_state.Autotune.Stage != AutotuneStep::Success &&
-        m_state.Autotune.Stage != AutotuneStep::Failed) {
-        UpdateAutotuneLogic((float)e.maxTemp);
-    }
 }
 
 void UIAdapter::HandleFanStateChange(const FanStateChangeEvent& e) {
@@ -235,9 +280,11 @@ void UIAdapter::HandleModeChange(const ModeChangeEvent& e) {
     
     switch (e.newMode) {
         case ControlMode::BIOS:   m_state.Mode = 0; break;
-        case ControlMode::Manual: m_state.Mode = 1; break;
+        case ControlMode::Manual: m_state.Mode = 1; m_state.UseTargetRpm = false; break;
+        case ControlMode::RPM:    m_state.Mode = 1; m_state.UseTargetRpm = true; break;
         case ControlMode::Smart:  m_state.Mode = 2; break;
         case ControlMode::PID:    m_state.Mode = 2; m_state.Algorithm = 1; break;
+        case ControlMode::MPC:    m_state.Mode = 2; m_state.Algorithm = 2; break;
     }
     
     m_state.SmartProfile = e.smartProfileIndex;
@@ -267,60 +314,4 @@ void UIAdapter::HandleLog(const LogEvent& e) {
     Log::UILogBuffer::Get().Add(level, "{}", e.message);
 }
 
-void UIAdapter::UpdateAutotuneLogic(float currentTemp) {
-    // This is kept for backwards compatibility with the existing autotune UI
-    float target = m_state.PID.targetTemp;
-    
-    if (m_state.Autotune.LastTemp > 0) {
-        if (m_state.Autotune.Rising && currentTemp < m_state.Autotune.LastTemp - 0.1f) {
-            // Peak found
-            if (m_state.Autotune.CyclesCount < 10) {
-                m_state.Autotune.Peaks[m_state.Autotune.CyclesCount] = m_state.Autotune.CurrentMax;
-                auto now = std::chrono::steady_clock::now();
-                m_state.Autotune.PeakTimes[m_state.Autotune.CyclesCount] = 
-                    (float)std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() / 1000.0f;
-            }
-            m_state.Autotune.Rising = false;
-            m_state.Autotune.CurrentMin = currentTemp;
-        } else if (!m_state.Autotune.Rising && currentTemp > m_state.Autotune.LastTemp + 0.1f) {
-            // Trough found
-            if (m_state.Autotune.CyclesCount < 10) {
-                m_state.Autotune.Troughs[m_state.Autotune.CyclesCount] = m_state.Autotune.CurrentMin;
-                auto now = std::chrono::steady_clock::now();
-                m_state.Autotune.TroughTimes[m_state.Autotune.CyclesCount] = 
-                    (float)std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() / 1000.0f;
-                m_state.Autotune.CyclesCount++;
-            }
-            m_state.Autotune.Rising = true;
-            m_state.Autotune.CurrentMax = currentTemp;
-            
-            if (m_state.Autotune.CyclesCount >= 4) {
-                // Calculate Ziegler-Nichols parameters
-                float sumA = 0, sumP = 0;
-                for (int i = 1; i < 4; i++) {
-                    sumA += (m_state.Autotune.Peaks[i] - m_state.Autotune.Troughs[i]);
-                    sumP += (m_state.Autotune.PeakTimes[i] - m_state.Autotune.PeakTimes[i-1]);
-                }
-                float A = sumA / 3.0f;
-                float P = sumP / 3.0f;
-                float Ku = (4.0f * 100.0f) / (3.14159f * A);
-                
-                // No-overshoot parameters (conservative)
-                m_state.PID.Kp = 0.2f * Ku;
-                float Ti = 0.5f * P;
-                float Td = 0.33f * P;
-                m_state.PID.Ki = m_state.PID.Kp / Ti;
-                m_state.PID.Kd = m_state.PID.Kp * Td;
-                
-                m_state.Autotune.Stage = AutotuneStep::Success;
-                m_state.Autotune.Status = "Autotune complete!";
-            }
-        }
-    }
-    
-    if (currentTemp > m_state.Autotune.CurrentMax) m_state.Autotune.CurrentMax = currentTemp;
-    if (currentTemp < m_state.Autotune.CurrentMin) m_state.Autotune.CurrentMin = currentTemp;
-    m_state.Autotune.LastTemp = currentTemp;
-}
-
 } // namespace Core
@@ -4,9 +4,9 @@
 
 #include "ThermalManager.h"
 #include "Events.h"
+#include "HistoryStore.h"
 #include "../CommonTypes.h"
 #include <mutex>
-#include <deque>
 #include <map>
 #include <vector>
 #include <string>
@@ -23,20 +23,14 @@ struct SmoothValue {
     }
 };
 
-/// Autotune state (kept for backwards compatibility with existing UI)
+/// Autotune state (mirrors ThermalManager's RelayAutotuner for the UI)
 enum class AutotuneStep { Idle, WaitingForHeat, Oscillating, Success, Failed };
 
 struct AutotuneContext {
     AutotuneStep Stage = AutotuneStep::Idle;
     int CyclesCount = 0;
-    float Peaks[10] = {};
-    float Troughs[10] = {};
-    float PeakTimes[10] = {};
-    float TroughTimes[10] = {};
-    float LastTemp = 0.0f;
-    bool Rising = true;
-    float CurrentMax = -1.0f;
-    float CurrentMin = 200.0f;
+    float UltimateGain = 0.0f;
+    float UltimatePeriod = 0.0f;
     std::string Status;
 };
 
@@ -46,7 +40,6 @@ struct UISnapshot {
     // Sensor data
     std::vector<SensorData> Sensors;
     std::map<std::string, SmoothValue> SmoothTemps;
-    std::map<std::string, std::deque<float>> TempHistory;
     
     // Fan data
     int Fan1Speed = 0;
@@ -56,10 +49,12 @@ struct UISnapshot {
     // Control state
     int Mode = 2;  // 0: BIOS, 1: Manual, 2: Smart
     int ManualLevel = 0;
+    bool UseTargetRpm = false;  // Manual mode holds TargetRpm instead of a level
+    int TargetRpm = 3000;
     int SmartProfile = 0;
     
     // Algorithm selection (for UI display)
-    int Algorithm = 0;  // 0: Step, 1: PID
+    int Algorithm = 0;  // 0: Step, 1: PID, 2: MPC
     PIDSettings PID;
     
     // Max temp info
@@ -90,7 +85,8 @@ class UIAdapter {
 public:
     using TrayUpdateCallback = std::function<void(int temp, int fanSpeed)>;
     
-    explicit UIAdapter(std::shared_ptr<ThermalManager> manager);
+    /// @param historyPath File backing the temperature history (empty: memory only)
+    explicit UIAdapter(std::shared_ptr<ThermalManager> manager, const std::string& historyPath = "");
     ~UIAdapter();
     
     // Non-copyable
@@ -121,6 +117,12 @@ public:
     /// Set manual fan level (0-7)
     void SetManualLevel(int level);
     
+    /// Hold a fan speed instead of a level (switches to RPM mode)
+    void SetTargetRpm(int rpm);
+    
+    /// Toggle between fixed level (Manual) and fixed speed (RPM) control
+    void SetUseTargetRpm(bool enabled);
+    
     /// Set smart profile index (0 or 1)
     void SetSmartProfile(int profile);
     
@@ -143,11 +145,8 @@ public:
     
     // --- History ---
     
-    /// Get temperature history for a sensor (for plotting)
-    std::deque<float> GetTempHistory(const std::string& sensorName) const;
-    
-    /// Get all temperature history (for plotting)
-    std::map<std::string, std::deque<float>> GetAllTempHistory() const;
+    /// Temperature history by sensor index (for plotting, read through HistoryStore::Read())
+    const HistoryStore& GetHistory() const { return m_history; }
     
 private:
     void OnThermalEvent(const ThermalEvent& event);
@@ -156,7 +155,7 @@ private:
     void HandleModeChange(const ModeChangeEvent& e);
     void HandleError(const ErrorEvent& e);
     void HandleLog(const LogEvent& e);
-    void UpdateAutotuneLogic(float currentTemp);
+    void SyncAutotuneProgress();
     
     std::shared_ptr<ThermalManager> m_manager;
     EventDispatcher::SubscriptionId m_subscriptionId;
@@ -164,10 +163,10 @@ private:
     mutable std::mutex m_mutex;
     UISnapshot m_state;
     
+    HistoryStore m_history;
+    
     TrayUpdateCallback m_trayCallback;
     int m_trayUpdateCounter = 0;
-    
-    static constexpr int HISTORY_MAX_SIZE = 300;
 };
 
 } // namespace Core
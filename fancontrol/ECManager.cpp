@@ -21,6 +21,16 @@ ECManager::ECManager(std::shared_ptr<IIOProvider> ioProvider, std::function<void
 
 ECManager::~ECManager() {}
 
+ECManager::Counters ECManager::GetCounters() const {
+    return Counters{
+        .bytesRead = m_bytesRead.load(std::memory_order_relaxed),
+        .bytesWritten = m_bytesWritten.load(std::memory_order_relaxed),
+        .timeouts = m_timeouts.load(std::memory_order_relaxed),
+        .retries = m_retries.load(std::memory_order_relaxed),
+        .typeSwitches = m_typeSwitches.load(std::memory_order_relaxed)
+    };
+}
+
 bool ECManager::WaitForFlags(USHORT port, char flags, bool onoff, int timeout) {
     char data;
     int time = 0, sleepTicks = 10;
@@ -35,12 +45,15 @@ bool ECManager::WaitForFlags(USHORT port, char flags, bool onoff, int timeout) {
 
         bool flagstate = (data & flags) != 0;
         if (flagstate == onoff) return true;
-        ::Sleep(sleepTicks);
+        if (IsPreempted()) return false;  // Not an EC timeout: the fail-safe wants the mutex
+        Platform::SleepMs(sleepTicks);
     }
+    m_timeouts.fetch_add(1, std::memory_order_relaxed);
     return false;
 }
 
 void ECManager::SwitchECType() {
+    m_typeSwitches.fetch_add(1, std::memory_order_relaxed);
     auto newType = (m_currentType == ECType::Type1) ? ECType::Type2 : ECType::Type1;
     ApplyECType(newType);
     if (m_trace) {
@@ -76,7 +89,7 @@ bool ECManager::ReadByte(int offset, char* pdata) {
             char status = m_io->ReadPort(m_ctrlPort);
             if (!(status & ACPI_EC_FLAG_OBF)) break;
             m_io->ReadPort(m_dataPort);
-            ::Sleep(1);
+            Platform::SleepMs(1);
         }
     };
 
@@ -103,15 +116,21 @@ bool ECManager::ReadByte(int offset, char* pdata) {
         }
 
         *pdata = m_io->ReadPort(m_dataPort);
+        m_bytesRead.fetch_add(1, std::memory_order_relaxed);
         if (m_trace) m_trace(std::format("readec: offset 0x{:02X} -> 0x{:02X}", offset, (unsigned char)*pdata).c_str());
         return true;
     };
 
     if (attemptRead()) return true;
+    if (IsPreempted()) {
+        if (m_trace) m_trace("readec: preempted by fail-safe");
+        return false;
+    }
 
     // If failed, switch type and try one more time
     if (m_trace) m_trace("readec: timed out, switching EC type and retrying...");
     SwitchECType();
+    m_retries.fetch_add(1, std::memory_order_relaxed);
     
     if (attemptRead()) return true;
 
@@ -127,7 +146,7 @@ bool ECManager::WriteByte(int offset, char data) {
             char status = m_io->ReadPort(m_ctrlPort);
             if (!(status & ACPI_EC_FLAG_OBF)) break;
             m_io->ReadPort(m_dataPort);
-            ::Sleep(1);
+            Platform::SleepMs(1);
         }
     };
 
@@ -160,15 +179,21 @@ bool ECManager::WriteByte(int offset, char data) {
             return false;
         }
 
+        m_bytesWritten.fetch_add(1, std::memory_order_relaxed);
         if (m_trace) m_trace(std::format("writeec: offset 0x{:02X} <= 0x{:02X}", offset, (unsigned char)data).c_str());
         return true;
     };
 
     if (attemptWrite()) return true;
+    if (IsPreempted()) {
+        if (m_trace) m_trace("writeec: preempted by fail-safe");
+        return false;
+    }
 
     // If failed, switch type and try one more time
     if (m_trace) m_trace("writeec: timed out, switching EC type and retrying...");
     SwitchECType();
+    m_retries.fetch_add(1, std::memory_order_relaxed);
 
     if (attemptWrite()) return true;
 
@@ -176,15 +201,26 @@ bool ECManager::WriteByte(int offset, char data) {
     return false;
 }
 
+std::unique_lock<std::recursive_timed_mutex> ECManager::Preempt(int timeoutMs) {
+    m_preempt.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::recursive_timed_mutex> lock(m_mutex, std::defer_lock);
+    (void)lock.try_lock_for(std::chrono::milliseconds(timeoutMs));
+    m_preempt.fetch_sub(1, std::memory_order_relaxed);
+
+    if (m_trace && !lock.owns_lock()) m_trace("preempt: EC mutex still busy, giving up");
+    return lock;
+}
+
 bool ECManager::ToggleBitsWithVerify(int offset, char bits, char anywayBit, char& resultValue) {
     std::lock_guard<std::recursive_timed_mutex> lock(m_mutex);
     char currentVal;
     char targetVal;
     bool ok = false;
 
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < 5 && !IsPreempted(); i++) {
+        if (i > 0) m_retries.fetch_add(1, std::memory_order_relaxed);
         if (!ReadByte(offset, &currentVal)) {
-            ::Sleep(300);
+            Platform::SleepMs(300);
             continue;
         }
 
@@ -195,7 +231,7 @@ bool ECManager::ToggleBitsWithVerify(int offset, char bits, char anywayBit, char
         }
 
         if (!WriteByte(offset, targetVal)) {
-            ::Sleep(300);
+            Platform::SleepMs(300);
             continue;
         }
 
@@ -204,7 +240,7 @@ bool ECManager::ToggleBitsWithVerify(int offset, char bits, char anywayBit, char
             break;
         }
 
-        ::Sleep(300);
+        Platform::SleepMs(300);
     }
     return ok;
 }
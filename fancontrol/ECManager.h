@@ -1,6 +1,8 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -21,6 +23,23 @@ public:
     bool ToggleBitsWithVerify(int offset, char bits, char anywayBit, char& resultValue);
     std::recursive_timed_mutex& GetMutex() { return m_mutex; }
 
+    // Fail-safe path for the watchdog: a transaction in progress on another
+    // thread gives up at its next handshake poll, so its owner lets go of the
+    // mutex. The returned lock does not own the mutex if that took over timeoutMs.
+    std::unique_lock<std::recursive_timed_mutex> Preempt(int timeoutMs);
+    // True while Preempt() waits; multi-transaction loops should bail out
+    bool IsPreempted() const { return m_preempt.load(std::memory_order_relaxed) > 0; }
+
+    // Traffic counters since construction, readable from any thread
+    struct Counters {
+        uint64_t bytesRead;
+        uint64_t bytesWritten;
+        uint64_t timeouts;      // Handshake waits that expired
+        uint64_t retries;       // Transactions repeated after a failure
+        uint64_t typeSwitches;
+    };
+    Counters GetCounters() const;
+
 private:
     bool WaitForFlags(USHORT port, char flags, bool onoff = false, int timeout = 2000);
     void SwitchECType();
@@ -33,6 +52,13 @@ private:
     ECType m_currentType;
     std::function<void(const char*)> m_trace;
     std::recursive_timed_mutex m_mutex;
+    std::atomic<int> m_preempt{0};  // Preempt() calls waiting for the mutex
+
+    std::atomic<uint64_t> m_bytesRead{0};
+    std::atomic<uint64_t> m_bytesWritten{0};
+    std::atomic<uint64_t> m_timeouts{0};
+    std::atomic<uint64_t> m_retries{0};
+    std::atomic<uint64_t> m_typeSwitches{0};
 
     static constexpr auto ACPI_EC_TYPE1_CTRLPORT = 0x1604;
     static constexpr auto ACPI_EC_TYPE1_DATAPORT = 0x1600;
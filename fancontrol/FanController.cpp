@@ -11,7 +11,24 @@ bool FanController::SetFanLevel(int level) {
 bool FanController::SetFanLevel(int level, bool isDualFan) {
     std::lock_guard<std::recursive_timed_mutex> lock(m_ecManager->GetMutex());
     const bool dualWrites = isDualFan && m_dualFanOperational;
+
+    // Skip the write/sleep/verify loop if the verified state already matches
+    if (m_currentFanCtrl == level && (!dualWrites || m_fan2Ctrl == level)) {
+        ++m_suppressedCommands;
+        return true;
+    }
+    return WriteFanLevel(level, isDualFan);
+}
+
+bool FanController::ReapplyFanLevel(int level) {
+    std::lock_guard<std::recursive_timed_mutex> lock(m_ecManager->GetMutex());
+    return WriteFanLevel(level, IsDualFanActive());
+}
+
+bool FanController::WriteFanLevel(int level, bool isDualFan) {
+    const bool dualWrites = isDualFan && m_dualFanOperational;
     bool ok = false;
+    ++m_issuedCommands;
     if (m_writeCallback) {
         ok = m_writeCallback(level);
     } else {
@@ -20,21 +37,21 @@ bool FanController::SetFanLevel(int level, bool isDualFan) {
                 // Set Fan 1
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN1);
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)level);
-                ::Sleep(100);
+                Platform::SleepMs(100);
 
                 // Set Fan 2
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN2);
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)level);
-                ::Sleep(100);
+                Platform::SleepMs(100);
 
                 // Verify Fan 2
                 char currentFan2 = 0;
                 bool fan2_ok = m_ecManager->ReadByte(TP_ECOFFSET_FAN, &currentFan2);
-                ::Sleep(100);
+                Platform::SleepMs(100);
 
                 // Switch back to Fan 1 and Verify
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN1);
-                ::Sleep(100);
+                Platform::SleepMs(100);
                 char currentFan1 = 0;
                 bool fan1_ok = m_ecManager->ReadByte(TP_ECOFFSET_FAN, &currentFan1);
 
@@ -44,19 +61,21 @@ bool FanController::SetFanLevel(int level, bool isDualFan) {
                 }
             } else {
                 m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)level);
-                ::Sleep(100);
+                Platform::SleepMs(100);
                 char currentFan = 0;
                 if (m_ecManager->ReadByte(TP_ECOFFSET_FAN, &currentFan) && (unsigned char)currentFan == (unsigned char)level) {
                     ok = true;
                     break;
                 }
             }
-            ::Sleep(300);
+            if (m_ecManager->IsPreempted()) break; // Let the watchdog fail-safe have the EC
+            Platform::SleepMs(300);
         }
     }
 
     if (ok) {
         m_currentFanCtrl = level;
+        if (dualWrites) m_fan2Ctrl = level;
         if (m_onChange) m_onChange(level);
     }
     return ok;
@@ -64,18 +83,29 @@ bool FanController::SetFanLevel(int level, bool isDualFan) {
 
 bool FanController::SetFanLevels(int level1, int level2) {
     std::lock_guard<std::recursive_timed_mutex> lock(m_ecManager->GetMutex());
+    if (m_writeCallback || !IsDualFanActive()) {
+        // Only one fan answers; drive it with the more demanding command
+        return SetFanLevel((std::max)(level1, level2), false);
+    }
+
+    if (m_currentFanCtrl == level1 && m_fan2Ctrl == level2) {
+        ++m_suppressedCommands;
+        return true;
+    }
+    ++m_issuedCommands;
+
     bool ok1 = false, ok2 = false;
 
     for (int i = 0; i < 3; i++) {
         // Set Fan 1
         m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN1);
         m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)level1);
-        ::Sleep(50);
+        Platform::SleepMs(50);
 
         // Set Fan 2
         m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, TP_ECVALUE_SELFAN2);
         m_ecManager->WriteByte(TP_ECOFFSET_FAN, (char)level2);
-        ::Sleep(50);
+        Platform::SleepMs(50);
 
         // Verify
         char c1, c2;
@@ -88,19 +118,19 @@ bool FanController::SetFanLevels(int level1, int level2) {
             ok1 = ok2 = true;
             break;
         }
-        ::Sleep(100);
+        if (m_ecManager->IsPreempted()) break;
+        Platform::SleepMs(100);
     }
 
     if (ok1 && ok2) {
         m_currentFanCtrl = level1; // For legacy compatibility
+        m_fan2Ctrl = level2;
         if (m_onChange) m_onChange(level1);
     }
     return ok1 && ok2;
 }
 
-bool FanController::UpdateSmartControl(int maxTemp, const std::vector<SmartLevel>& levels) {
-    if (levels.empty()) return false;
-
+int FanController::SelectSmartLevel(int maxTemp, const std::vector<SmartLevel>& levels, int currentLevel, int& lastLevelIndex) {
     int newFanCtrl = -1;
     int levelIndex = -1;
 
@@ -114,28 +144,43 @@ bool FanController::UpdateSmartControl(int maxTemp, const std::vector<SmartLevel
         }
     }
 
-    if (newFanCtrl != -1 && newFanCtrl != m_currentFanCtrl) {
-        if (m_lastSmartLevelIndex != -1) {
-            const auto& lastLevel = levels[m_lastSmartLevelIndex];
+    if (newFanCtrl != -1 && newFanCtrl != currentLevel) {
+        if (lastLevelIndex != -1 && lastLevelIndex < (int)levels.size()) {
+            const auto& lastLevel = levels[lastLevelIndex];
             
-            if (levelIndex < m_lastSmartLevelIndex) { // Cooling down
+            if (levelIndex < lastLevelIndex) { // Cooling down
                 if (maxTemp >= lastLevel.temp - lastLevel.hystDown)
-                    return true; // Stay in current (higher) level
+                    return -1; // Stay in current (higher) level
             } else { // Heating up
                 const auto& newLevel = levels[levelIndex];
                 if (maxTemp < newLevel.temp + newLevel.hystUp)
-                    return true; // Stay in current (lower) level
+                    return -1; // Stay in current (lower) level
             }
         }
 
-        m_lastSmartLevelIndex = levelIndex;
+        lastLevelIndex = levelIndex;
+        return newFanCtrl;
+    }
+
+    return -1;
+}
+
+bool FanController::UpdateSmartControl(int maxTemp, const std::vector<SmartLevel>& levels) {
+    if (levels.empty()) return false;
+
+    int newFanCtrl = SelectSmartLevel(maxTemp, levels, m_currentFanCtrl, m_lastSmartLevelIndex);
+    if (newFanCtrl != -1) {
         return SetFanLevel(newFanCtrl);
     }
 
     return true;
 }
 
-bool FanController::UpdatePIDControl(float currentTemp, const PIDSettings& settings, float dt) {
+float FanController::ComputePIDOutput(float currentTemp, const PIDSettings& settings, float dt) {
+    return ComputePIDOutput(m_pid, currentTemp, settings, dt);
+}
+
+float FanController::ComputePIDOutput(PIDState& state, float currentTemp, const PIDSettings& settings, float dt) {
     // Sanity check for dt to avoid spikes after pause/resume
     if (dt <= 0.0f) dt = 1.0f;
     if (dt > 5.0f) dt = 5.0f;
@@ -146,27 +191,33 @@ bool FanController::UpdatePIDControl(float currentTemp, const PIDSettings& setti
     float P = settings.Kp * error;
     
     // Integral (with basic anti-windup)
-    m_integral += error * dt;
-    float I = settings.Ki * m_integral;
+    state.integral += error * dt;
+    float I = settings.Ki * state.integral;
     
     // Derivative (on error)
-    float D = settings.Kd * (error - m_lastError) / dt;
-    m_lastError = error;
+    float D = settings.Kd * (error - state.lastError) / dt;
+    state.lastError = error;
     
     float output = P + I + D;
     
     // Anti-windup: clamp integral if output exceeds limits
     if (output > settings.maxFan) {
-        if (error > 0) m_integral -= error * dt; // Stop integrating if we're already over max
+        if (error > 0) state.integral -= error * dt; // Stop integrating if we're already over max
         output = settings.maxFan;
     } else if (output < settings.minFan) {
-        if (error < 0) m_integral -= error * dt; // Stop integrating if we're already under min
+        if (error < 0) state.integral -= error * dt; // Stop integrating if we're already under min
         output = settings.minFan;
     }
-    
+
+    spdlog::debug("[PID] Temp={:.1f}, Error={:.1f}, P={:.2f}, I={:.2f}, D={:.2f}, Output={:.2f}",
+                  currentTemp, error, P, I, D, output);
+    return output;
+}
+
+int FanController::MapPIDOutputToLevel(float output, int currentLevel, const PIDSettings& settings) {
     // Map output to fan levels (0-7) with hysteresis
     // We use a threshold to avoid oscillating between two levels
-    int targetLevel = m_currentFanCtrl;
+    int targetLevel = currentLevel;
     if (targetLevel < 0 || targetLevel > 127) targetLevel = 0; // Handle BIOS/Initial state
 
     float currentLevelF = (float)targetLevel;
@@ -182,11 +233,16 @@ bool FanController::UpdatePIDControl(float currentTemp, const PIDSettings& setti
     }
     
     // Ensure target is within bounds
-    targetLevel = std::clamp(targetLevel, (int)settings.minFan, (int)settings.maxFan);
+    return std::clamp(targetLevel, (int)settings.minFan, (int)settings.maxFan);
+}
+
+bool FanController::UpdatePIDControl(float currentTemp, const PIDSettings& settings, float dt) {
+    float output = ComputePIDOutput(currentTemp, settings, dt);
+    int targetLevel = MapPIDOutputToLevel(output, m_currentFanCtrl, settings);
     
     if (targetLevel != m_currentFanCtrl) {
-        spdlog::info("[PID] Temp={:.1f}, Error={:.1f}, P={:.2f}, I={:.2f}, D={:.2f}, Output={:.2f}, Level {}->{}", 
-                     currentTemp, error, P, I, D, output, m_currentFanCtrl, targetLevel);
+        spdlog::info("[PID] Temp={:.1f}, Output={:.2f}, Level {}->{}", 
+                     currentTemp, output, m_currentFanCtrl, targetLevel);
         return SetFanLevel(targetLevel);
     }
     
@@ -211,7 +267,14 @@ bool FanController::GetFanSpeeds(int& fan1, int& fan2) {
     fan2 = 0;
 
     auto readFanSpeed = [this](char fanSelect, int& rpmOut) -> bool {
-        m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, fanSelect);
+        if (!m_ecManager->WriteByte(TP_ECOFFSET_FAN_SWITCH, fanSelect)) {
+            // Unknown which fan the EC now addresses: distrust both verified levels
+            spdlog::warn("[FanCtrl] Fan select 0x{:02X} failed", (unsigned char)fanSelect);
+            m_currentFanCtrl = -1;
+            m_fan2Ctrl = -1;
+            rpmOut = 0;
+            return false;
+        }
         spdlog::debug("[FanCtrl] Select fan 0x{:02X}", (unsigned char)fanSelect);
 
         char lo = 0;
@@ -232,6 +295,12 @@ bool FanController::GetFanSpeeds(int& fan1, int& fan2) {
     bool fan2ReadSuccess = false;
     if (dualEnabled) {
         fan2ReadSuccess = readFanSpeed(TP_ECVALUE_SELFAN2, fan2);
+
+        // Fan 2 is selected anyway: read its level back so SetFanLevel(s)
+        // never coalesces against a stale value (-1 forces the next write)
+        char level2 = 0;
+        m_fan2Ctrl = fan2ReadSuccess && m_ecManager->ReadByte(TP_ECOFFSET_FAN, &level2)
+            ? (unsigned char)level2 : -1;
     }
 
     if (!readFanSpeed(TP_ECVALUE_SELFAN1, fan1)) {
@@ -20,6 +20,11 @@ struct PIDSettings {
     float maxFan = 7.0f;
 };
 
+struct PIDState {
+    float integral = 0.0f;
+    float lastError = 0.0f;
+};
+
 class FanController {
 public:
     FanController(std::shared_ptr<ECManager> ecManager);
@@ -27,13 +32,21 @@ public:
     bool SetFanLevel(int level, bool isDualFan);
     bool SetFanLevel(int level); // Uses internal m_isDualFan
     bool SetFanLevels(int level1, int level2);
+    bool ReapplyFanLevel(int level); // Writes even if the shadow state already matches
     bool UpdateSmartControl(int maxTemp, const std::vector<SmartLevel>& levels);
     bool UpdatePIDControl(float currentTemp, const PIDSettings& settings, float dt);
+    float ComputePIDOutput(float currentTemp, const PIDSettings& settings, float dt); // Advances PID state, returns fractional level
+
+    // Pure decision helpers shared with per-fan control zones (no EC access)
+    static int SelectSmartLevel(int maxTemp, const std::vector<SmartLevel>& levels, int currentLevel, int& lastLevelIndex);
+    static float ComputePIDOutput(PIDState& state, float currentTemp, const PIDSettings& settings, float dt);
+    static int MapPIDOutputToLevel(float output, int currentLevel, const PIDSettings& settings);
     
-    bool GetFanSpeeds(int& fan1, int& fan2);
-    bool RefreshCurrentLevel();
+    bool GetFanSpeeds(int& fan1, int& fan2); // Also reads fan 2's level back when dual
+    bool RefreshCurrentLevel(); // Reads fan 1's control register back (fan 2: GetFanSpeeds)
     int GetCurrentFanCtrl() const { return m_currentFanCtrl; }
     int GetCurrentLevel() const { return m_currentFanCtrl; }  // Alias for Core compatibility
+    int GetFanLevel(int fanIndex) const { return fanIndex == 0 ? m_currentFanCtrl : m_fan2Ctrl; } // Last verified level per fan
     void SetCurrentFanCtrl(int ctrl) { m_currentFanCtrl = ctrl; }
     void SetOnChangeCallback(std::function<void(int)> callback) { m_onChange = callback; }
     void SetWriteCallback(std::function<bool(int)> callback) { m_writeCallback = callback; }
@@ -45,20 +58,28 @@ public:
     void SetFanSpeedAddr(int addr) { m_fanSpeedAddr = addr; }
     bool IsDualFanActive() const { return m_isDualFan && m_dualFanOperational; }
 
+    // Command coalescing counters (commands that reached the EC vs. no-ops dropped)
+    uint64_t GetIssuedCommands() const { return m_issuedCommands; }
+    uint64_t GetSuppressedCommands() const { return m_suppressedCommands; }
+
 private:
+    bool WriteFanLevel(int level, bool isDualFan);
+
     std::shared_ptr<ECManager> m_ecManager;
     int m_currentFanCtrl;
     int m_lastSmartLevelIndex;
+    int m_fan2Ctrl = -1;
     bool m_isDualFan = false;
     bool m_dualFanOperational = false;
     int m_fanSpeedAddr = TP_ECOFFSET_FANSPEED;
     int m_fan2ZeroCount = 0;
+    uint64_t m_issuedCommands = 0;
+    uint64_t m_suppressedCommands = 0;
     static constexpr int kFan2DisableThreshold = 5;
     static constexpr int kFan1ActiveRpmThreshold = 400;
     
     // PID State
-    float m_integral = 0.0f;
-    float m_lastError = 0.0f;
+    PIDState m_pid;
     
     std::function<void(int)> m_onChange;
     std::function<bool(int)> m_writeCallback;
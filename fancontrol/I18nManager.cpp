@@ -54,8 +54,11 @@ void I18nManager::LoadTranslations() {
     en["MODE_SMART"] = "Smart";
     en["ALGO_STEP"] = "Step (Classic)";
     en["ALGO_PID"] = "PID (Modern)";
+    en["ALGO_MPC"] = "MPC (Predictive)";
     en["BTN_MINIMIZE"] = "Minimize to Tray";
     en["LBL_MANUAL_LEVEL"] = "Manual Level:";
+    en["OPT_TARGET_RPM"] = "Hold fan speed (RPM)";
+    en["LBL_TARGET_RPM"] = "Target Speed:";
     en["LBL_ALGORITHM"] = "Algorithm:";
     en["LBL_TEMP"] = "Temp";
     en["LBL_FAN"] = "Fan";
@@ -126,8 +129,11 @@ void I18nManager::LoadTranslations() {
     zh["MODE_SMART"] = "\xE6\x99\xBA\xE8\x83\xBD\xE6\xA8\xA1\xE5\xBC\x8F";
     zh["ALGO_STEP"] = "\xE5\x88\x86\xE7\xBA\xA7\xE6\x8E\xA7\xE5\x88\xB6 (\xE7\xBB\x8F\xE5\x85\xB8)";
     zh["ALGO_PID"] = "PID \xE6\x8E\xA7\xE5\x88\xB6 (\xE7\x8E\xB0\xE4\xBB\xA3)";
+    zh["ALGO_MPC"] = "MPC \xE6\x8E\xA7\xE5\x88\xB6 (\xE9\xA2\x84\xE6\xB5\x8B)";
     zh["BTN_MINIMIZE"] = "\xE6\x9C\x80\xE5\xB0\x8F\xE5\x8C\x96\xE5\x88\xB0\xE6\x89\x98\xE7\x9B\x98";
     zh["LBL_MANUAL_LEVEL"] = "\xE6\x89\x8B\xE5\x8A\xA8\xE6\x8C\xA1\xE4\xBD\x8D:";
+    zh["OPT_TARGET_RPM"] = "\xE4\xBF\x9D\xE6\x8C\x81\xE9\xA3\x8E\xE6\x89\x87\xE8\xBD\xAC\xE9\x80\x9F (RPM)";
+    zh["LBL_TARGET_RPM"] = "\xE7\x9B\xAE\xE6\xA0\x87\xE8\xBD\xAC\xE9\x80\x9F:";
     zh["LBL_ALGORITHM"] = "\xE6\x8E\xA7\xE5\x88\xB6\xE7\xAE\x97\xE6\xB3\x95:";
     zh["LBL_TEMP"] = "\xE6\xB8\xA9\xE5\xBA\xA6";
     zh["LBL_FAN"] = "\xE9\xA3\x8E\xE6\x89\x87";
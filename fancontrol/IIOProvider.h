@@ -1,6 +1,6 @@
 #pragma once
 
-#include <windows.h>
+#include "Platform.h"
 
 // Abstract I/O Provider interface for decoupling hardware access
 class IIOProvider {
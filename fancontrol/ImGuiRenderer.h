@@ -8,6 +8,7 @@
 #include "Theme.h"
 #include "I18nManager.h"
 #include "CommonTypes.h"
+#include "LogManager.h"
 #include <vector>
 #include <deque>
 #include <map>
@@ -100,15 +101,24 @@ inline void DrawSubsectionHeader(const char* labelKey) {
 // Log Panel Component
 // ============================================================================
 
-inline void DrawLogPanel(const std::deque<std::string>& items) {
+// Only the rows inside the scroll view are formatted
+inline void DrawLogPanel(const std::vector<Log::Record>& records) {
+    static std::string line;
     ImGui::BeginChild("LogScroll");
-    for (const auto& line : items) {
-        if (line.find("[ERROR]") != std::string::npos) {
-            ImGui::TextColored(Theme::TempHot(), "%s", line.c_str());
-        } else if (line.find("[WARN]") != std::string::npos) {
-            ImGui::TextColored(Theme::TempWarm(), "%s", line.c_str());
-        } else {
-            ImGui::TextUnformatted(line.c_str());
+    ImGuiListClipper clipper;
+    clipper.Begin((int)records.size());
+    while (clipper.Step()) {
+        for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+            const Log::Record& record = records[i];
+            line.clear();
+            Log::UILogBuffer::Format(record, line);
+            if (record.level == Log::Level::Error) {
+                ImGui::TextColored(Theme::TempHot(), "%s", line.c_str());
+            } else if (record.level == Log::Level::Warn) {
+                ImGui::TextColored(Theme::TempWarm(), "%s", line.c_str());
+            } else {
+                ImGui::TextUnformatted(line.data(), line.data() + line.size());
+            }
         }
     }
     if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
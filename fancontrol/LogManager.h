@@ -3,10 +3,17 @@
 // LogManager.h - Unified logging system for TPFanCtrl2
 // Wraps spdlog and provides a unified interface for both Win32 and ImGui UIs
 
-#include <string>
-#include <deque>
-#include <mutex>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Core/LogArgs.h"
 #include "spdlog/spdlog.h"
 
 namespace Log {
@@ -19,61 +26,136 @@ enum class Level {
     Error
 };
 
+// One UI log line before formatting: the format literal plus its arguments in
+// binary form. Trivially copyable, so the UI can copy records without allocating.
+struct Record {
+    static constexpr size_t kArgBytes = 232;
+
+    Level level;
+    uint16_t argBytes;
+    int64_t timeMs;                 // Wall clock, ms since the epoch
+    const char* fmt;                // Format literal (static storage)
+    uint32_t fmtSize;
+    Core::LogArgs::FormatFn format; // Format ID: one instantiation per argument type list
+    std::byte args[kArgBytes];      // Arguments; strings are copied in (and truncated to fit)
+
+    std::string_view Format() const { return { fmt, fmtSize }; }
+};
+
 // UI-visible log buffer (for ImGui log panel)
+//
+// A fixed ring of Records that any thread can write without locking. Each
+// slot has a sequence number that is odd while the slot is written. Writers
+// claim a slot by compare-and-swap on it, so a slot never has two writers, and
+// a reader can skip slots in flight and detect slots overwritten under it.
+// Nothing is formatted for the UI until the panel draws the line.
 class UILogBuffer {
 public:
+    static constexpr size_t Capacity = 128;
+
     static UILogBuffer& Get() {
         static UILogBuffer instance;
         return instance;
     }
 
+    // Separate instances are for tests; the app logs through Get()
+    UILogBuffer() = default;
+    UILogBuffer(const UILogBuffer&) = delete;
+    UILogBuffer& operator=(const UILogBuffer&) = delete;
+
     template<typename... Args>
     void Add(Level level, std::format_string<Args...> fmt, Args&&... args) {
-        std::string msg = std::format(fmt, std::forward<Args>(args)...);
-        
-        // Route to spdlog
-        switch (level) {
-            case Level::Debug: spdlog::debug(msg); break;
-            case Level::Info:  spdlog::info(msg);  break;
-            case Level::Warn:  spdlog::warn(msg);  break;
-            case Level::Error: spdlog::error(msg); break;
+        // Route to spdlog, formatting only when the level is enabled there (info and
+        // above by default, so those lines are still formatted here; only the UI
+        // copy is deferred)
+        spdlog::level::level_enum spdLevel = ToSpdlog(level);
+        if (spdlog::should_log(spdLevel)) {
+            spdlog::log(spdLevel, "{}", std::vformat(fmt.get(), std::make_format_args(args...)));
         }
-        
-        // Buffer for UI display
-        std::lock_guard<std::mutex> lock(m_mutex);
-        
-        // Add prefix for UI log
-        std::string prefix;
-        switch (level) {
-            case Level::Warn:  prefix = "[WARN] "; break;
-            case Level::Error: prefix = "[ERROR] "; break;
-            default: break;
+
+        static_assert(Core::LogArgs::kFixedBytes<Args...> <= Record::kArgBytes,
+                      "Too many UI log arguments");
+
+        const uint64_t n = m_head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[n % Capacity];
+
+        // Claim the slot. A slot still written by an older line (writer n - Capacity
+        // stalled) or already taken by a newer one is skipped: this line is dropped
+        // rather than mixed with the other write.
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        if ((seq & 1) || seq > 2 * n ||
+            !slot.seq.compare_exchange_strong(seq, 2 * n + 1, std::memory_order_relaxed)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
         }
-        
-        m_items.push_back(prefix + msg);
-        if (m_items.size() > MaxItems) {
-            m_items.pop_front();
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Record& record = slot.record;
+        record.level = level;
+        record.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.fmt = fmt.get().data();
+        record.fmtSize = (uint32_t)fmt.get().size();
+        record.format = &Core::LogArgs::FormatTo<Args...>;
+        Core::LogArgs::Writer out(record.args, Record::kArgBytes, Core::LogArgs::kFixedBytes<Args...>);
+        (out.Put(args), ...);
+        record.argBytes = (uint16_t)out.Size();
+
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+    }
+
+    // Copy the buffered records, oldest first, into out (reuses its storage)
+    void Collect(std::vector<Record>& out) const {
+        out.clear();
+        const uint64_t head = m_head.load(std::memory_order_acquire);
+        const uint64_t begin = std::max(head > Capacity ? head - Capacity : 0,
+                                        m_cleared.load(std::memory_order_relaxed));
+        for (uint64_t n = begin; n < head; n++) {
+            const Slot& slot = m_slots[n % Capacity];
+            if (slot.seq.load(std::memory_order_acquire) != 2 * n + 2) continue;  // In flight or overwritten
+            out.push_back(slot.record);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != 2 * n + 2) out.pop_back();
         }
     }
 
-    // Get a copy of the log items for rendering
-    std::deque<std::string> GetItems() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_items;
+    // Format a record as the panel shows it (level prefix + message), appending to out
+    static void Format(const Record& record, std::string& out) {
+        switch (record.level) {
+            case Level::Warn:  out += "[WARN] "; break;
+            case Level::Error: out += "[ERROR] "; break;
+            default: break;
+        }
+        record.format(record.args, record.Format(), out);
     }
-    
+
+    // Lines lost to a slot another writer still held
+    uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
     // Clear all items
     void Clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_items.clear();
+        m_cleared.store(m_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
     }
 
 private:
-    UILogBuffer() = default;
-    
-    static constexpr size_t MaxItems = 100;
-    std::deque<std::string> m_items;
-    mutable std::mutex m_mutex;
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        Record record;
+    };
+
+    static spdlog::level::level_enum ToSpdlog(Level level) {
+        switch (level) {
+            case Level::Debug: return spdlog::level::debug;
+            case Level::Warn:  return spdlog::level::warn;
+            case Level::Error: return spdlog::level::err;
+            default:           return spdlog::level::info;
+        }
+    }
+
+    std::array<Slot, Capacity> m_slots;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_cleared{0};
+    std::atomic<uint64_t> m_dropped{0};
 };
 
 // Convenience logging functions
@@ -1,6 +1,8 @@
 #pragma once
 #include "IIOProvider.h"
+#include <atomic>
 #include <map>
+#include <thread>
 
 // Constants for EC simulation (matching ECManager)
 #define ACPI_EC_COMMAND_READ 0x80
@@ -13,6 +15,10 @@
 class MockIOProvider : public IIOProvider {
 public:
     virtual BYTE ReadPort(USHORT port) override {
+        if ((port == ACPI_EC_TYPE1_CTRLPORT || port == ACPI_EC_TYPE2_CTRLPORT) &&
+            m_stalledThread.load() == std::this_thread::get_id()) {
+            return kStatusIBF;
+        }
         if ((port == ACPI_EC_TYPE1_DATAPORT || port == ACPI_EC_TYPE2_DATAPORT) && m_ecReadPending) {
             m_ecReadPending = false;
             return m_ecMemory[m_ecAddress];
@@ -58,10 +64,20 @@ public:
         m_ecMemory[addr] = value;
     }
 
+    BYTE GetECByte(BYTE addr) const {
+        auto it = m_ecMemory.find(addr);
+        return it != m_ecMemory.end() ? it->second : 0;
+    }
+
+    // The EC stays busy (IBF set) for one thread, like a transaction that never completes
+    void StallThread(std::thread::id id) { m_stalledThread.store(id); }
+
     USHORT GetLastWritePort() const { return m_lastWritePort; }
     BYTE GetLastWriteValue() const { return m_lastWriteValue; }
 
 private:
+    static constexpr BYTE kStatusIBF = 0x02;  // Input buffer full: EC busy
+
     std::map<USHORT, BYTE> m_ports;
     std::map<BYTE, BYTE> m_ecMemory;
     USHORT m_lastWritePort = 0;
@@ -69,4 +85,5 @@ private:
     int m_ecState = 0;
     BYTE m_ecAddress = 0;
     bool m_ecReadPending = false;
+    std::atomic<std::thread::id> m_stalledThread{};
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+// Platform.h - Platform layer for the EC, sensor and fan stack
+// Windows gets <windows.h>; other platforms get the few Win32 types and
+// calls that ECManager, SensorManager and FanController rely on.
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+typedef uint8_t BYTE;
+typedef uint16_t USHORT;
+#endif
+
+namespace Platform {
+
+// Block the calling thread (::Sleep on Windows)
+inline void SleepMs(unsigned ms) {
+#ifdef _WIN32
+    ::Sleep(ms);
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+#endif
+}
+
+} // namespace Platform
@@ -0,0 +1,128 @@
+#include "_prec.h"
+#include "ThermalConfigBuilder.h"
+#include <algorithm>
+
+namespace App {
+
+/// Build ThermalConfig from the legacy ConfigManager
+/// This is a bridge function for the migration period
+Core::ThermalConfig BuildThermalConfig(const std::shared_ptr<ConfigManager>& config) {
+    Core::ThermalConfig thermal;
+    
+    // Basic settings
+    thermal.cycleSeconds = config->Cycle;
+    thermal.cycle.periodMs = config->CycleMs;
+    thermal.cycle.adaptive = config->AdaptiveCycle != 0;
+    thermal.cycle.minPeriodMs = config->AdaptiveMinMs;
+    thermal.cycle.maxPeriodMs = config->AdaptiveMaxMs;
+    thermal.cycle.riseRate = config->AdaptiveRiseRate;
+    thermal.iconCycleSeconds = config->IconCycle;
+    thermal.watchdog.enabled = config->Watchdog != 0;
+    thermal.watchdog.stallMs = config->WatchdogStallMs;
+    thermal.isDualFan = config->DualFan != 0;
+    thermal.fanSpeedAddr = config->FanSpeedLowByte;
+    thermal.useBiasedTemps = config->ShowBiasedTemps != 0;
+    thermal.noExtSensor = config->NoExtSensor != 0;
+    thermal.useFahrenheit = config->Fahrenheit != 0;
+    thermal.manualFanSpeed = config->ManFanSpeed;
+    thermal.manModeExitTemp = config->ManModeExit;
+    thermal.ignoreList = config->IgnoreSensors;
+    
+    // PID settings
+    thermal.pid.Kp = config->PID_Kp;
+    thermal.pid.Ki = config->PID_Ki;
+    thermal.pid.Kd = config->PID_Kd;
+    thermal.pid.targetTemp = config->PID_Target;
+    thermal.pid.minFan = 0;
+    thermal.pid.maxFan = 7;
+    thermal.pid.dither = config->PID_Dither != 0;
+    thermal.pid.ditherMinDwell = config->PID_DitherDwell;
+    thermal.pid.ditherMaxWritesPerMin = config->PID_DitherMaxWrites;
+    
+    // Model-predictive control
+    thermal.mpc.targetTemp = config->MPC_Target;
+    thermal.mpc.horizonSeconds = config->MPC_Horizon;
+    thermal.mpc.writeCost = config->MPC_WriteCost;
+    thermal.mpc.overTempCost = config->MPC_OverTempCost;
+    
+    // RPM target mode
+    thermal.rpm.targetRpm = config->TargetRpm;
+    thermal.rpm.loopMs = config->RpmLoopMs;
+    thermal.rpm.toleranceRpm = config->RpmTolerance;
+    thermal.rpm.dither = config->RpmDither != 0;
+    
+    // Ramp scheduler
+    thermal.ramp.enabled = config->Ramp != 0;
+    thermal.ramp.upRate = config->RampUpRate;
+    thermal.ramp.downRate = config->RampDownRate;
+    thermal.ramp.minDwell = config->RampMinDwell;
+    thermal.ramp.reversalWindow = config->RampReversalWindow;
+    thermal.ramp.criticalTemp = config->RampCriticalTemp;
+    
+    // Per-fan control zones share the global PID tuning
+    thermal.fanZonesEnabled = config->FanZones != 0;
+    thermal.fanZones[0].sensorIndices = config->Fan1Sensors;
+    thermal.fanZones[0].smartProfile = config->Fan1Profile;
+    thermal.fanZones[0].usePID = config->Fan1UsePID != 0;
+    thermal.fanZones[0].pid = thermal.pid;
+    thermal.fanZones[1].sensorIndices = config->Fan2Sensors;
+    thermal.fanZones[1].smartProfile = config->Fan2Profile;
+    thermal.fanZones[1].usePID = config->Fan2UsePID != 0;
+    thermal.fanZones[1].pid = thermal.pid;
+    
+    // Sensor configuration - use defaults and apply names/weights from config
+    thermal.sensors = Core::CreateDefaultSensorConfig();
+    
+    const char* defaultNames[] = {
+        "CPU", "APS", "PCM", "GPU", "BAT1", "X7D", 
+        "BAT2", "X7F", "BUS", "PCI", "PWR", "XC3"
+    };
+
+    for (size_t i = 0; i < thermal.sensors.size(); i++) {
+        // Use name from config if provided, otherwise use default ThinkPad name
+        if (i < config->SensorNames.size() && !config->SensorNames[i].empty()) {
+            thermal.sensors[i].name = config->SensorNames[i];
+        } else if (i < 12) {
+            thermal.sensors[i].name = defaultNames[i];
+        }
+    }
+
+    for (size_t i = 0; i < config->SensorWeights.size() && i < thermal.sensors.size(); i++) {
+        thermal.sensors[i].weight = config->SensorWeights[i];
+    }
+    
+    // Smart profiles - convert SmartLevels1/2 to SmartLevelDefinition
+    for (const auto& sl : config->SmartLevels1) {
+        if (sl.temp >= 0) {
+            thermal.smartProfiles[0].emplace_back(sl.temp, sl.fan, sl.hystUp, sl.hystDown);
+        }
+    }
+    for (const auto& sl : config->SmartLevels2) {
+        if (sl.temp >= 0) {
+            thermal.smartProfiles[1].emplace_back(sl.temp, sl.fan, sl.hystUp, sl.hystDown);
+        }
+    }
+    
+    // Icon levels
+    if (config->IconLevels.size() >= 3) {
+        thermal.iconLevels.thresholds = { 
+            config->IconLevels[0], 
+            config->IconLevels[1], 
+            config->IconLevels[2] 
+        };
+    }
+    
+    return thermal;
+}
+
+Core::TelemetryConfig BuildTelemetryConfig(const std::shared_ptr<ConfigManager>& config, const std::string& path) {
+    Core::TelemetryConfig telemetry;
+    telemetry.path = path;
+    telemetry.format = config->TelemetryBinary ? Core::TelemetryFormat::Binary : Core::TelemetryFormat::Csv;
+    telemetry.maxFileBytes = (uint64_t)std::max(config->TelemetryMaxFileMB, 0) << 20;
+    telemetry.rotateIntervalSec = std::max(config->TelemetryRotateHours, 0) * 3600;
+    telemetry.keepSegments = config->TelemetrySegments;
+    return telemetry;
+}
+
+} // namespace App
@@ -0,0 +1,19 @@
+#pragma once
+
+// ThermalConfigBuilder.h - Bridge from the legacy ConfigManager to Core::ThermalConfig
+// Shared by the GUI and the headless daemon; no Windows dependencies.
+
+#include <memory>
+#include "ConfigManager.h"
+#include "Core/SensorConfig.h"
+#include "Core/TelemetryWriter.h"
+
+namespace App {
+
+// Helper to convert ConfigManager to ThermalConfig
+Core::ThermalConfig BuildThermalConfig(const std::shared_ptr<ConfigManager>& config);
+
+// Telemetry writer settings (Log2csv / "Telemetry") for the given file
+Core::TelemetryConfig BuildTelemetryConfig(const std::shared_ptr<ConfigManager>& config, const std::string& path);
+
+} // namespace App
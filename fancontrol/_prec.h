@@ -1,9 +1,14 @@
 //systemheaders in one file for using precompiled headers.
 
+#ifdef _WIN32
 // be compatible downto Windows Server 2003 SP1
 #define _WIN32_WINNT 0x0502
 //only most neccessary things from windows
 #define WIN32_LEAN_AND_MEAN
+// std::min/std::max must not collide with the windows.h macros
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 #include <windows.h>
 
 #include <process.h>
@@ -11,6 +16,7 @@
 #include <commdlg.h>
 #include <shellapi.h>
 #include <tchar.h>
+#endif
 
 #include <stdlib.h>
 #include <string.h>
@@ -18,5 +24,7 @@
 #include <format>
 #include <stop_token>
 #include <spdlog/spdlog.h>
+#ifdef _WIN32
 #include "winuser.h"
 #include "windows.h"
+#endif
@@ -0,0 +1,22 @@
+#include "LinuxPortIOProvider.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+LinuxPortIOProvider::LinuxPortIOProvider() {
+    m_fd = ::open("/dev/port", O_RDWR | O_CLOEXEC);
+}
+
+LinuxPortIOProvider::~LinuxPortIOProvider() {
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+BYTE LinuxPortIOProvider::ReadPort(USHORT port) {
+    BYTE value = 0xFF;  // Floating bus: reads as a busy EC, so the access times out
+    if (m_fd >= 0 && ::pread(m_fd, &value, 1, port) != 1) value = 0xFF;
+    return value;
+}
+
+void LinuxPortIOProvider::WritePort(USHORT port, BYTE value) {
+    if (m_fd >= 0) (void)::pwrite(m_fd, &value, 1, port);
+}
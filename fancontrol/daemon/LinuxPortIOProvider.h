@@ -0,0 +1,18 @@
+#pragma once
+#include "IIOProvider.h"
+
+// Port I/O through /dev/port (needs root or CAP_SYS_RAWIO).
+// Linux counterpart of TVicPortProvider for the headless daemon.
+class LinuxPortIOProvider : public IIOProvider {
+public:
+    LinuxPortIOProvider();
+    virtual ~LinuxPortIOProvider();
+
+    bool IsOpen() const { return m_fd >= 0; }
+
+    virtual BYTE ReadPort(USHORT port) override;
+    virtual void WritePort(USHORT port, BYTE value) override;
+
+private:
+    int m_fd;
+};
@@ -0,0 +1,171 @@
+// fancontrold.cpp - Headless fan control daemon for Linux
+// Runs the Core ThermalManager on /dev/port without any UI. SIGINT/SIGTERM hand
+// the fan back to the BIOS and exit, SIGHUP reloads the config file.
+
+#include "ConfigManager.h"
+#include "ECManager.h"
+#include "ThermalConfigBuilder.h"
+#include "Core/ThermalManager.h"
+#include "LinuxPortIOProvider.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <spdlog/spdlog.h>
+
+namespace {
+
+void PrintUsage(const char* argv0) {
+    std::printf("Usage: %s [-c config.json] [-m bios|smart|manual|pid|mpc|rpm] [-v] [-b log.bin]\n"
+                "       %s -d log.bin   (print a binary log and exit)\n", argv0, argv0);
+}
+
+const char* LevelName(Core::LogLevel level) {
+    switch (level) {
+        case Core::LogLevel::Debug: return "debug";
+        case Core::LogLevel::Info: return "info";
+        case Core::LogLevel::Warning: return "warning";
+        default: return "error";
+    }
+}
+
+int DecodeBinaryLog(const std::string& path) {
+    bool ok = Core::BinaryLog::Decode(path, [](Core::LogLevel level, int64_t unixNs, std::string_view message) {
+        std::time_t seconds = (std::time_t)(unixNs / 1000000000);
+        std::tm tm{};
+        localtime_r(&seconds, &tm);
+        char stamp[32];
+        std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+        std::printf("[%s.%03d] [%s] %.*s\n", stamp, (int)(unixNs / 1000000 % 1000), LevelName(level),
+                    (int)message.size(), message.data());
+    });
+    if (!ok) {
+        std::fprintf(stderr, "%s is not a readable binary log\n", path.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+bool ParseMode(const std::string& name, Core::ControlMode& mode) {
+    if (name == "bios") mode = Core::ControlMode::BIOS;
+    else if (name == "smart") mode = Core::ControlMode::Smart;
+    else if (name == "manual") mode = Core::ControlMode::Manual;
+    else if (name == "pid") mode = Core::ControlMode::PID;
+    else if (name == "mpc") mode = Core::ControlMode::MPC;
+    else if (name == "rpm") mode = Core::ControlMode::RPM;
+    else return false;
+    return true;
+}
+
+/// Same mapping as the GUI: ActiveMode 0=BIOS, 1=Manual, 2=Smart refined by ControlAlgorithm
+Core::ControlMode ModeFromConfig(const ConfigManager& config) {
+    switch (config.ActiveMode) {
+        case 0: return Core::ControlMode::BIOS;
+        case 1: return Core::ControlMode::Manual;
+        default: break;
+    }
+    switch (config.ControlAlgorithm) {
+        case 1: return Core::ControlMode::PID;
+        case 2: return Core::ControlMode::MPC;
+        default: return Core::ControlMode::Smart;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string configPath = "TPFanCtrl2.json";
+    std::string modeName;
+    std::string binaryLogPath;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "-c") && i + 1 < argc) {
+            configPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "-m") && i + 1 < argc) {
+            modeName = argv[++i];
+        } else if (!std::strcmp(argv[i], "-v")) {
+            verbose = true;
+        } else if (!std::strcmp(argv[i], "-b") && i + 1 < argc) {
+            binaryLogPath = argv[++i];
+        } else if (!std::strcmp(argv[i], "-d") && i + 1 < argc) {
+            return DecodeBinaryLog(argv[i + 1]);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+    spdlog::set_level(verbose ? spdlog::level::debug : spdlog::level::info);
+
+    auto config = std::make_shared<ConfigManager>();
+    if (!config->LoadConfig(configPath)) {
+        spdlog::warn("Failed to load {}, using defaults.", configPath);
+    }
+
+    Core::ControlMode mode = ModeFromConfig(*config);
+    if (!modeName.empty() && !ParseMode(modeName, mode)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+
+    auto ioProvider = std::make_shared<LinuxPortIOProvider>();
+    if (!ioProvider->IsOpen()) {
+        spdlog::error("CRITICAL: Could not open /dev/port ({}). Run as root.", std::strerror(errno));
+        return 1;
+    }
+    auto ecManager = std::make_shared<ECManager>(ioProvider, [](const char* msg) {
+        spdlog::debug("[EC] {}", msg);
+    });
+
+    // Block the control signals before any thread starts so that only sigwait() sees them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    auto thermalManager = std::make_shared<Core::ThermalManager>(ecManager, App::BuildThermalConfig(config));
+    thermalManager->Subscribe<Core::LogEvent>([](const Core::LogEvent& e) {
+        switch (e.level) {
+            case Core::LogLevel::Debug: spdlog::debug("{}", e.message); break;
+            case Core::LogLevel::Info: spdlog::info("{}", e.message); break;
+            case Core::LogLevel::Warning: spdlog::warn("{}", e.message); break;
+            case Core::LogLevel::Error: spdlog::error("{}", e.message); break;
+        }
+    });
+    if (!binaryLogPath.empty() && !thermalManager->SetBinaryLogFile(binaryLogPath)) {
+        spdlog::warn("Could not open binary log {}", binaryLogPath);
+    }
+    thermalManager->Subscribe<Core::ErrorEvent>([](const Core::ErrorEvent& e) {
+        spdlog::error("[{}] {}", e.source, e.message);
+    });
+
+    thermalManager->SetManualLevel(config->ManFanSpeed);
+    thermalManager->SetTargetRpm(config->TargetRpm);
+    thermalManager->SetMode(mode);
+    thermalManager->Start();
+    spdlog::info("fancontrold running with {}", configPath);
+
+    for (;;) {
+        int sig = 0;
+        if (sigwait(&signals, &sig) != 0) continue;
+        if (sig != SIGHUP) {
+            spdlog::info("Received {}, returning fan control to BIOS", strsignal(sig));
+            break;
+        }
+        if (config->LoadConfig(configPath)) {
+            thermalManager->UpdateConfig(App::BuildThermalConfig(config));
+            spdlog::info("Reloaded {}", configPath);
+        } else {
+            spdlog::warn("Failed to reload {}, keeping the current config", configPath);
+        }
+    }
+
+    // Stop() restores BIOS control (0x80) before the worker exits
+    thermalManager->Stop();
+    return 0;
+}
@@ -29,6 +29,7 @@
 #include "SensorManager.h"
 #include "FanController.h"
 #include "ConfigManager.h"
+#include "Core/TelemetryWriter.h"
 #include <memory>
 #include <vector>
 #include <string>
@@ -144,6 +145,7 @@ protected:
 	std::shared_ptr<SensorManager> m_sensorManager;
 	std::shared_ptr<FanController> m_fanController;
 	std::shared_ptr<ConfigManager> m_configManager;
+	std::unique_ptr<Core::TelemetryWriter> m_csvWriter;	// Created on the first csv line
 
 	static int _stdcall
 		FANCONTROL_Thread(ULONG
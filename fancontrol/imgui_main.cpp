@@ -11,6 +11,8 @@
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_win32.h>
 #include <dwmapi.h>
+#include <array>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <deque>
@@ -54,6 +56,7 @@
 #include "ImGuiRenderer.h"
 
 #include "Application.h"
+#include "Core/PlotDecimator.h"
 
 // --- Tray Constants ---
 #define WM_TRAYICON (WM_USER + 100)
@@ -136,7 +139,7 @@ void UpdateTrayIcon(HWND hWnd, int temp, int fan) {
 }
 
 // --- Custom Lightweight Plot ---
-void DrawSimplePlot(const char* label, const std::map<std::string, std::deque<float>>& history, float height, float dpiScale) {
+void DrawSimplePlot(const char* label, const Core::HistoryStore& history, const std::vector<SensorData>& sensors, float height, float dpiScale) {
     ImVec2 canvas_p0 = ImGui::GetCursorScreenPos();      // Upper-left
     ImVec2 canvas_sz = ImGui::GetContentRegionAvail();   // Size of available space
     if (canvas_sz.x < 50.0f) canvas_sz.x = 50.0f;
@@ -167,25 +170,76 @@ void DrawSimplePlot(const char* label, const std::map<std::string, std::deque<fl
         IM_COL32(173, 216, 230, 255)  // LightBlue
     };
 
+    // Per sensor slot: decimated columns and the ignore flag, both kept until their input changes
+    struct PlotSeries {
+        Core::PlotDecimator decimator;
+        std::string name;
+        bool ignored = false;
+    };
+    static std::array<PlotSeries, Core::HistoryStore::kSensors> s_series;
+    static std::string s_ignoreSensors;
+    static std::vector<ImVec2> s_points;
+
+    bool ignoreChanged = false;
+    if (g_App && g_App->GetConfig()->IgnoreSensors != s_ignoreSensors) {
+        s_ignoreSensors = g_App->GetConfig()->IgnoreSensors;
+        ignoreChanged = true;
+    }
+
+    // Last 5 minutes of the 1 s tier, right edge = now
+    constexpr int kPlotSeconds = 300;
+    float stepX = canvas_sz.x / (float)kPlotSeconds;
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto reader = history.Read();
     float legendX = canvas_p0.x + 40 * dpiScale;
-    for (auto const& [name, data] : history) {
+    int count = (std::min)((int)sensors.size(), Core::HistoryStore::kSensors);
+    for (int index = 0; index < count; index++) {
+        const std::string& name = sensors[index].name;
+        if (!sensors[index].isAvailable || name.empty()) continue;
+
         // Skip ignored sensors in plot
-        if (g_App && g_App->GetConfig()->IgnoreSensors.find(name) != std::string::npos) continue;
+        PlotSeries& series = s_series[index];
+        if (ignoreChanged || series.name != name) {
+            series.name = name;
+            series.ignored = s_ignoreSensors.find(name) != std::string::npos;
+        }
+        if (series.ignored) continue;
 
+        auto data = reader.Series(Core::HistoryTier::Seconds, index);
         if (data.size() < 2) continue;
+        if (data.size() > kPlotSeconds) data = data.last(kPlotSeconds);
+
+        int64_t newest = reader.NewestTime(Core::HistoryTier::Seconds, index);
+        auto columns = series.decimator.Update(data, newest, (int)(data.size() * stepX));
 
+        // Seconds between the newest sample and now
+        float lag = (float)(nowMs - newest) / 1000.0f;
+        float spanX = data.size() * stepX;
+        float startX = canvas_p1.x - (lag + data.size()) * stepX;
+        float columnX = spanX / (float)columns.size();
+
+        // One polyline per run of columns, broken at gaps; each column adds its max and min
         ImU32 color = colors[colorIdx % 5];
-        float stepX = canvas_sz.x / 300.0f; 
-        
-        for (size_t i = 0; i < data.size() - 1; i++) {
-            ImVec2 p1 = ImVec2(canvas_p1.x - (data.size() - i) * stepX, 
-                               canvas_p1.y - (data[i] / 100.0f) * canvas_sz.y);
-            ImVec2 p2 = ImVec2(canvas_p1.x - (data.size() - (i + 1)) * stepX, 
-                               canvas_p1.y - (data[i+1] / 100.0f) * canvas_sz.y);
-            
-            if (p1.x < canvas_p0.x) continue;
-            draw_list->AddLine(p1, p2, color, 2.0f * dpiScale);
+        auto flush = [&]() {
+            if (s_points.size() >= 2) {
+                draw_list->AddPolyline(s_points.data(), (int)s_points.size(), color, ImDrawFlags_None, 2.0f * dpiScale);
+            }
+            s_points.clear();
+        };
+        for (size_t c = 0; c < columns.size(); c++) {
+            float x = startX + (c + 0.5f) * columnX;
+            if (std::isnan(columns[c].max) || x < canvas_p0.x) {
+                flush();
+                continue;
+            }
+            s_points.push_back(ImVec2(x, canvas_p1.y - (columns[c].max / 100.0f) * canvas_sz.y));
+            if (columns[c].min != columns[c].max) {
+                s_points.push_back(ImVec2(x, canvas_p1.y - (columns[c].min / 100.0f) * canvas_sz.y));
+            }
         }
+        flush();
         
         // Draw Legend in the plot area
         draw_list->AddText(ImVec2(legendX, canvas_p0.y + 5 * dpiScale), color, name.c_str());
@@ -252,9 +306,9 @@ struct AppLog {
         Log::Info(fmt, std::forward<Args>(args)...);
     }
     
-    // Get items from the unified buffer
-    std::deque<std::string> GetItems() const {
-        return Log::UILogBuffer::Get().GetItems();
+    // Copy the unified buffer's records (unformatted) into out
+    void Collect(std::vector<Log::Record>& out) const {
+        Log::UILogBuffer::Get().Collect(out);
     }
 } g_AppLog;
 
@@ -667,7 +721,9 @@ int main(int argc, char** argv) {
                     ImGui::Separator();
                     ImGui::Spacing();
                     {
-                        DrawSimplePlot("TempPlot", uiSnapshot.TempHistory, 0, dpiScale);
+                        if (g_App && g_App->GetUIAdapter()) {
+                            DrawSimplePlot("TempPlot", g_App->GetUIAdapter()->GetHistory(), uiSnapshot.Sensors, 0, dpiScale);
+                        }
                     }
                     ImGui::EndChild();
 
@@ -704,17 +760,29 @@ int main(int argc, char** argv) {
 
                         ImGui::Spacing();
                         if (uiSnapshot.Mode == 1) {
-                            ImGui::Text(_TR("LBL_MANUAL_LEVEL"));
-                            int manualLevel = uiSnapshot.ManualLevel;
-                            if (ImGui::SliderInt("##Level", &manualLevel, 0, 7)) {
-                                if (g_App && g_App->GetUIAdapter()) g_App->GetUIAdapter()->SetManualLevel(manualLevel);
+                            bool useRpm = uiSnapshot.UseTargetRpm;
+                            if (ImGui::Checkbox(_TR("OPT_TARGET_RPM"), &useRpm)) {
+                                if (g_App && g_App->GetUIAdapter()) g_App->GetUIAdapter()->SetUseTargetRpm(useRpm);
+                            }
+                            if (useRpm) {
+                                ImGui::Text(_TR("LBL_TARGET_RPM"));
+                                int targetRpm = uiSnapshot.TargetRpm;
+                                if (ImGui::SliderInt("##Rpm", &targetRpm, 0, 6000, "%d RPM")) {
+                                    if (g_App && g_App->GetUIAdapter()) g_App->GetUIAdapter()->SetTargetRpm(targetRpm);
+                                }
+                            } else {
+                                ImGui::Text(_TR("LBL_MANUAL_LEVEL"));
+                                int manualLevel = uiSnapshot.ManualLevel;
+                                if (ImGui::SliderInt("##Level", &manualLevel, 0, 7)) {
+                                    if (g_App && g_App->GetUIAdapter()) g_App->GetUIAdapter()->SetManualLevel(manualLevel);
+                                }
                             }
                         } else if (uiSnapshot.Mode == 2) {
                             ImGui::Text(_TR("LBL_ALGORITHM"));
-                            const char* algoNames[] = { _TR("ALGO_STEP"), _TR("ALGO_PID") };
+                            const char* algoNames[] = { _TR("ALGO_STEP"), _TR("ALGO_PID"), _TR("ALGO_MPC") };
                             int algoIdx = uiSnapshot.Algorithm;
                             ImGui::PushItemWidth(-1);
-                            if (ImGui::Combo("##Algo", &algoIdx, algoNames, 2)) {
+                            if (ImGui::Combo("##Algo", &algoIdx, algoNames, 3)) {
                                 if (g_App && g_App->GetUIAdapter()) g_App->GetUIAdapter()->SetAlgorithm(algoIdx);
                             }
                             ImGui::PopItemWidth();
@@ -752,15 +820,9 @@ int main(int argc, char** argv) {
                     ImGui::TextColored(Theme::Primary(), "%s %s", ICON_LOG, _TR("SECTION_LOGS"));
                     ImGui::Separator();
                     {
-                        auto logItems = g_AppLog.GetItems();  // Thread-safe copy
-                        ImGui::BeginChild("LogScroll");
-                        for (const auto& line : logItems) {
-                            if (line.find("[ERROR]") != std::string::npos) ImGui::TextColored(Theme::TempHot(), "%s", line.c_str());
-                            else if (line.find("[WARN]") != std::string::npos) ImGui::TextColored(Theme::TempWarm(), "%s", line.c_str());
-                            else ImGui::TextUnformatted(line.c_str());
-                        }
-                        if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) ImGui::SetScrollHereY(1.0f);
-                        ImGui::EndChild();
+                        static std::vector<Log::Record> logRecords;
+                        g_AppLog.Collect(logRecords);  // Lock-free copy, formatted per visible row
+                        ImGuiUI::DrawLogPanel(logRecords);
                     }
                     ImGui::EndChild();
 
@@ -803,6 +865,7 @@ int main(int argc, char** argv) {
                         auto config = g_App->GetConfig();
                         config->ActiveMode = uiSnapshot.Mode;
                         config->ManFanSpeed = uiSnapshot.ManualLevel;
+                        config->TargetRpm = uiSnapshot.TargetRpm;
                         config->ControlAlgorithm = uiSnapshot.Algorithm;
                         config->PID_Target = uiSnapshot.PID.targetTemp;
                         config->PID_Kp = uiSnapshot.PID.Kp;
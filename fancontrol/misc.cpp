@@ -18,6 +18,7 @@
 #include "_prec.h"
 #include "tools.h"
 #include "fancontrol.h"
+#include "ThermalConfigBuilder.h"
 
 
 //-------------------------------------------------------------------------
@@ -172,12 +173,13 @@ FANCONTROL::TracecsvInternal(const char* text, bool includeDate, const char* sep
 		line = "\r\n";
 	}
 
-	FILE* flogcsv;
-	errno_t err = fopen_s(&flogcsv, "TPFanCtrl2_csv.txt", "ab");
-	if (!err && flogcsv) {
-		fwrite(line.c_str(), line.length(), 1, flogcsv);
-		fclose(flogcsv);
+	// Queued; the writer thread batches, writes and rotates the file
+	if (!m_csvWriter) {
+		Core::TelemetryConfig csv = App::BuildTelemetryConfig(m_configManager, "TPFanCtrl2_csv.txt");
+		csv.format = Core::TelemetryFormat::Csv;	// Lines are preformatted text
+		m_csvWriter = std::make_unique<Core::TelemetryWriter>(std::move(csv));
 	}
+	m_csvWriter->PushLine(std::move(line));
 }
 
 void
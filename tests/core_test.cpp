@@ -4,15 +4,42 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
+#include <deque>
+#include <cmath>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 #include "Core/ThermalManager.h"
 #include "Core/UIAdapter.h"
 #include "Core/Events.h"
 #include "Core/SensorConfig.h"
+#include "Core/FanDither.h"
+#include "Core/FanZone.h"
+#include "Core/SmartLevelTable.h"
+#include "Core/FanRamp.h"
+#include "Core/RelayAutotuner.h"
+#include "Core/ThermalModel.h"
+#include "Core/FanMPC.h"
+#include "Core/FanRpmController.h"
+#include "Core/AdaptiveCycle.h"
+#include "Core/ConfigDiff.h"
+#include "Core/CycleProfiler.h"
+#include "Core/CycleWatchdog.h"
+#include "Core/HistoryStore.h"
+#include "Core/PlotDecimator.h"
+#include "Core/TelemetryWriter.h"
+#include "Core/BinaryLog.h"
 #include "ECManager.h"
 #include "MockIOProvider.h"
 #include "ConfigManager.h"
+#include "LogManager.h"
 
 using namespace Core;
 
@@ -112,6 +139,291 @@ TEST_F(ThermalManagerTest, GetStateSnapshot) {
     EXPECT_TRUE(state.isOperational);
 }
 
+TEST_F(ThermalManagerTest, PublishesVersionedSnapshots) {
+    CreateManager();
+    
+    // A snapshot exists before the first cycle
+    auto initial = thermalManager->GetStateSnapshot();
+    ASSERT_NE(initial, nullptr);
+    EXPECT_EQ(initial->version, thermalManager->GetStateVersion());
+    EXPECT_FALSE(initial->isOperational);
+    
+    // Unchanged version: the very same object, no copy
+    EXPECT_EQ(thermalManager->GetStateSnapshot(), initial);
+    
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    thermalManager->ForceUpdate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    thermalManager->Stop();
+    
+    auto latest = thermalManager->GetStateSnapshot();
+    EXPECT_GE(latest->version, initial->version + 2);
+    EXPECT_EQ(latest->version, thermalManager->GetStateVersion());
+    EXPECT_TRUE(latest->isOperational);
+    
+    // Readers holding an old snapshot keep seeing it unchanged
+    EXPECT_FALSE(initial->isOperational);
+}
+
+TEST_F(ThermalManagerTest, TemperatureEventsShareReadings) {
+    CreateManager();
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::shared_ptr<const std::vector<SensorReading>>> payloads;
+    thermalManager->Subscribe([&](const ThermalEvent& e) {
+        if (auto* update = std::get_if<TemperatureUpdateEvent>(&e)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            payloads.push_back(update->sensors);
+            cv.notify_all();
+        }
+    });
+    
+    thermalManager->Start();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return payloads.size() >= 1; }));
+    }
+    thermalManager->ForceUpdate();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return payloads.size() >= 2; }));
+    }
+    thermalManager->Stop();
+    
+    // A retained payload is never refilled under the subscriber's feet
+    ASSERT_NE(payloads[0], nullptr);
+    EXPECT_NE(payloads[0], payloads[1]);
+    EXPECT_EQ((*payloads[0])[0].name, "CPU");
+    EXPECT_EQ((*payloads[0])[0].rawTemp, 45);
+}
+
+TEST_F(ThermalManagerTest, ConfigVersionAppliedOnNextCycle) {
+    config.cycleSeconds = 10;
+    CreateManager();
+    EXPECT_EQ(thermalManager->GetConfigVersion(), 1u);
+    
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    ThermalConfig renamed = config;
+    renamed.sensors[0].name = "Package";
+    thermalManager->UpdateConfig(renamed);
+    EXPECT_EQ(thermalManager->GetConfigVersion(), 2u);
+    
+    // The config wakeup runs a cycle with the new version
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ThermalState state = thermalManager->GetState();
+    thermalManager->Stop();
+    
+    EXPECT_EQ(state.configVersion, 2u);
+    EXPECT_EQ(state.sensors[0].name, "Package");
+    EXPECT_EQ(state.sensors[1].name, "GPU");
+}
+
+TEST_F(ThermalManagerTest, WatchdogHandsFanToBiosOnStall) {
+    config.cycle.periodMs = 100;
+    config.watchdog.stallMs = 1000;  // Fan writes verify with sleeps; leave room for a healthy cycle
+    CreateManager();
+    thermalManager->SetManualLevel(0);
+    thermalManager->SetMode(ControlMode::Manual);
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    int critical = 0;
+    std::thread::id worker;
+    thermalManager->Subscribe<ErrorEvent>([&](const ErrorEvent& e) {
+        if (e.severity != ErrorSeverity::Critical) return;
+        std::lock_guard<std::mutex> lock(mutex);
+        critical++;
+        cv.notify_all();
+    });
+    thermalManager->Subscribe<TemperatureUpdateEvent>([&](const TemperatureUpdateEvent&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        worker = std::this_thread::get_id();
+    });
+    
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(thermalManager->GetState().fanState.currentLevel, 0);
+    EXPECT_EQ(thermalManager->GetWatchdogStats().trips, 0u);
+    
+    // Wedge the worker inside an EC transaction: it holds the EC mutex while it waits
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        mockIO->StallThread(worker);
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(3), [&] { return critical > 0; }));
+    }
+    // The event is sent from inside the fail-safe, before it is counted
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    // The worker was preempted and let go of the mutex; the fail-safe wrote under it.
+    // The stalled worker never gets past a handshake, so it cannot touch the EC memory.
+    EXPECT_EQ(mockIO->GetECByte(0x2F), 0x80);
+    
+    WatchdogStats stalled = thermalManager->GetWatchdogStats();
+    EXPECT_EQ(stalled.trips, 1u);
+    EXPECT_EQ(stalled.failSafeWrites, 1u);
+    EXPECT_EQ(stalled.failSafeFailures, 0u);
+    EXPECT_TRUE(stalled.stalled);
+    
+    // The worker resumes, closes the stall and takes the fan back
+    mockIO->StallThread({});
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    ThermalState state = thermalManager->GetState();
+    thermalManager->Stop();
+    
+    EXPECT_FALSE(state.watchdog.stalled);
+    EXPECT_EQ(state.watchdog.trips, 1u);
+    EXPECT_GE(state.watchdog.lastStallMs, 100u);
+    EXPECT_EQ(state.watchdog.maxStallMs, state.watchdog.lastStallMs);
+    EXPECT_EQ(state.fanState.currentLevel, 0);
+}
+
+TEST_F(ThermalManagerTest, PublishesCycleProfile) {
+    config.cycle.periodMs = 100;
+    CreateManager();
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<CycleProfile> profiles;
+    thermalManager->Subscribe<CycleProfileEvent>([&](const CycleProfileEvent& e) {
+        std::lock_guard<std::mutex> lock(mutex);
+        profiles.push_back(e.profile);
+        cv.notify_all();
+    });
+    
+    thermalManager->Start();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return profiles.size() >= 2; }));
+    }
+    thermalManager->Stop();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    const CycleProfile& profile = profiles.back();
+    EXPECT_EQ(profile.cycles, profiles.size());
+    EXPECT_EQ(profile[CyclePhase::Total].samples, profile.cycles);
+    EXPECT_EQ(profile[CyclePhase::SensorRead].samples, profile.cycles);
+    EXPECT_EQ(profile[CyclePhase::TachRead].samples, profile.cycles);
+    EXPECT_LE(profile[CyclePhase::SensorRead].p50Us, profile[CyclePhase::SensorRead].maxUs);
+    EXPECT_LE(profile[CyclePhase::SensorRead].maxUs, profile[CyclePhase::Total].maxUs);
+    EXPECT_GT(profile.ec.bytesRead, 0u);
+    EXPECT_GE(profile.ec.bytesRead, profiles.front().ec.bytesRead);
+    
+    // The state carries the same profile
+    EXPECT_EQ(thermalManager->GetCycleProfile().cycles, profile.cycles);
+}
+
+TEST_F(ThermalManagerTest, WakesOnlyWhenRequested) {
+    config.cycleSeconds = 10;
+    CreateManager();
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    int updates = 0;
+    thermalManager->Subscribe([&](const ThermalEvent& e) {
+        if (std::holds_alternative<TemperatureUpdateEvent>(e)) {
+            std::lock_guard<std::mutex> lock(mutex);
+            updates++;
+            cv.notify_all();
+        }
+    });
+    auto waitForUpdates = [&](int count, std::chrono::milliseconds timeout = std::chrono::seconds(2)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, timeout, [&] { return updates >= count; });
+    };
+    
+    thermalManager->Start();
+    ASSERT_TRUE(waitForUpdates(1));
+    
+    // Idle: no further cycle long before the 10 s deadline
+    EXPECT_FALSE(waitForUpdates(2, std::chrono::milliseconds(300)));
+    
+    // A forced update and a mode change each run a cycle right away
+    thermalManager->ForceUpdate();
+    EXPECT_TRUE(waitForUpdates(2));
+    thermalManager->SetMode(ControlMode::Manual);
+    EXPECT_TRUE(waitForUpdates(3));
+    
+    // Stop interrupts the wait instead of sleeping out the cycle
+    auto stopStart = std::chrono::steady_clock::now();
+    thermalManager->Stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - stopStart, std::chrono::seconds(2));
+}
+
+TEST_F(ThermalManagerTest, SchedulerKeepsDeadlineGrid) {
+    CreateManager();
+    thermalManager->Start();
+    
+    // Forced cycles in between must not shift the 1 s grid
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    thermalManager->ForceUpdate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1300));
+    
+    ThermalState state = thermalManager->GetState();
+    thermalManager->Stop();
+    
+    // t = 0, 1 s and the forced one; a slow host may already reach t = 2 s
+    const SchedulerStats& stats = state.scheduler;
+    EXPECT_GE(stats.cycles, 3u);
+    EXPECT_LE(stats.cycles, 4u);
+    EXPECT_EQ(stats.forcedCycles, 1u);
+    EXPECT_EQ(stats.missedDeadlines, 0u);
+    EXPECT_EQ(stats.overruns, 0u);
+    
+    uint64_t histogramTotal = 0;
+    for (auto count : stats.jitterHistogram) histogramTotal += count;
+    EXPECT_EQ(histogramTotal, stats.cycles - stats.forcedCycles);
+    EXPECT_LT(stats.maxJitterUs, 50000u);
+    EXPECT_GT(stats.worstCycle.TotalUs(), 0u);
+    EXPECT_GE(stats.lastCycle.TotalUs(),
+              stats.lastCycle[CyclePhase::SensorRead] + stats.lastCycle[CyclePhase::ControlDecision]);
+}
+
+TEST_F(ThermalManagerTest, ForcedCycleOverrunKeepsSlot) {
+    CreateManager();
+    
+    // Only the forced cycle is slow, so it ends past the t = 1 s deadline
+    std::atomic<bool> slow{false};
+    thermalManager->Subscribe([&](const ThermalEvent& e) {
+        if (std::holds_alternative<TemperatureUpdateEvent>(e) && slow.exchange(false)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(400));
+        }
+    });
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(800));
+    slow = true;
+    thermalManager->ForceUpdate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    
+    ThermalState state = thermalManager->GetState();
+    thermalManager->Stop();
+    
+    // The 1 s slot still runs right after the forced cycle instead of being skipped
+    EXPECT_GE(state.scheduler.cycles, 3u);
+    EXPECT_EQ(state.scheduler.forcedCycles, 1u);
+    EXPECT_EQ(state.scheduler.missedDeadlines, 0u);
+}
+
+TEST_F(ThermalManagerTest, MillisecondCyclePeriod) {
+    config.cycle.periodMs = 200;
+    CreateManager();
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    
+    ThermalState state = thermalManager->GetState();
+    thermalManager->Stop();
+    
+    // t = 0, 200, ..., 1000 ms
+    EXPECT_GE(state.scheduler.cycles, 5u);
+    EXPECT_LE(state.scheduler.cycles, 7u);
+}
+
 TEST_F(ThermalManagerTest, ForceUpdate) {
     CreateManager();
     thermalManager->Start();
@@ -212,12 +524,12 @@ TEST_F(UIAdapterTest, TempHistoryAccumulates) {
     
     thermalManager->Stop();
     
-    auto history = uiAdapter->GetAllTempHistory();
+    auto history = uiAdapter->GetHistory().Read();
     
     // Should have at least one sensor with history
     bool hasHistory = false;
-    for (const auto& kv : history) {
-        if (!kv.second.empty()) {
+    for (int i = 0; i < HistoryStore::kSensors; i++) {
+        if (!history.Series(HistoryTier::Seconds, i).empty()) {
             hasHistory = true;
             break;
         }
@@ -312,6 +624,1547 @@ TEST_F(EventDispatcherTest, ClearAll) {
     EXPECT_EQ(callCount.load(), 0);
 }
 
+TEST_F(EventDispatcherTest, SubscribeDuringDispatch) {
+    // The list being iterated is immutable: changes apply to the next dispatch
+    std::atomic<int> outer{0}, inner{0};
+    EventDispatcher::SubscriptionId self = 0;
+    self = dispatcher.Subscribe([&](const Core::ThermalEvent&) {
+        outer++;
+        dispatcher.Subscribe([&inner](const Core::ThermalEvent&) { inner++; });
+        dispatcher.Unsubscribe(self);
+    });
+    
+    EXPECT_TRUE(dispatcher.HasSubscribers<ModeChangeEvent>());
+    dispatcher.Dispatch(ModeChangeEvent{});
+    EXPECT_EQ(outer.load(), 1);
+    EXPECT_EQ(inner.load(), 0);
+    
+    dispatcher.Dispatch(ModeChangeEvent{});
+    EXPECT_EQ(outer.load(), 1);
+    EXPECT_EQ(inner.load(), 1);
+}
+
+TEST_F(EventDispatcherTest, HasSubscribers) {
+    EXPECT_FALSE(dispatcher.HasSubscribers<LogEvent>());
+    EXPECT_FALSE(dispatcher.HasSubscribers<TemperatureUpdateEvent>());
+    
+    auto id = dispatcher.Subscribe([](const Core::ThermalEvent&) {});
+    EXPECT_TRUE(dispatcher.HasSubscribers<LogEvent>());
+    EXPECT_TRUE(dispatcher.HasSubscribers<TemperatureUpdateEvent>());
+    
+    dispatcher.Unsubscribe(id);
+    EXPECT_FALSE(dispatcher.HasSubscribers<LogEvent>());
+}
+
+TEST_F(EventDispatcherTest, TypedSubscriptionsAndMasks) {
+    std::vector<std::string> logs;
+    int fanOrMode = 0;
+    
+    auto logId = dispatcher.Subscribe<LogEvent>([&](const LogEvent& e) { logs.push_back(e.message); });
+    dispatcher.Subscribe([&](const Core::ThermalEvent& e) {
+        EXPECT_FALSE(std::holds_alternative<LogEvent>(e));
+        fanOrMode++;
+    }, {.events = EventMask<FanStateChangeEvent, ModeChangeEvent>});
+    
+    EXPECT_TRUE(dispatcher.HasSubscribers<LogEvent>());
+    EXPECT_TRUE(dispatcher.HasSubscribers<FanStateChangeEvent>());
+    EXPECT_TRUE(dispatcher.HasSubscribers<ModeChangeEvent>());
+    EXPECT_FALSE(dispatcher.HasSubscribers<TemperatureUpdateEvent>());
+    EXPECT_FALSE(dispatcher.HasSubscribers<ErrorEvent>());
+    
+    dispatcher.Dispatch(LogEvent{.message = "hello"});
+    dispatcher.Dispatch(FanStateChangeEvent{});
+    dispatcher.Dispatch(ModeChangeEvent{});
+    dispatcher.Dispatch(ErrorEvent{});
+    
+    ASSERT_EQ(logs.size(), 1u);
+    EXPECT_EQ(logs[0], "hello");
+    EXPECT_EQ(fanOrMode, 2);
+    
+    dispatcher.Unsubscribe(logId);
+    EXPECT_FALSE(dispatcher.HasSubscribers<LogEvent>());
+    EXPECT_TRUE(dispatcher.HasSubscribers<FanStateChangeEvent>());
+}
+
+TEST_F(EventDispatcherTest, AsyncSlowSubscriberDoesNotStallProducer) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);  // Blocks the consumer until released
+    std::atomic<int> delivered{0};
+    std::vector<int> levels;
+    
+    auto id = dispatcher.Subscribe([&](const Core::ThermalEvent& e) {
+        std::lock_guard<std::mutex> wait(gate);
+        levels.push_back(std::get<FanStateChangeEvent>(e).currentLevel);
+        delivered++;
+    }, {.async = true, .queueCapacity = 4, .overflow = EventOverflowPolicy::DropOldest});
+    
+    // The consumer takes event 0 and blocks in the callback
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 1; i < 20; i++) {
+        dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = i});
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(100));
+    EXPECT_EQ(dispatcher.GetSubscriberStats()[0].dropped, 15u);
+    
+    hold.unlock();
+    for (int i = 0; i < 200 && delivered.load() < 5; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.Unsubscribe(id);
+    
+    // Event 0 plus the newest four that fit the queue
+    ASSERT_EQ(levels.size(), 5u);
+    EXPECT_EQ(levels.front(), 0);
+    EXPECT_EQ(levels.back(), 19);
+    for (size_t i = 1; i < levels.size(); i++) EXPECT_GT(levels[i], levels[i - 1]);
+}
+
+TEST_F(EventDispatcherTest, AsyncCoalesceAndStats) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> delivered{0};
+    int lastLevel = -1;
+    
+    dispatcher.Subscribe([&](const Core::ThermalEvent& e) {
+        std::lock_guard<std::mutex> wait(gate);
+        if (auto* fan = std::get_if<FanStateChangeEvent>(&e)) lastLevel = fan->currentLevel;
+        delivered++;
+    }, {.async = true, .queueCapacity = 2, .overflow = EventOverflowPolicy::CoalesceLatest});
+    
+    // The consumer picks up event 0 and blocks; 1..9 coalesce into the last slot
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.Dispatch(ModeChangeEvent{});
+    for (int i = 1; i < 10; i++) {
+        dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = i});
+    }
+    
+    auto stats = dispatcher.GetSubscriberStats();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_EQ(stats[0].queued, 2u);
+    EXPECT_EQ(stats[0].coalesced, 8u);
+    EXPECT_EQ(stats[0].dropped, 0u);
+    
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    hold.unlock();
+    for (int i = 0; i < 200 && delivered.load() < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    
+    stats = dispatcher.GetSubscriberStats();
+    EXPECT_EQ(delivered.load(), 3);
+    EXPECT_EQ(lastLevel, 9);
+    EXPECT_EQ(stats[0].delivered, 3u);
+    EXPECT_EQ(stats[0].queued, 0u);
+    EXPECT_GE(stats[0].maxLagUs, 10000u);
+}
+
+TEST_F(EventDispatcherTest, AsyncBlockWaitsThenDropsOldest) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    std::atomic<int> delivered{0};
+    std::vector<int> levels;
+    
+    dispatcher.Subscribe([&](const Core::ThermalEvent& e) {
+        std::lock_guard<std::mutex> wait(gate);
+        levels.push_back(std::get<FanStateChangeEvent>(e).currentLevel);
+        delivered++;
+    }, {.async = true, .queueCapacity = 2, .overflow = EventOverflowPolicy::Block,
+        .blockTimeout = std::chrono::milliseconds(100)});
+    
+    // The consumer takes event 0 and blocks; 1 and 2 fill the queue without waiting
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto start = std::chrono::steady_clock::now();
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 1});
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 2});
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+    
+    // A full queue holds the producer for blockTimeout, then the oldest event goes
+    start = std::chrono::steady_clock::now();
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 3});
+    auto waited = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(waited, std::chrono::milliseconds(90));
+    EXPECT_LT(waited, std::chrono::milliseconds(1000));
+    EXPECT_EQ(dispatcher.GetSubscriberStats()[0].dropped, 1u);
+    
+    hold.unlock();
+    for (int i = 0; i < 200 && delivered.load() < 3; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(levels, (std::vector<int>{0, 2, 3}));
+}
+
+TEST_F(EventDispatcherTest, UnsubscribeReleasesBlockedProducer) {
+    std::mutex gate;
+    std::unique_lock<std::mutex> hold(gate);
+    
+    auto id = dispatcher.Subscribe([&](const Core::ThermalEvent&) {
+        std::lock_guard<std::mutex> wait(gate);
+    }, {.async = true, .queueCapacity = 1, .overflow = EventOverflowPolicy::Block,
+        .blockTimeout = std::chrono::seconds(10)});
+    
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 0});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 1});
+    
+    // The producer waits for space that never comes...
+    std::atomic<bool> produced{false};
+    std::thread producer([&] {
+        dispatcher.Dispatch(FanStateChangeEvent{.currentLevel = 2});
+        produced = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(produced.load());
+    
+    // ...until the subscription goes away. Unsubscribe itself waits for the
+    // callback stuck on the gate, so it runs on its own thread.
+    auto start = std::chrono::steady_clock::now();
+    std::thread unsubscriber([&] { dispatcher.Unsubscribe(id); });
+    for (int i = 0; i < 200 && !produced.load(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_TRUE(produced.load());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    
+    hold.unlock();
+    unsubscriber.join();
+    producer.join();
+}
+
+// ============================================================================
+// ConfigDiff Tests
+// ============================================================================
+
+TEST(ConfigDiffTest, FlagsOnlyChangedPieces) {
+    ThermalConfig before;
+    before.sensors = CreateDefaultSensorConfig();
+    before.smartProfiles[0].push_back(SmartLevelDefinition(60, 3, 2, 2));
+    EXPECT_TRUE(DiffConfig(before, before).Empty());
+    
+    // A rename touches nothing but that sensor's name
+    ThermalConfig after = before;
+    after.sensors[2].name = "Battery";
+    ConfigDiff diff = DiffConfig(before, after);
+    EXPECT_EQ(diff.sensorNames, std::vector<int>{2});
+    EXPECT_TRUE(diff.sensorOffsets.empty());
+    EXPECT_TRUE(diff.sensorWeights.empty());
+    EXPECT_FALSE(diff.smartProfiles);
+    EXPECT_FALSE(diff.thresholds);
+    EXPECT_EQ(diff.Describe(), "sensor names");
+    
+    // A PID target moves an adaptive-cycle threshold, a smart level edit recompiles
+    after = before;
+    after.pid.targetTemp = 70.0f;
+    after.smartProfiles[0][0].fanLevel = 4;
+    after.sensors[5].hystMax = 50;
+    diff = DiffConfig(before, after);
+    EXPECT_TRUE(diff.pid);
+    EXPECT_TRUE(diff.smartProfiles);
+    EXPECT_TRUE(diff.thresholds);
+    EXPECT_EQ(diff.sensorOffsets, std::vector<int>{5});
+    EXPECT_FALSE(diff.ramp);
+    EXPECT_FALSE(diff.cyclePeriod);
+    EXPECT_EQ(diff.Describe(), "sensor offsets, smart profiles, pid, thresholds");
+    
+    // The manual exit temperature is a threshold only; dropped sensors are flagged
+    after = before;
+    after.manModeExitTemp = before.manModeExitTemp + 5;
+    after.sensors.pop_back();
+    diff = DiffConfig(before, after);
+    EXPECT_TRUE(diff.thresholds);
+    EXPECT_FALSE(diff.other);
+    EXPECT_EQ(diff.sensorsRemoved, std::vector<int>{before.sensors.back().index});
+    EXPECT_TRUE(diff.sensorNames.empty());
+    EXPECT_EQ(diff.Describe(), "removed sensors, thresholds");
+}
+
+// ============================================================================
+// FanDither Tests
+// ============================================================================
+
+TEST(FanDitherTest, AverageTracksFractionalDemand) {
+    FanDither::Settings settings;
+    settings.minDwellSeconds = 0.0f;
+    settings.maxWritesPerMinute = 64;
+    FanDither dither(settings);
+    
+    int level = 3;
+    float sum = 0.0f;
+    const int steps = 200;
+    for (int i = 0; i < steps; i++) {
+        level = dither.Update(3.25f, level, 1.0f);
+        EXPECT_TRUE(level == 3 || level == 4);
+        sum += level;
+    }
+    
+    EXPECT_NEAR(sum / steps, 3.25f, 0.05f);
+}
+
+TEST(FanDitherTest, RespectsDwellAndWriteCap) {
+    FanDither::Settings settings;
+    settings.minDwellSeconds = 3.0f;
+    settings.maxWritesPerMinute = 4;
+    FanDither dither(settings);
+    
+    int level = 2;
+    int changes = 0;
+    int held = 0;
+    for (int i = 0; i < 60; i++) {
+        int next = dither.Update(2.5f, level, 1.0f);
+        if (next != level) {
+            EXPECT_GE(held, 3);
+            changes++;
+            held = 0;
+        }
+        held++;
+        level = next;
+    }
+    
+    EXPECT_LE(changes, 4);
+    EXPECT_GT(dither.GetSuppressedWrites(), 0);
+}
+
+TEST(FanDitherTest, LargeDemandChangeBypassesDwell) {
+    FanDither::Settings settings;
+    settings.minDwellSeconds = 30.0f;
+    settings.maxWritesPerMinute = 0;
+    FanDither dither(settings);
+    
+    EXPECT_EQ(dither.Update(1.0f, 1, 1.0f), 1);
+    EXPECT_EQ(dither.Update(6.8f, 1, 1.0f), 7);
+    EXPECT_EQ(dither.Update(2.0f, 0x80, 1.0f), 2);
+}
+
+TEST(FanDitherTest, ClockFollowsMeasuredTime) {
+    FanDither::Settings settings;
+    settings.minDwellSeconds = 20.0f;
+    settings.maxWritesPerMinute = 64;
+    FanDither dither(settings);
+
+    // 30 s cycles are each past the dwell time (clamped to 5 s, it took four)
+    int level = 2;
+    int changes = 0;
+    for (int i = 0; i < 9; i++) {
+        int next = dither.Update(2.5f, level, 30.0f);
+        if (next != level) changes++;
+        level = next;
+    }
+    EXPECT_GE(changes, 4);
+
+    // No time elapsed: the dwell timer does not move
+    EXPECT_EQ(dither.Update(2.5f, level, 0.0f), level);
+    EXPECT_EQ(dither.Update(2.5f, level, -1.0f), level);
+}
+
+// ============================================================================
+// SmartLevelTable Tests
+// ============================================================================
+
+TEST(SmartLevelTableTest, MatchesLinearScan) {
+    std::vector<SmartLevelDefinition> defs = {
+        SmartLevelDefinition(45, 0, 2, 2),
+        SmartLevelDefinition(50, 1, 1, 3),
+        SmartLevelDefinition(55, 3, 2, 2),
+        SmartLevelDefinition(65, 7, 0, 4),
+        SmartLevelDefinition(75, 64, 2, 2)
+    };
+    std::vector<SmartLevel> levels;
+    for (const auto& d : defs) levels.push_back({d.temperature, d.fanLevel, d.hystUp, d.hystDown});
+    
+    SmartLevelTable table(defs);
+    
+    // Sweep up and down through the whole range and compare every decision
+    int tableLevel = 0, tableIndex = -1;
+    int scanLevel = 0, scanIndex = -1;
+    std::vector<int> temps;
+    for (int t = 30; t <= 90; t++) temps.push_back(t);
+    for (int t = 90; t >= 30; t--) temps.push_back(t);
+    
+    for (int t : temps) {
+        int a = table.Evaluate(t, tableLevel, tableIndex);
+        int b = FanController::SelectSmartLevel(t, levels, scanLevel, scanIndex);
+        ASSERT_EQ(a, b) << "at " << t;
+        if (a != -1) tableLevel = a;
+        if (b != -1) scanLevel = b;
+    }
+}
+
+TEST(SmartLevelTableTest, CompileAllProfiles) {
+    ThermalConfig config;
+    config.smartProfiles[0] = {SmartLevelDefinition(50, 2), SmartLevelDefinition(-1, 0)};
+    
+    auto set = CompileSmartProfiles(config);
+    ASSERT_EQ(set->size(), 2u);
+    EXPECT_EQ((*set)[0].GetLevelCount(), 1);
+    EXPECT_TRUE((*set)[1].IsEmpty());
+    
+    int index = -1;
+    EXPECT_EQ((*set)[0].Evaluate(40, 0, index), -1);
+    EXPECT_EQ((*set)[0].Evaluate(200, 0, index), 2);
+}
+
+// ============================================================================
+// FanRamp Tests
+// ============================================================================
+
+class FanRampTest : public ::testing::Test {
+protected:
+    FanRampConfig config;
+
+    void SetUp() override {
+        config.enabled = true;
+        config.upRate = 0.4f;       // 2 levels per 5 s cycle
+        config.downRate = 0.2f;     // 1 level per 5 s cycle
+        config.minDwell = 5.0f;
+        config.reversalWindow = 15.0f;
+        config.criticalTemp = 85;
+    }
+};
+
+TEST_F(FanRampTest, LimitsSlewRate) {
+    FanRamp ramp(config);
+    
+    int level = 0;
+    level = ramp.Schedule(7, level, 60, 5.0f);
+    EXPECT_EQ(level, 2);
+    level = ramp.Schedule(7, level, 60, 5.0f);
+    EXPECT_EQ(level, 4);
+    level = ramp.Schedule(7, level, 60, 1.0f);  // Dwell not elapsed
+    EXPECT_EQ(level, 4);
+    EXPECT_EQ(ramp.GetStats().suppressed, 1u);
+}
+
+TEST_F(FanRampTest, CoalescesQuickReversal) {
+    FanRamp ramp(config);
+    
+    int level = ramp.Schedule(2, 0, 60, 5.0f);
+    EXPECT_EQ(level, 2);
+    level = ramp.Schedule(0, level, 60, 5.0f);  // Spike is over, but too soon
+    EXPECT_EQ(level, 2);
+    EXPECT_EQ(ramp.GetStats().reversalsCoalesced, 1u);
+    
+    level = ramp.Schedule(0, level, 60, 10.0f);  // Window has passed
+    EXPECT_EQ(level, 0);
+}
+
+TEST_F(FanRampTest, EmergencyAndBIOSBypass) {
+    FanRamp ramp(config);
+    
+    EXPECT_EQ(ramp.Schedule(7, 0, 90, 5.0f), 7);
+    EXPECT_EQ(ramp.GetStats().emergencyBypasses, 1u);
+    EXPECT_EQ(ramp.Schedule(0x80, 7, 60, 0.1f), 0x80);
+}
+
+TEST_F(FanRampTest, TimersFollowCyclesWithoutChanges) {
+    FanRamp ramp(config);
+    
+    int level = ramp.Schedule(4, 2, 60, 5.0f);
+    EXPECT_EQ(level, 4);
+    // 300 s of steady cycles: a step down is no longer a reversal
+    for (int i = 0; i < 60; i++) level = ramp.Schedule(level, level, 60, 5.0f);
+    EXPECT_EQ(ramp.Schedule(3, level, 60, 5.0f), 3);
+    EXPECT_EQ(ramp.GetStats().reversalsCoalesced, 0u);
+}
+
+TEST_F(FanRampTest, SmartHysteresisWaitsForAppliedLevel) {
+    SmartLevelTable table({SmartLevelDefinition(50, 1, 3, 3), SmartLevelDefinition(60, 7, 3, 3)});
+    FanRamp ramp(config);
+    SmartLevelState state;
+    int level = 0;
+    auto cycle = [&](int temp) {
+        int requested = table.Request(temp, level, state);
+        level = ramp.Schedule(requested, level, temp, 5.0f);
+        table.Confirm(level, state);
+    };
+    
+    for (int i = 0; i < 4; i++) cycle(55);
+    EXPECT_EQ(level, 1);
+    EXPECT_EQ(state.appliedIndex, 0);
+    
+    // The spike only gets the fan part of the way up
+    cycle(64);
+    EXPECT_EQ(level, 3);
+    EXPECT_EQ(state.appliedIndex, 0);
+    
+    // 61 °C is below the entry threshold of level 7: back to level 1, not stuck at 3
+    for (int i = 0; i < 10; i++) cycle(61);
+    EXPECT_EQ(level, 1);
+    EXPECT_EQ(state.appliedIndex, 0);
+    
+    // A sustained rise reaches level 7, which then holds down to 57 °C
+    for (int i = 0; i < 10; i++) cycle(64);
+    EXPECT_EQ(level, 7);
+    EXPECT_EQ(state.appliedIndex, 1);
+    for (int i = 0; i < 10; i++) cycle(61);
+    EXPECT_EQ(level, 7);
+}
+
+// ============================================================================
+// RelayAutotuner Tests
+// ============================================================================
+
+TEST(RelayAutotunerTest, IdentifiesOscillationOnSimulatedPlant) {
+    AutotuneSettings settings;
+    settings.setpoint = 60.0f;
+    settings.lowLevel = 1;
+    settings.highLevel = 6;
+    settings.cycles = 3;
+    
+    RelayAutotuner tuner;
+    tuner.Start(settings, 0.0);
+    
+    // First-order plant with a 3 s transport lag, sampled once per second
+    float temp = 55.0f;
+    std::deque<int> lag(3, 1);
+    double t = 0.0;
+    while (tuner.IsActive() && t < 3600.0) {
+        int level = tuner.Update(temp, t);
+        lag.push_back(level);
+        int applied = lag.front();
+        lag.pop_front();
+        temp += 0.6f - 0.15f * applied;
+        t += 1.0;
+    }
+    
+    const auto& progress = tuner.GetProgress();
+    ASSERT_EQ(progress.phase, AutotunePhase::Success);
+    EXPECT_EQ(progress.completedCycles, 3);
+    EXPECT_GT(progress.ultimateGain, 0.0f);
+    EXPECT_GT(progress.ultimatePeriod, 2.0f);
+    
+    PIDConfig tuned = tuner.GetResult(PIDConfig());
+    EXPECT_GT(tuned.Kp, 0.0f);
+    EXPECT_GT(tuned.Ki, 0.0f);
+    EXPECT_FLOAT_EQ(tuned.targetTemp, 60.0f);
+}
+
+TEST(RelayAutotunerTest, TimesOutWithoutCrossing) {
+    AutotuneSettings settings;
+    settings.timeoutSeconds = 60.0f;
+    
+    RelayAutotuner tuner;
+    tuner.Start(settings, 100.0);
+    for (double t = 100.0; t < 200.0 && tuner.IsActive(); t += 5.0) {
+        tuner.Update(40.0f, t);
+    }
+    EXPECT_EQ(tuner.GetProgress().phase, AutotunePhase::Failed);
+    
+    // A seeded run falls back to the model gains
+    settings.hasSeed = true;
+    settings.seed.Kp = 0.8f;
+    settings.seed.Ki = 0.02f;
+    settings.seed.Kd = 0.0f;
+    tuner.Start(settings, 100.0);
+    for (double t = 100.0; t < 200.0 && tuner.IsActive(); t += 5.0) {
+        tuner.Update(40.0f, t);
+    }
+    ASSERT_EQ(tuner.GetProgress().phase, AutotunePhase::Success);
+    EXPECT_TRUE(tuner.GetProgress().fromSeed);
+    PIDConfig result = tuner.GetResult(PIDConfig());
+    EXPECT_FLOAT_EQ(result.Kp, 0.8f);
+    EXPECT_FLOAT_EQ(result.Ki, 0.02f);
+    EXPECT_FLOAT_EQ(result.Kd, 0.0f);
+    EXPECT_FLOAT_EQ(result.targetTemp, settings.setpoint);
+}
+
+// ============================================================================
+// FanZone Tests
+// ============================================================================
+
+class FanZoneTest : public ::testing::Test {
+protected:
+    std::vector<SensorReading> sensors;
+    SmartLevelTable profile{{
+        SmartLevelDefinition(50, 0, 2, 2),
+        SmartLevelDefinition(60, 3, 2, 2),
+        SmartLevelDefinition(70, 7, 2, 2)
+    }};
+
+    void SetUp() override {
+        sensors.resize(SensorAddresses::TOTAL_COUNT);
+        for (int i = 0; i < (int)sensors.size(); i++) {
+            sensors[i] = {i, SensorAddresses::GetAddress(i), "", 0, 0, 1.0f, false};
+        }
+        SetTemp(0, "CPU", 72);
+        SetTemp(3, "GPU", 48);
+    }
+
+    void SetTemp(int index, const std::string& name, int temp) {
+        sensors[index].name = name;
+        sensors[index].rawTemp = temp;
+        sensors[index].biasedTemp = temp;
+        sensors[index].isAvailable = true;
+    }
+};
+
+TEST_F(FanZoneTest, ZoneTempUsesAssignedSensors) {
+    FanZoneConfig cpuZone;
+    cpuZone.sensorIndices = {0};
+    FanZoneConfig gpuZone;
+    gpuZone.sensorIndices = {3};
+    FanZoneConfig allZone;
+    
+    EXPECT_EQ(FanZone::ComputeZoneTemp(cpuZone, sensors, ""), 72);
+    EXPECT_EQ(FanZone::ComputeZoneTemp(gpuZone, sensors, "GPU"), 48);  // Explicit beats ignore list
+    EXPECT_EQ(FanZone::ComputeZoneTemp(allZone, sensors, "CPU"), 48);
+}
+
+TEST_F(FanZoneTest, ZonesPickIndependentLevels) {
+    FanZoneConfig cpuZone;
+    cpuZone.sensorIndices = {0};
+    FanZoneConfig gpuZone;
+    gpuZone.sensorIndices = {3};
+    
+    FanZone fan1, fan2;
+    int level1 = fan1.Evaluate(cpuZone, &profile, FanZone::ComputeZoneTemp(cpuZone, sensors, ""), 0, 1.0f);
+    int level2 = fan2.Evaluate(gpuZone, &profile, FanZone::ComputeZoneTemp(gpuZone, sensors, ""), 0, 1.0f);
+    
+    EXPECT_EQ(level1, 7);
+    EXPECT_EQ(level2, 0);  // GPU is cool, its fan stays off
+}
+
+// ============================================================================
+// ThermalModel Tests
+// ============================================================================
+
+// Simulates dT/dt = q - (k0 + k1*u(t - lag)) * (T - Ta), sampled every 2 s.
+// u is the fan speed in level units; it follows the commanded level with a
+// first-order spin-up of spinUpSeconds, and the tach reports it.
+static std::vector<ThermalSample> SimulatePlant(float lagSeconds, float spinUpSeconds = 0.0f) {
+    const float q = 0.5f, k0 = 0.01f, k1 = 0.005f, ambient = 35.0f;
+    const float period = 2.0f, step = 0.01f;
+    const int levels[] = {0, 3, 7, 2, 5, 1, 6, 4};
+    
+    std::vector<ThermalSample> samples;
+    std::deque<float> pipeline((size_t)(lagSeconds / step) + 1, 0.0f);
+    float temp = 50.0f;
+    float speed = 0.0f;
+    for (int i = 0; i < 2400; i++) {
+        int level = levels[(i / 60) % 8];
+        if (spinUpSeconds <= 0.0f) speed = (float)level;
+        samples.push_back({i * period, temp, level, 2000 + (int)(300.0f * speed)});
+        for (int n = 0; n < (int)(period / step); n++) {
+            if (spinUpSeconds > 0.0f) speed += (level - speed) * step / spinUpSeconds;
+            pipeline.push_back(speed);
+            float applied = pipeline.front();
+            pipeline.pop_front();
+            temp += (q - (k0 + k1 * applied) * (temp - ambient)) * step;
+        }
+    }
+    return samples;
+}
+
+TEST(ThermalModelTest, RecoversSimulatedPlant) {
+    auto samples = SimulatePlant(6.0f);
+    ThermalModel model = ThermalModel::Fit(samples);
+    
+    ASSERT_TRUE(model.valid);
+    EXPECT_NEAR(model.deadTime, 6.0f, 2.0f);
+    EXPECT_NEAR(model.k0, 0.01f, 0.001f);
+    EXPECT_NEAR(model.k1, 0.005f, 0.0005f);
+    EXPECT_NEAR(model.Ambient(), 35.0f, 2.0f);
+    EXPECT_NEAR(model.SteadyStateTemp(7.0f), 35.0f + 0.5f / 0.045f, 1.0f);
+    EXPECT_LT(model.StaticGain(3.0f), 0.0f);
+    
+    PIDConfig tuned = model.SuggestPID(PIDConfig(), 3.0f);
+    EXPECT_GT(tuned.Kp, 0.0f);
+    EXPECT_GT(tuned.Ki, 0.0f);
+    EXPECT_NEAR(model.SteadyStateTemp(model.HoldingLevel(60.0f)), 60.0f, 0.01f);
+}
+
+TEST(ThermalModelTest, RegressesOnMeasuredRpm) {
+    // A slow spin-up the level series cannot express
+    auto samples = SimulatePlant(2.0f, 20.0f);
+    ThermalModel measured = ThermalModel::Fit(samples);
+    
+    for (auto& sample : samples) sample.fanRpm = -1;
+    ThermalModel commanded = ThermalModel::Fit(samples);
+    
+    ASSERT_TRUE(measured.valid);
+    ASSERT_TRUE(commanded.valid);
+    EXPECT_TRUE(measured.usesRpm);
+    EXPECT_FALSE(commanded.usesRpm);
+    EXPECT_LT(measured.rmsError, commanded.rmsError);
+    EXPECT_NEAR(measured.k1, 0.005f, 0.0005f);
+    
+    // A tach stuck at zero on a running fan is not used
+    for (auto& sample : samples) sample.fanRpm = 0;
+    EXPECT_FALSE(ThermalModel::Fit(samples).usesRpm);
+}
+
+TEST(ThermalModelTest, RejectsUnexcitedOrBrokenSeries) {
+    auto samples = SimulatePlant(0.0f);
+    
+    // Constant fan level: fan terms cannot be identified
+    std::vector<ThermalSample> constant(samples.begin(), samples.begin() + 60);
+    EXPECT_FALSE(ThermalModel::Fit(constant).valid);
+    
+    // BIOS samples and gaps split the series but the rest still fits
+    for (size_t i = 500; i < 520; i++) samples[i].fanLevel = 0x80;
+    for (size_t i = 1000; i < samples.size(); i++) samples[i].time += 600.0;
+    EXPECT_TRUE(ThermalModel::Fit(samples).valid);
+}
+
+TEST(ThermalModelTest, EstimatorRecordsEventStream) {
+    ThermalModelEstimatorSettings settings;
+    settings.refitInterval = 1000000;
+    auto estimator = std::make_shared<ThermalModelEstimator>(settings);
+    
+    auto t0 = std::chrono::steady_clock::now();
+    auto cpu = std::make_shared<const std::vector<SensorReading>>(
+        std::vector<SensorReading>{{0, 0x78, "CPU", 60, 60, 1.0f, true}});
+    
+    // Temperatures before the first fan state are dropped
+    estimator->OnThermalEvent(TemperatureUpdateEvent{t0, cpu, 0, 60, "CPU"});
+    estimator->OnThermalEvent(FanStateChangeEvent{t0, 3000, 0, 4, 4});
+    estimator->OnThermalEvent(TemperatureUpdateEvent{t0 + std::chrono::seconds(5), cpu, 0, 60, "CPU"});
+    
+    auto history = estimator->GetHistory(0);
+    ASSERT_EQ(history.size(), 1u);
+    EXPECT_EQ(history[0].fanLevel, 4);
+    EXPECT_EQ(history[0].fanRpm, 3000);
+    EXPECT_FALSE(estimator->GetModel(0).valid);
+}
+
+TEST_F(ThermalManagerTest, SeedsDefaultPIDGainsFromModel) {
+    ThermalModelEstimatorSettings settings;
+    settings.historySamples = 4000;
+    settings.refitInterval = 1000000;
+    auto estimator = std::make_shared<ThermalModelEstimator>(settings);
+    
+    // Identify the GPU sensor (the hottest) from a simulated run
+    auto t0 = std::chrono::steady_clock::now();
+    for (const auto& sample : SimulatePlant(4.0f)) {
+        auto at = t0 + std::chrono::milliseconds((int64_t)(sample.time * 1000.0));
+        int temp = (int)std::lround(sample.temp);
+        auto readings = std::make_shared<const std::vector<SensorReading>>(
+            std::vector<SensorReading>{{1, 0x79, "GPU", temp, temp, 1.0f, true}});
+        estimator->OnThermalEvent(FanStateChangeEvent{at, sample.fanRpm, 0, sample.fanLevel, sample.fanLevel});
+        estimator->OnThermalEvent(TemperatureUpdateEvent{at, readings, 1, temp, "GPU"});
+    }
+    estimator->Refit();
+    ThermalModel model = estimator->GetModel(1);
+    ASSERT_TRUE(model.valid);
+    
+    config.cycle.periodMs = 100;
+    CreateManager();
+    thermalManager->SetThermalModels(estimator);
+    thermalManager->SetMode(ControlMode::PID);
+    uint64_t initialVersion = thermalManager->GetConfigVersion();
+    
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    PIDConfig pid = thermalManager->GetAutotuneResult();
+    uint64_t version = thermalManager->GetConfigVersion();
+    thermalManager->Stop();
+    
+    // Published once, with the model's gains at the level that holds the target
+    EXPECT_EQ(version, initialVersion + 1);
+    float level = std::clamp(model.HoldingLevel(60.0f), 0.0f, 7.0f);
+    PIDConfig expected = model.SuggestPID(PIDConfig(), level);
+    EXPECT_FLOAT_EQ(pid.Kp, expected.Kp);
+    EXPECT_FLOAT_EQ(pid.Ki, expected.Ki);
+    EXPECT_NE(pid.Kp, PIDConfig().Kp);
+    
+    // Tuned gains are left alone
+    config.pid.Kp = 2.0f;
+    CreateManager();
+    thermalManager->SetThermalModels(estimator);
+    thermalManager->SetMode(ControlMode::PID);
+    thermalManager->Start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_FLOAT_EQ(thermalManager->GetAutotuneResult().Kp, 2.0f);
+    thermalManager->Stop();
+}
+
+// ============================================================================
+// FanMPC Tests
+// ============================================================================
+
+// Closed loop against the plant of SimulatePlant with 10% more heat than the
+// controller's model; returns the number of level changes
+template <typename Controller>
+static int RunClosedLoop(Controller&& controller, float& settledPeak) {
+    const float q = 0.55f, k0 = 0.01f, k1 = 0.005f, ambient = 35.0f, lag = 4.0f;
+    const float period = 2.0f, step = 0.01f;
+    std::deque<int> pipeline((size_t)(lag / step) + 1, 0);
+    float temp = 50.0f;
+    int level = 0, changes = 0;
+    settledPeak = 0.0f;
+    for (int i = 0; i < 900; i++) {
+        int next = controller((float)std::round(temp), level, period);
+        if (next != level) changes++;
+        level = next;
+        for (int n = 0; n < (int)(period / step); n++) {
+            pipeline.push_back(level);
+            int applied = pipeline.front();
+            pipeline.pop_front();
+            temp += (q - (k0 + k1 * applied) * (temp - ambient)) * step;
+        }
+        if (i >= 450) settledPeak = std::max(settledPeak, temp);
+    }
+    return changes;
+}
+
+TEST(FanMPCTest, HoldsTargetWithFewerLevelChangesThanPID) {
+    ThermalModel model;
+    model.valid = true;
+    model.k0 = 0.01f;
+    model.k1 = 0.005f;
+    model.a0 = 0.5f + model.k0 * 35.0f;
+    model.a1 = model.k1 * 35.0f;
+    model.deadTime = 4.0f;
+    
+    MPCConfig config;
+    config.targetTemp = 65.0f;
+    
+    FanMPC mpc;
+    float mpcPeak;
+    int mpcChanges = RunClosedLoop([&](float temp, int level, float dt) {
+        return mpc.Update(model, config, temp, level, dt);
+    }, mpcPeak);
+    
+    PIDSettings settings;
+    settings.targetTemp = 65.0f;
+    PIDState state;
+    float pidPeak;
+    int pidChanges = RunClosedLoop([&](float temp, int level, float dt) {
+        float output = FanController::ComputePIDOutput(state, temp, settings, dt);
+        return FanController::MapPIDOutputToLevel(output, level, settings);
+    }, pidPeak);
+    
+    EXPECT_LT(mpcPeak, 66.5f);
+    EXPECT_GT(mpc.GetDisturbance(), 0.0f);  // Picked up the unmodelled heat
+    EXPECT_LE(mpcChanges, pidChanges);
+    EXPECT_LE(mpcChanges, 5);
+}
+
+TEST(FanMPCTest, ObserverUsesMeasuredCycleTime) {
+    ThermalModel model;
+    model.valid = true;
+    model.k0 = 0.01f;
+    model.k1 = 0.005f;
+    model.a0 = 0.5f + model.k0 * 35.0f;
+    model.a1 = model.k1 * 35.0f;
+    model.deadTime = 4.0f;
+
+    MPCConfig config;
+    config.minFan = 3;
+    config.maxFan = 3;
+
+    // A plant that follows the model exactly, sampled every 12 s: nothing to correct
+    FanMPC mpc;
+    float temp = 80.0f;
+    int level = 3;
+    for (int i = 0; i < 20; i++) {
+        level = mpc.Update(model, config, temp, level, i == 0 ? 0.0f : 12.0f);
+        temp = model.Predict(temp, (float)level, 12.0f);
+    }
+    EXPECT_NEAR(mpc.GetDisturbance(), 0.0f, 1e-3f);
+}
+
+// ============================================================================
+// FanRpmController Tests
+// ============================================================================
+
+class FanRpmControllerTest : public ::testing::Test {
+protected:
+    // Fan whose RPM per level is unlike the default guess
+    static int FanRpm(int level) {
+        static const int curve[8] = {0, 1900, 2300, 2700, 3500, 3900, 4300, 5200};
+        return (level >= 0 && level < 8) ? curve[level] : 2500;
+    }
+    
+    // Run the tach loop at 2 Hz for the given time; returns level changes
+    int Run(FanRpmController& ctrl, int targetRpm, int& level, float seconds) {
+        int changes = 0;
+        for (float t = 0.0f; t < seconds; t += 0.5f) {
+            int next = ctrl.Update(targetRpm, FanRpm(level), level, 0.5f);
+            if (next != level) changes++;
+            level = next;
+        }
+        return changes;
+    }
+};
+
+TEST_F(FanRpmControllerTest, LearnsCurveAndSettlesOnMatchingLevel) {
+    FanRpmConfig config;
+    config.dither = false;
+    FanRpmController ctrl;
+    ctrl.SetConfig(config);
+    
+    int level = 0;
+    Run(ctrl, 3500, level, 300.0f);
+    EXPECT_EQ(level, 4);
+    EXPECT_TRUE(ctrl.IsLearned(4));
+    EXPECT_NEAR(ctrl.EstimateRpm(4), 3500.0f, 1.0f);
+    
+    // Once there, holding the target costs no further writes
+    EXPECT_EQ(Run(ctrl, 3500, level, 300.0f), 0);
+}
+
+TEST_F(FanRpmControllerTest, DithersBetweenLevelsForIntermediateTarget) {
+    FanRpmConfig config;
+    config.minDwellSeconds = 10.0f;
+    config.maxWritesPerMin = 4;
+    FanRpmController ctrl;
+    ctrl.SetConfig(config);
+    
+    // Learn levels 3 and 4 first, then ask for a speed half way between them
+    int level = 3;
+    Run(ctrl, 2700, level, 20.0f);
+    level = 4;
+    Run(ctrl, 3500, level, 20.0f);
+    
+    int low = 0, high = 0, changes = 0;
+    for (int i = 0; i < 1200; i++) {
+        int next = ctrl.Update(3100, FanRpm(level), level, 0.5f);
+        if (next != level) changes++;
+        level = next;
+        if (level == 3) low++;
+        if (level == 4) high++;
+    }
+    EXPECT_GT(low, 300);
+    EXPECT_GT(high, 300);
+    EXPECT_LE(changes, 4 * 10 + 1);  // Write budget over 10 minutes
+}
+
+// ============================================================================
+// AdaptiveCycle Tests
+// ============================================================================
+
+TEST(AdaptiveCycleTest, FastWhileRisingOrNearThreshold) {
+    ThermalConfig thermal;
+    thermal.smartProfiles[0].emplace_back(60, 3);
+    thermal.pid.targetTemp = 70.0f;
+    thermal.mpc.targetTemp = 70.0f;
+    thermal.manModeExitTemp = 80;
+    thermal.ramp.criticalTemp = 85;
+    
+    CycleConfig cycle;
+    cycle.adaptive = true;
+    AdaptiveCycle adaptive;
+    adaptive.SetThresholds(AdaptiveCycle::CollectThresholds(thermal, ControlMode::Smart, 0));
+    
+    // Stable far from any threshold: back off to the maximum period
+    int period = 0;
+    for (int i = 0; i < 10; i++) period = adaptive.Update(45, 5.0f, cycle);
+    EXPECT_EQ(period, cycle.maxPeriodMs);
+    EXPECT_FALSE(adaptive.IsFast());
+    
+    // Rising quickly: fast at once
+    period = adaptive.Update(48, 1.0f, cycle);
+    period = adaptive.Update(51, 0.5f, cycle);
+    EXPECT_TRUE(adaptive.IsFast());
+    EXPECT_EQ(period, cycle.minPeriodMs);
+    
+    // Parked just below a smart threshold the loop backs off once the slope settles
+    for (int i = 0; i < 40; i++) period = adaptive.Update(59, 0.5f, cycle);
+    EXPECT_FALSE(adaptive.IsFast());
+    EXPECT_GT(period, cycle.minPeriodMs);
+    
+    // Creeping up towards it is fast again; cooling away backs off
+    period = adaptive.Update(60, 5.0f, cycle);
+    EXPECT_TRUE(adaptive.IsFast());
+    EXPECT_EQ(period, cycle.minPeriodMs);
+    period = adaptive.Update(50, 0.5f, cycle);
+    EXPECT_EQ(period, cycle.minPeriodMs * 2);
+}
+
+TEST(AdaptiveCycleTest, ThresholdsFollowActiveMode) {
+    ThermalConfig thermal;
+    thermal.smartProfiles[0].emplace_back(60, 3);
+    thermal.smartProfiles[1].emplace_back(52, 3);
+    thermal.pid.targetTemp = 70.0f;
+    thermal.mpc.targetTemp = 72.0f;
+    thermal.manModeExitTemp = 80;
+    thermal.ramp.criticalTemp = 85;
+    
+    using Thresholds = std::vector<int>;
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::BIOS, 0), Thresholds{});
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::Smart, 0), (Thresholds{60, 85}));
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::Smart, 1), (Thresholds{52, 85}));
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::PID, 0), (Thresholds{70, 85}));
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::MPC, 0), (Thresholds{72, 85}));
+    EXPECT_EQ(AdaptiveCycle::CollectThresholds(thermal, ControlMode::Manual, 0), (Thresholds{80, 85}));
+    
+    // A steady 52°C next to the other profile's threshold does not keep the loop fast
+    CycleConfig cycle;
+    cycle.adaptive = true;
+    AdaptiveCycle adaptive;
+    adaptive.SetThresholds(AdaptiveCycle::CollectThresholds(thermal, ControlMode::Smart, 0));
+    int period = 0;
+    for (int i = 0; i < 10; i++) period = adaptive.Update(52, 1.0f, cycle);
+    EXPECT_EQ(period, cycle.maxPeriodMs);
+}
+
+// ============================================================================
+// CycleProfiler Tests
+// ============================================================================
+
+TEST(CycleWatchdogTest, SleepsUntilTheDeadline) {
+    using Clock = CycleWatchdog::Clock;
+    std::atomic<int> fired{0};
+    CycleWatchdog watchdog([&](std::chrono::milliseconds, int) {
+        fired++;
+        return true;
+    });
+    watchdog.Start();
+    
+    // Disarmed: the thread never wakes
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(watchdog.GetStats().wakeups, 0u);
+    
+    // Arming wakes it once; beats that push the deadline out do not
+    Clock::time_point start = Clock::now();
+    watchdog.Beat(start + std::chrono::seconds(10));
+    for (int i = 1; i <= 20; ++i) {
+        watchdog.Beat(start + std::chrono::seconds(10) + std::chrono::milliseconds(i));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_LE(watchdog.GetStats().wakeups, 1u);
+    
+    // An earlier deadline is picked up and fires on time
+    watchdog.Beat(Clock::now() + std::chrono::milliseconds(50));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    WatchdogStats stalled = watchdog.GetStats();
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_EQ(stalled.trips, 1u);
+    EXPECT_LE(stalled.wakeups, 3u);
+    
+    // Fail-safe done: it waits for the worker instead of polling
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(watchdog.GetStats().wakeups, stalled.wakeups);
+    EXPECT_TRUE(watchdog.Beat(Clock::now() + std::chrono::seconds(10)));
+    
+    watchdog.Disarm();
+    watchdog.Stop();
+    EXPECT_EQ(fired.load(), 1);
+}
+
+TEST(CycleProfilerTest, HistogramPercentiles) {
+    // Exact below 16 µs, then four buckets per octave
+    EXPECT_EQ(LatencyHistogram::BucketOf(15), 15);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketOf(100)), 111u);
+    EXPECT_EQ(LatencyHistogram::BucketOf(UINT32_MAX), LatencyHistogram::kBuckets - 1);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::kBuckets - 1), UINT32_MAX);
+    
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.Percentile(0.5), 0u);
+    for (uint32_t us = 1; us <= 1000; us++) histogram.Record(us);
+    
+    EXPECT_EQ(histogram.Count(), 1000u);
+    EXPECT_EQ(histogram.Max(), 1000u);
+    EXPECT_GE(histogram.Percentile(0.50), 500u);
+    EXPECT_LE(histogram.Percentile(0.50), 625u);
+    EXPECT_GE(histogram.Percentile(0.99), 990u);
+    EXPECT_LE(histogram.Percentile(0.99), 1000u);   // Capped at the exact max
+}
+
+TEST(CycleProfilerTest, NestedScopesReportExclusiveTime) {
+    CycleProfiler profiler;
+    {
+        // Outside a cycle nothing is recorded
+        CycleProfiler::Scope scope(profiler, CyclePhase::SensorRead);
+    }
+    
+    profiler.BeginCycle();
+    {
+        CycleProfiler::Scope control(profiler, CyclePhase::ControlDecision);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        {
+            CycleProfiler::Scope write(profiler, CyclePhase::FanWrite);
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        }
+    }
+    profiler.CountSampleRetry();
+    profiler.EndCycle();
+    
+    CycleProfile profile = profiler.Snapshot();
+    EXPECT_EQ(profile.cycles, 1u);
+    EXPECT_EQ(profile.sampleRetries, 1u);
+    EXPECT_EQ(profile[CyclePhase::SensorRead].samples, 0u);
+    EXPECT_EQ(profile[CyclePhase::FanWrite].samples, 1u);
+    EXPECT_GE(profile[CyclePhase::FanWrite].lastUs, 30000u);
+    EXPECT_GE(profile[CyclePhase::ControlDecision].lastUs, 10000u);
+    EXPECT_LT(profile[CyclePhase::ControlDecision].lastUs, 30000u);
+    EXPECT_GE(profile[CyclePhase::Total].lastUs, 40000u);
+}
+
+// ============================================================================
+// HistoryStore Tests
+// ============================================================================
+
+TEST(HistoryStoreTest, BucketsAverageAcrossTiers) {
+    HistoryStore store;
+    const int64_t t0 = 1699999980000;  // Minute aligned
+
+    store.Push(0, t0, 40.0f);
+    store.Push(0, t0 + 500, 50.0f);     // Same second: averaged
+    store.Push(0, t0 + 1000, 60.0f);
+    store.Push(0, t0 + 2000, 70.0f);
+
+    auto reader = store.Read();
+    auto seconds = reader.Series(HistoryTier::Seconds, 0);
+    ASSERT_EQ(seconds.size(), 3u);
+    EXPECT_FLOAT_EQ(seconds[0], 45.0f);
+    EXPECT_FLOAT_EQ(seconds[1], 60.0f);
+    EXPECT_FLOAT_EQ(seconds[2], 70.0f);
+    EXPECT_EQ(reader.NewestTime(HistoryTier::Seconds, 0), t0 + 2000);
+
+    auto minutes = reader.Series(HistoryTier::Minutes, 0);
+    ASSERT_EQ(minutes.size(), 1u);
+    EXPECT_FLOAT_EQ(minutes[0], 55.0f);
+
+    EXPECT_TRUE(reader.Series(HistoryTier::Seconds, 1).empty());
+}
+
+TEST(HistoryStoreTest, GapsHoldOrBreakAndRingWraps) {
+    HistoryStore store;
+    const int64_t t0 = 1700000000000;
+    const uint32_t capacity = HistoryStore::kTiers[0].capacity;
+
+    store.Push(0, t0, 40.0f);
+    store.Push(0, t0 + 5000, 45.0f);      // Short gap: last value held
+    store.Push(0, t0 + 125000, 50.0f);    // Long gap: NaN
+    {
+        auto series = store.Read().Series(HistoryTier::Seconds, 0);
+        ASSERT_EQ(series.size(), 126u);
+        EXPECT_FLOAT_EQ(series[1], 40.0f);
+        EXPECT_FLOAT_EQ(series[4], 40.0f);
+        EXPECT_FLOAT_EQ(series[5], 45.0f);
+        EXPECT_TRUE(std::isnan(series[6]));
+        EXPECT_FLOAT_EQ(series[125], 50.0f);
+    }
+
+    // Past the capacity the window stays contiguous, oldest first
+    for (uint32_t i = 1; i <= capacity + 10; i++) {
+        store.Push(0, t0 + 125000 + i * 1000, (float)(i % 100));
+    }
+    auto series = store.Read().Series(HistoryTier::Seconds, 0);
+    ASSERT_EQ(series.size(), capacity);
+    EXPECT_FLOAT_EQ(series.back(), (float)((capacity + 10) % 100));
+    EXPECT_FLOAT_EQ(series.front(), (float)(11 % 100));
+}
+
+TEST(HistoryStoreTest, PersistsAcrossReopen) {
+    auto path = (std::filesystem::temp_directory_path() / "core_test_history.bin").string();
+    std::remove(path.c_str());
+    const int64_t t0 = 1700000000000;
+
+    {
+        HistoryStore store(path);
+        ASSERT_TRUE(store.IsPersistent());
+        store.Push(3, t0, 61.0f);
+        store.Push(3, t0 + 1000, 62.0f);
+    }
+    {
+        HistoryStore store(path);
+        store.Push(3, t0 + 2000, 63.0f);
+        auto series = store.Read().Series(HistoryTier::Seconds, 3);
+        ASSERT_EQ(series.size(), 3u);
+        EXPECT_FLOAT_EQ(series[0], 61.0f);
+        EXPECT_FLOAT_EQ(series[2], 63.0f);
+    }
+    std::remove(path.c_str());
+}
+
+// ============================================================================
+// PlotDecimator Tests
+// ============================================================================
+
+TEST(PlotDecimatorTest, ReducesColumnsToMinMax) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> values(40);
+    for (int i = 0; i < 40; i++) values[i] = (float)(i % 10);
+    values[13] = nan;                                   // Gap inside a column
+    for (int i = 20; i < 30; i++) values[i] = nan;      // Column of gaps
+    values[35] = 90.0f;
+
+    std::vector<PlotColumn> columns(4);
+    DecimateMinMax(values, columns);
+    EXPECT_FLOAT_EQ(columns[0].min, 0.0f);
+    EXPECT_FLOAT_EQ(columns[0].max, 9.0f);
+    EXPECT_FLOAT_EQ(columns[1].min, 0.0f);
+    EXPECT_FLOAT_EQ(columns[1].max, 9.0f);
+    EXPECT_TRUE(std::isnan(columns[2].min));
+    EXPECT_TRUE(std::isnan(columns[2].max));
+    EXPECT_FLOAT_EQ(columns[3].min, 0.0f);
+    EXPECT_FLOAT_EQ(columns[3].max, 90.0f);
+
+    // Uneven split: every sample lands in exactly one column
+    std::vector<float> ramp(7);
+    for (int i = 0; i < 7; i++) ramp[i] = (float)i;
+    std::vector<PlotColumn> three(3);
+    DecimateMinMax(ramp, three);
+    EXPECT_FLOAT_EQ(three[0].min, 0.0f);
+    EXPECT_FLOAT_EQ(three[0].max, 2.0f);
+    EXPECT_FLOAT_EQ(three[1].min, 3.0f);
+    EXPECT_FLOAT_EQ(three[1].max, 4.0f);
+    EXPECT_FLOAT_EQ(three[2].min, 5.0f);
+    EXPECT_FLOAT_EQ(three[2].max, 6.0f);
+}
+
+TEST(PlotDecimatorTest, CachesUntilNewData) {
+    std::vector<float> values(600, 50.0f);
+    PlotDecimator decimator;
+
+    auto columns = decimator.Update(values, 1000, 200);
+    EXPECT_FALSE(decimator.WasCached());
+    EXPECT_EQ(columns.size(), 200u);
+
+    decimator.Update(values, 1000, 200);
+    EXPECT_TRUE(decimator.WasCached());
+
+    values.back() = 70.0f;                  // Newest bucket averaged a new sample
+    columns = decimator.Update(values, 1000, 200);
+    EXPECT_FALSE(decimator.WasCached());
+    EXPECT_FLOAT_EQ(columns.back().max, 70.0f);
+
+    decimator.Update(values, 2000, 200);    // New bucket
+    EXPECT_FALSE(decimator.WasCached());
+
+    // More columns than samples: one column per sample
+    EXPECT_EQ(decimator.Update(std::span<const float>(values).first(50), 2000, 200).size(), 50u);
+}
+
+// ============================================================================
+// TelemetryWriter Tests
+// ============================================================================
+
+class TelemetryWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "core_test_telemetry";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::string ReadFile(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    }
+
+    static TelemetryRecord MakeRecord(int64_t unixMs, int temp) {
+        TelemetryRecord record;
+        record.unixMs = unixMs;
+        record.temps[0] = (int16_t)temp;
+        record.maxTemp = (int16_t)temp;
+        record.fanLevel = 3;
+        record.fan1Rpm = 2500;
+        return record;
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST_F(TelemetryWriterTest, WritesCsvAndRotatesBySize) {
+    std::vector<std::string> rotated;
+    TelemetryConfig config;
+    config.path = (dir / "telemetry.csv").string();
+    config.maxFileBytes = 100;
+    config.keepSegments = 2;
+    config.onRotated = [&](const std::string& segment) { rotated.push_back(segment); };
+
+    {
+        TelemetryWriter writer(config);
+        writer.PushLine("legacy line\r\n");
+        writer.Push(MakeRecord(1700000000000, 55));
+        writer.Flush();
+
+        std::string text = ReadFile(config.path);
+        EXPECT_EQ(text.rfind("Time;T0;T1", 0), 0u);
+        EXPECT_NE(text.find("legacy line\r\n"), std::string::npos);
+        EXPECT_NE(text.find(";55;;"), std::string::npos);
+        EXPECT_NE(text.find(";55;3;2500;0\r\n"), std::string::npos);
+
+        // Every flushed batch lands in a file that already reached the size limit
+        for (int i = 0; i < 4; i++) {
+            writer.Push(MakeRecord(1700000001000 + i * 1000, 60 + i));
+            writer.Flush();
+        }
+        auto stats = writer.GetStats();
+        EXPECT_EQ(stats.records, 5u);
+        EXPECT_EQ(stats.lines, 1u);
+        EXPECT_EQ(stats.dropped, 0u);
+        EXPECT_EQ(stats.rotations, 4u);
+        EXPECT_EQ(stats.writeErrors, 0u);
+    }
+
+    EXPECT_EQ(rotated.size(), 4u);
+    size_t files = std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator());
+    EXPECT_EQ(files, 3u);  // Active file + keepSegments
+}
+
+TEST_F(TelemetryWriterTest, BoundedQueueAndBinaryColumns) {
+    TelemetryConfig config;
+    config.path = (dir / "telemetry.bin").string();
+    config.format = TelemetryFormat::Binary;
+    config.queueCapacity = 3;
+    config.flushIntervalMs = 60000;
+
+    TelemetryWriter writer(config);
+    EXPECT_FALSE(writer.PushLine("text\r\n"));
+    for (int i = 0; i < 5; i++) writer.Push(MakeRecord(1700000000000 + i, 40 + i));
+    writer.Flush();
+
+    auto stats = writer.GetStats();
+    EXPECT_EQ(stats.records, 3u);
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.batches, 1u);
+
+    std::string data = ReadFile(config.path);
+    const size_t rows = 3;
+    const size_t rowBytes = 8 + 2 * SensorAddresses::TOTAL_COUNT + 2 + 1 + 2 + 2;
+    ASSERT_EQ(data.size(), sizeof(TelemetryWriter::TelemetryBlockHeader) + rows * rowBytes);
+
+    // Little-endian on disk: the magic reads "TPFT"
+    EXPECT_EQ(data.substr(0, 4), "TPFT");
+    EXPECT_EQ((unsigned char)data[8], rows);
+    
+    TelemetryWriter::TelemetryBlockHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    EXPECT_EQ(header.magic, TelemetryWriter::kBlockMagic);
+    EXPECT_EQ(header.rows, rows);
+
+    // Columns: all timestamps first, then sensor 0 of every row
+    const char* column = data.data() + sizeof(header);
+    int64_t time2;
+    std::memcpy(&time2, column + 2 * sizeof(int64_t), sizeof(time2));
+    EXPECT_EQ(time2, 1700000000002);
+    int16_t temps[3];
+    std::memcpy(temps, column + rows * sizeof(int64_t), sizeof(temps));
+    EXPECT_EQ(temps[0], 40);
+    EXPECT_EQ(temps[2], 42);
+}
+
+// ============================================================================
+// UILogBuffer Tests
+// ============================================================================
+
+TEST(UILogBufferTest, FormatsLazilyFromCopiedArguments) {
+    auto buffer = std::make_unique<Log::UILogBuffer>();
+    {
+        std::string source = "EC";
+        std::string message(400, 'x');     // Longer than a record holds
+        buffer->Add(Log::Level::Error, "[{}] {} ({})", source, message, 42);
+        const char* text = "plain";
+        buffer->Add(Log::Level::Info, "{} {:.1f}", text, 2.25);
+    }   // Arguments gone before formatting
+
+    std::vector<Log::Record> records;
+    buffer->Collect(records);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].level, Log::Level::Error);
+
+    std::string line;
+    Log::UILogBuffer::Format(records[0], line);
+    EXPECT_EQ(line.rfind("[ERROR] [EC] xxxx", 0), 0u);
+    EXPECT_EQ(line.substr(line.size() - 5), " (42)");
+    EXPECT_LT(line.size(), 260u);
+
+    line.clear();
+    Log::UILogBuffer::Format(records[1], line);
+    EXPECT_EQ(line, "plain 2.2");
+}
+
+TEST(UILogBufferTest, RingKeepsNewestAcrossThreads) {
+    auto buffer = std::make_unique<Log::UILogBuffer>();
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&buffer, t] {
+            for (int i = 0; i < 500; i++) buffer->Add(Log::Level::Debug, "{}:{}", t, i);
+        });
+    }
+    std::vector<Log::Record> records;
+    for (int i = 0; i < 50; i++) buffer->Collect(records);  // Concurrent reads skip slots in flight
+    for (auto& w : writers) w.join();
+
+    buffer->Collect(records);
+    // A line whose slot was still held by another writer is dropped, never mixed
+    ASSERT_LE(records.size(), Log::UILogBuffer::Capacity);
+    ASSERT_GE(records.size() + buffer->GetDropped(), Log::UILogBuffer::Capacity);
+    // Each writer's lines stay in order, and the newest line is in the ring
+    std::array<int, 4> last{-1, -1, -1, -1};
+    int finished = 0;
+    std::string line;
+    for (const auto& record : records) {
+        line.clear();
+        Log::UILogBuffer::Format(record, line);
+        int t = line[0] - '0';
+        int i = std::stoi(line.substr(2));
+        EXPECT_GT(i, last[t]);
+        last[t] = i;
+        finished += (i == 499);
+    }
+    EXPECT_GE(finished, 1);
+
+    buffer->Clear();
+    buffer->Collect(records);
+    EXPECT_TRUE(records.empty());
+}
+
+// ============================================================================
+// BinaryLog Tests
+// ============================================================================
+
+class BinaryLogTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() / "core_test_binlog";
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST_F(BinaryLogTest, FormatsOnlyWhatTheSinkWants) {
+    BinaryLog::Options options;
+    options.drainIntervalMs = 60000;
+    BinaryLog log(options);
+
+    std::vector<std::pair<LogLevel, std::string>> lines;
+    log.SetSink([&](LogLevel level, std::chrono::steady_clock::time_point, std::string message) {
+                    lines.emplace_back(level, std::move(message));
+                },
+                [](LogLevel level) { return level != LogLevel::Debug; });
+
+    {
+        std::string source = "EC";
+        log.Write(LogLevel::Warning, "[{}] level 0x{:02X} at {:.1f}°C", source, 0x80, 61.25);
+    }   // Arguments gone before formatting
+    log.Write(LogLevel::Debug, "[PID] Temp={}, Output={:.2f}", 55, 3.5f);
+    log.Write(LogLevel::Info, "no arguments");
+    log.Flush();
+
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0].first, LogLevel::Warning);
+    EXPECT_EQ(lines[0].second, "[EC] level 0x80 at 61.2°C");
+    EXPECT_EQ(lines[1].second, "no arguments");
+
+    auto stats = log.GetStats();
+    EXPECT_EQ(stats.records, 3u);
+    EXPECT_EQ(stats.formatted, 2u);
+    EXPECT_EQ(stats.dropped, 0u);
+}
+
+TEST_F(BinaryLogTest, DropsWhenThreadBufferIsFullAndWraps) {
+    BinaryLog::Options options;
+    options.threadBufferBytes = 1024;
+    options.drainIntervalMs = 60000;
+    BinaryLog log(options);
+
+    std::vector<std::string> lines;
+    log.SetSink([&](LogLevel, std::chrono::steady_clock::time_point, std::string message) {
+        lines.push_back(std::move(message));
+    });
+
+    int accepted = 0;
+    for (int i = 0; i < 100; i++) accepted += log.Write(LogLevel::Info, "{} {}", i, 1.5);
+    EXPECT_GT(accepted, 0);
+    EXPECT_LT(accepted, 100);
+    log.Flush();
+    ASSERT_EQ(lines.size(), (size_t)accepted);
+    EXPECT_EQ(lines[0], "0 1.5");
+    EXPECT_EQ(log.GetStats().dropped, (uint64_t)(100 - accepted));
+
+    // Space is reused after the drain, across the end of the ring
+    lines.clear();
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 7; i++) EXPECT_TRUE(log.Write(LogLevel::Info, "{}/{}", round, i));
+        log.Flush();
+    }
+    ASSERT_EQ(lines.size(), 35u);
+    EXPECT_EQ(lines.back(), "4/6");
+}
+
+TEST_F(BinaryLogTest, ConsumerSleepsUntilARecordArrives) {
+    BinaryLog::Options options;
+    options.drainIntervalMs = 10;
+    BinaryLog log(options);
+    
+    std::mutex mutex;
+    std::condition_variable cv;
+    int delivered = 0;
+    log.SetSink([&](LogLevel, std::chrono::steady_clock::time_point, std::string) {
+        std::lock_guard<std::mutex> lock(mutex);
+        delivered++;
+        cv.notify_all();
+    });
+    
+    // Idle: no drain passes at all
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_EQ(log.GetStats().wakeups, 0u);
+    
+    // A record wakes the consumer without Flush()
+    log.Write(LogLevel::Info, "wake {}", 1);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(2), [&] { return delivered == 1; }));
+    }
+    
+    // Then it goes back to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    EXPECT_LE(log.GetStats().wakeups, 2u);
+}
+
+TEST_F(BinaryLogTest, FileDecodesOfflineInTimeOrder) {
+    const std::string path = (dir / "core.tplog").string();
+    {
+        BinaryLog log;
+        ASSERT_TRUE(log.OpenFile(path));
+        EXPECT_TRUE(log.HasFile());
+        std::thread other([&] { log.Write(LogLevel::Debug, "thread {} {}", 1, "started"); });
+        other.join();
+        for (int i = 0; i < 3; i++) {
+            log.Write(LogLevel::Info, "Cycle {} took {:.3f} ms, {}", i, 0.125 * i, i % 2 == 0);
+        }
+        log.Write(LogLevel::Error, "{1} before {0}, {{braces}} {2:>4}|", "b", 'a', -7);
+        log.Write(LogLevel::Warning, "level {:#04x}", (uint8_t)0x40);
+        log.Flush();
+        EXPECT_GT(log.GetStats().bytesWritten, 0u);
+    }
+
+    std::vector<std::string> lines;
+    std::vector<LogLevel> levels;
+    int64_t lastNs = 0;
+    ASSERT_TRUE(BinaryLog::Decode(path, [&](LogLevel level, int64_t unixNs, std::string_view message) {
+        EXPECT_GE(unixNs, lastNs);
+        lastNs = unixNs;
+        levels.push_back(level);
+        lines.emplace_back(message);
+    }));
+    ASSERT_EQ(lines.size(), 6u);
+    EXPECT_EQ(lines[0], "thread 1 started");
+    EXPECT_EQ(levels[0], LogLevel::Debug);
+    EXPECT_EQ(lines[1], "Cycle 0 took 0.000 ms, true");
+    EXPECT_EQ(lines[3], "Cycle 2 took 0.250 ms, true");
+    EXPECT_EQ(lines[4], "a before b, {braces}   -7|");
+    EXPECT_EQ(lines[5], "level 0x40");
+    EXPECT_EQ(levels[4], LogLevel::Error);
+
+    // Wall clock of the records is close to now
+    const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_LT(std::llabs(nowNs - lastNs), 60'000'000'000ll);
+
+    EXPECT_FALSE(BinaryLog::Decode((dir / "missing.tplog").string(), [](LogLevel, int64_t, std::string_view) {}));
+}
+
 // ============================================================================
 // Main
 // ============================================================================
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include "ECManager.h"
 #include "SensorManager.h"
 #include "FanController.h"
@@ -103,6 +106,62 @@ TEST_F(FanControlTest, DualFanControl) {
     EXPECT_EQ(fanController->GetCurrentFanCtrl(), 7);
 }
 
+TEST_F(FanControlTest, RedundantWritesCoalesced) {
+    EXPECT_TRUE(fanController->SetFanLevel(3));
+    EXPECT_EQ(fanController->GetIssuedCommands(), 1u);
+    
+    // Same level again: no EC traffic
+    EXPECT_TRUE(fanController->SetFanLevel(3));
+    EXPECT_EQ(fanController->GetSuppressedCommands(), 1u);
+    EXPECT_EQ(fanController->GetIssuedCommands(), 1u);
+    
+    // A forced reapply still goes out
+    EXPECT_TRUE(fanController->ReapplyFanLevel(3));
+    EXPECT_EQ(fanController->GetIssuedCommands(), 2u);
+}
+
+TEST_F(FanControlTest, DualFanReadBackDefeatsStaleCoalescing) {
+    fanController->SetDualFanMode(true);
+    EXPECT_TRUE(fanController->SetFanLevel(3));
+    EXPECT_EQ(fanController->GetFanLevel(1), 3);
+    
+    // The BIOS moved the fans behind our back; the per-cycle reads must see fan 2 too
+    mockIO->SetECByte(TP_ECOFFSET_FAN, 0x80);
+    mockIO->SetECByte(TP_ECOFFSET_FANSPEED, 0x10);  // Keep fan 2 counted as spinning
+    int fan1 = 0, fan2 = 0;
+    EXPECT_TRUE(fanController->RefreshCurrentLevel());
+    EXPECT_TRUE(fanController->GetFanSpeeds(fan1, fan2));
+    EXPECT_EQ(fanController->GetFanLevel(0), 0x80);
+    EXPECT_EQ(fanController->GetFanLevel(1), 0x80);
+    
+    EXPECT_TRUE(fanController->SetFanLevel(3));
+    EXPECT_EQ(fanController->GetIssuedCommands(), 2u);
+    EXPECT_EQ(fanController->GetSuppressedCommands(), 0u);
+}
+
+TEST_F(FanControlTest, PreemptReleasesStuckTransaction) {
+    std::atomic<bool> writeOk{true};
+    std::thread worker([&] {
+        // The EC never answers this thread, which waits inside WriteByte holding the mutex
+        mockIO->StallThread(std::this_thread::get_id());
+        writeOk = ecManager->WriteByte(TP_ECOFFSET_FAN, 3);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    
+    auto start = std::chrono::steady_clock::now();
+    auto lock = ecManager->Preempt(1000);
+    ASSERT_TRUE(lock.owns_lock());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+    EXPECT_TRUE(ecManager->WriteByte(TP_ECOFFSET_FAN, (char)0x80));
+    lock.unlock();
+    worker.join();
+    
+    // The worker gave up without blaming the EC type
+    EXPECT_FALSE(writeOk);
+    EXPECT_EQ(mockIO->GetECByte(TP_ECOFFSET_FAN), 0x80);
+    EXPECT_EQ(ecManager->GetCounters().typeSwitches, 0u);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -6,14 +6,17 @@ end})
 
 -- Add dependencies
 add_requires("gtest")
-add_requires("imgui master", {configs = {win32 = true, vulkan = true, freetype = true}})
-add_requires("vulkan-loader")
-add_requires("freetype")
-add_requires("vulkan-memory-allocator")
 add_requires("nlohmann_json")
 
--- Set x86 architecture as default (due to TVicPort driver limitations)
-set_arch("x86")
+if is_plat("windows") then
+    add_requires("imgui master", {configs = {win32 = true, vulkan = true, freetype = true}})
+    add_requires("vulkan-loader")
+    add_requires("freetype")
+    add_requires("vulkan-memory-allocator")
+
+    -- Set x86 architecture as default (due to TVicPort driver limitations)
+    set_arch("x86")
+end
 
 -- Define build modes
 add_rules("mode.debug", "mode.release")
@@ -21,15 +24,18 @@ add_rules("mode.debug", "mode.release")
 -- Global settings
 set_languages("c++20")
 add_requires("spdlog")
-add_defines("WIN32", "_MBCS")
 add_cxflags("/J", "/utf-8", {tools = "msvc"})
+-- The EC code relies on unsigned char like MSVC /J
+add_cxflags("-funsigned-char", {tools = {"gcc", "clang"}})
 
 if is_plat("windows") then
+    add_defines("WIN32", "_MBCS")
     add_cxflags("/W4", {tools = "msvc"}) -- Enable strict warning level 4
 end
 
 -- Target: TPFanCtrl2 (Main GUI App)
 target("TPFanCtrl2")
+    set_enabled(is_plat("windows"))
     set_kind("binary")
     set_plat("windows")
 
@@ -79,11 +85,12 @@ target("TPFanCtrl2")
 -- Target: logic_test (Unit Tests - Legacy)
 target("logic_test")
     set_kind("binary")
-    set_plat("windows")
     add_packages("gtest", "spdlog", "nlohmann_json")
     
     -- Console application
-    add_ldflags("/SUBSYSTEM:CONSOLE", {force = true})
+    if is_plat("windows") then
+        add_ldflags("/SUBSYSTEM:CONSOLE", {force = true})
+    end
     
     -- Source files (only logic components)
     add_files("tests/logic_test.cpp")
@@ -103,11 +110,12 @@ target("logic_test")
 -- Target: core_test (Unit Tests - Core Library)
 target("core_test")
     set_kind("binary")
-    set_plat("windows")
     add_packages("gtest", "spdlog", "nlohmann_json")
     
     -- Console application
-    add_ldflags("/SUBSYSTEM:CONSOLE", {force = true})
+    if is_plat("windows") then
+        add_ldflags("/SUBSYSTEM:CONSOLE", {force = true})
+    end
     
     -- Source files
     add_files("tests/core_test.cpp")
@@ -123,3 +131,27 @@ target("core_test")
     
     -- Output directory
     set_targetdir("bin")
+
+-- Target: fancontrold (Headless Core daemon, Linux)
+target("fancontrold")
+    set_kind("binary")
+    set_enabled(is_plat("linux"))
+    add_packages("spdlog", "nlohmann_json")
+    
+    -- Source files (Core + EC stack, no UI)
+    add_files("fancontrol/daemon/*.cpp")
+    add_files("fancontrol/ECManager.cpp")
+    add_files("fancontrol/SensorManager.cpp")
+    add_files("fancontrol/FanController.cpp")
+    add_files("fancontrol/ConfigManager.cpp")
+    add_files("fancontrol/ThermalConfigBuilder.cpp")
+    add_files("fancontrol/Core/*.cpp")
+    
+    -- Include directories
+    add_includedirs("fancontrol")
+    add_includedirs("fancontrol/Core")
+    
+    add_syslinks("pthread")
+    
+    -- Output directory
+    set_targetdir("bin")